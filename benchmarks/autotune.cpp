@@ -0,0 +1,226 @@
+// Finds the fastest sorter and thresholds for each input size on this host with Google
+// Benchmark, and writes them as a SortProfile for DispatchSorter:
+//
+//   autotune [--profile=<path>] [--max_size=<keys>] [--benchmark_* flags]
+//
+// The profile goes to SortProfile::defaultPath() unless --profile is given. Phase 1 times
+// every backend with its default settings at each size; phase 2 sweeps the thresholds (or
+// the block size) of each size's winner. Each size's entry reaches halfway, geometrically,
+// to the next size, and neighbouring sizes with the same winner share an entry.
+#include "benchmark/benchmark.h"
+#include "dispatch_sorter.h"
+#include "sort_profile.h"
+#include "std_thread_bitonic_sorter.h"
+#include "openmp_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include "blocked_bitonic_sorter.h"
+#include "hybrid_bitonic_sorter.h"
+#include <cmath>     // For std::sqrt
+#include <cstdlib>   // For std::strtoull
+#include <cstring>   // For std::strncmp
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>    // For std::mt19937
+#include <string>
+#include <thread>    // For std::thread::hardware_concurrency
+#include <vector>
+
+namespace {
+
+struct Candidate {
+    std::size_t size;
+    SortProfileEntry entry;
+    double seconds = std::numeric_limits<double>::infinity(); // Per sort, best of the runs
+};
+
+// Console output as usual, plus each candidate's time per iteration
+class CollectingReporter : public benchmark::ConsoleReporter {
+public:
+    explicit CollectingReporter(std::vector<Candidate>& candidates) : candidates_(candidates) {}
+
+    void add(const std::string& name, std::size_t index) { by_name_[name] = index; }
+
+    void ReportRuns(const std::vector<Run>& runs) override {
+        for (const Run& run : runs) {
+            auto found = by_name_.find(run.run_name.function_name);
+            if (found != by_name_.end() && run.run_type == Run::RT_Iteration && run.iterations > 0) {
+                Candidate& candidate = candidates_[found->second];
+                candidate.seconds = std::min(candidate.seconds, run.real_accumulated_time / run.iterations);
+            }
+        }
+        ConsoleReporter::ReportRuns(runs);
+    }
+
+private:
+    std::vector<Candidate>& candidates_;
+    std::map<std::string, std::size_t> by_name_;
+};
+
+std::string describe(const Candidate& candidate) {
+    const SortProfileEntry& e = candidate.entry;
+    return std::string(sortBackendName(e.backend)) + "/" + std::to_string(candidate.size) + "/seq:" +
+           std::to_string(e.thresholds.sequential) + "/grain:" + std::to_string(e.thresholds.compare_grain) +
+           "/block:" + std::to_string(e.block_bytes);
+}
+
+// Times every candidate; a copy of the same random keys is sorted per iteration, so the copy
+// adds the same time to every candidate of a size
+void runCandidates(std::vector<Candidate>& candidates) {
+    benchmark::ClearRegisteredBenchmarks();
+    CollectingReporter reporter(candidates);
+    std::map<std::size_t, std::vector<int>> inputs;
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        const std::size_t size = candidates[i].size;
+        if (!inputs.count(size)) {
+            std::mt19937 gen(42);
+            std::uniform_int_distribution<int> distrib(0, static_cast<int>(std::min<std::size_t>(size * 10, 1 << 30)));
+            std::vector<int>& data = inputs[size];
+            data.resize(size);
+            for (int& x : data) x = distrib(gen);
+        }
+        const std::vector<int>* input = &inputs[size];
+        const std::string name = "autotune/" + describe(candidates[i]);
+        reporter.add(name, i);
+        std::shared_ptr<BitonicSort> sorter = makeProfiledSorter<int>(candidates[i].entry);
+        benchmark::RegisterBenchmark(name.c_str(), [sorter, input](benchmark::State& state) {
+            std::vector<int> data;
+            for (auto _ : state) {
+                data = *input;
+                sorter->sort(data, SortOrder::Ascending);
+                benchmark::ClobberMemory();
+            }
+        })->UseRealTime()->Unit(benchmark::kMillisecond);
+    }
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+}
+
+// Phase 2 settings for a backend; the first is always the defaults
+std::vector<SortProfileEntry> sweep(SortBackend backend, std::size_t size) {
+    SortProfileEntry defaults;
+    defaults.backend = backend;
+    std::vector<SortProfileEntry> entries = {defaults};
+    std::vector<int> sequential;
+    std::vector<int> grains;
+    if (backend == SortBackend::StdThread || backend == SortBackend::OpenMP) {
+        sequential = {256, 1024, 4096, 16384};
+        grains = {1024, 4096, 16384};
+    } else if (backend == SortBackend::SIMD) {
+        sequential = {1 << 12, 1 << 14, 1 << 16, 1 << 18};
+        grains = {1 << 11, 1 << 13, 1 << 15};
+    } else if (backend == SortBackend::Blocked || backend == SortBackend::Hybrid) {
+        for (std::size_t kib : {64, 128, 512, 1024, 4096}) {
+            SortProfileEntry entry = defaults;
+            entry.block_bytes = kib * 1024;
+            entries.push_back(entry);
+        }
+    }
+    for (int s : sequential) {
+        if (static_cast<std::size_t>(s) >= size) {
+            continue; // Every larger threshold runs the whole sort on one thread
+        }
+        for (int g : grains) {
+            SortProfileEntry entry = defaults;
+            entry.thresholds = {s, g};
+            entries.push_back(entry);
+        }
+    }
+    return entries;
+}
+
+bool sameSettings(const SortProfileEntry& a, const SortProfileEntry& b) {
+    return a.backend == b.backend && a.thresholds.sequential == b.thresholds.sequential &&
+           a.thresholds.compare_grain == b.thresholds.compare_grain && a.block_bytes == b.block_bytes;
+}
+
+const Candidate& fastest(const std::vector<Candidate>& candidates, std::size_t size) {
+    const Candidate* best = nullptr;
+    for (const Candidate& candidate : candidates) {
+        if (candidate.size == size && (!best || candidate.seconds < best->seconds)) {
+            best = &candidate;
+        }
+    }
+    return *best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string profile_path = SortProfile::defaultPath();
+    std::size_t max_size = std::size_t(1) << 22;
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--profile=", 10) == 0) {
+            profile_path = argv[i] + 10;
+        } else if (std::strncmp(argv[i], "--max_size=", 11) == 0) {
+            max_size = std::strtoull(argv[i] + 11, nullptr, 10);
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    int benchmark_argc = static_cast<int>(args.size());
+    benchmark::Initialize(&benchmark_argc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(benchmark_argc, args.data())) {
+        return 1;
+    }
+
+    std::vector<std::size_t> sizes;
+    for (std::size_t size = 1 << 10; size <= max_size; size *= 8) {
+        sizes.push_back(size);
+    }
+    if (sizes.empty()) {
+        std::cerr << "autotune: --max_size must be at least 1024\n";
+        return 1;
+    }
+
+    // Phase 1: every backend with its defaults. The scalar network is only a contender
+    // while it fits in cache.
+    std::vector<Candidate> backends;
+    for (std::size_t size : sizes) {
+        for (SortBackend backend : {SortBackend::Plain, SortBackend::StdThread, SortBackend::OpenMP,
+                                    SortBackend::SIMD, SortBackend::Blocked, SortBackend::Hybrid}) {
+            if (backend == SortBackend::Plain && size > (1 << 16)) {
+                continue;
+            }
+            SortProfileEntry entry;
+            entry.backend = backend;
+            backends.push_back({size, entry});
+        }
+    }
+    runCandidates(backends);
+
+    // Phase 2: the winner's settings
+    std::vector<Candidate> settings;
+    for (std::size_t size : sizes) {
+        for (const SortProfileEntry& entry : sweep(fastest(backends, size).entry.backend, size)) {
+            settings.push_back({size, entry});
+        }
+    }
+    runCandidates(settings);
+
+    SortProfile profile;
+    profile.isa = detectBestSIMDIsa();
+    profile.threads = std::thread::hardware_concurrency();
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        SortProfileEntry entry = fastest(settings, sizes[i]).entry;
+        entry.max_count = (i + 1 < sizes.size())
+                              ? static_cast<std::size_t>(std::sqrt(double(sizes[i]) * double(sizes[i + 1])))
+                              : std::numeric_limits<std::size_t>::max();
+        if (!profile.entries.empty() && sameSettings(profile.entries.back(), entry)) {
+            profile.entries.back().max_count = entry.max_count;
+        } else {
+            profile.entries.push_back(entry);
+        }
+    }
+    profile.save(profile_path);
+
+    std::cout << "\nProfile written to " << profile_path << ":\n";
+    for (const SortProfileEntry& entry : profile.entries) {
+        std::cout << "  up to " << (entry.max_count == std::numeric_limits<std::size_t>::max()
+                                        ? std::string("any size")
+                                        : std::to_string(entry.max_count) + " keys")
+                  << ": " << makeProfiledSorter<int>(entry, profile.isa)->getName() << "\n";
+    }
+    benchmark::Shutdown();
+    return 0;
+}
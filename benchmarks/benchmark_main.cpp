@@ -3,16 +3,45 @@
 #include "std_thread_bitonic_sorter.h"
 #include "openmp_bitonic_sorter.h"
 #include "simd_bitonic_sorter.h"
+#include "blocked_bitonic_sorter.h"
+#include "external_sorter.h"
+#include "hybrid_bitonic_sorter.h"
+#include "adaptive_sorter.h"
+#include "simd_kernels.h"
+#include "static_bitonic_sorter.h"
+#include "async_sorter.h"
 #include <vector>
-#include <algorithm> // For std::generate, std::iota
+#include <algorithm> // For std::generate, std::iota, std::merge, std::sort, std::stable_sort
+#include <functional>
+#include <memory>    // For std::unique_ptr
 #include <random>    // For std::mt19937
+#include <cmath>     // For std::log, std::exp
+#include <cstdint>   // For std::uintptr_t
+#include <cstdio>    // For std::fopen, std::fwrite
+#include <filesystem>
+#include <string>
 #include <thread>    // For std::thread::hardware_concurrency
+#ifdef BITONIC_BENCH_PARALLEL_STL
+#include <execution> // For std::execution::par
+#endif
 
-// Helper to generate data
+// Sorted keys with swapped_per_mille / 1000 of them swapped with a random partner
+static std::vector<int> generate_nearly_sorted(size_t size, int swapped_per_mille) {
+    std::vector<int> data(size);
+    std::iota(data.begin(), data.end(), 0);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> position(0, size - 1);
+    for (size_t i = 0; i < size * swapped_per_mille / 2000; ++i) {
+        std::swap(data[position(gen)], data[position(gen)]);
+    }
+    return data;
+}
+
+// Helper to generate data; type is one of DISTRIBUTIONS
 static std::vector<int> generate_data(size_t size, const std::string& type = "random") {
     std::vector<int> data(size);
+    std::mt19937 gen(42); // Fixed seed for reproducibility in data generation
     if (type == "random") {
-        std::mt19937 gen(42); // Fixed seed for reproducibility in data generation
         std::uniform_int_distribution<> distrib(0, size * 10);
         std::generate(data.begin(), data.end(), [&]() { return distrib(gen); });
     } else if (type == "sorted") {
@@ -20,20 +49,85 @@ static std::vector<int> generate_data(size_t size, const std::string& type = "ra
     } else if (type == "reversed") {
         std::iota(data.begin(), data.end(), 0);
         std::reverse(data.begin(), data.end());
+    } else if (type == "few_unique") {
+        std::uniform_int_distribution<> distrib(0, 15);
+        std::generate(data.begin(), data.end(), [&]() { return distrib(gen) * 1000; });
+    } else if (type == "all_equal") {
+        std::fill(data.begin(), data.end(), 42);
+    } else if (type == "zipf") {
+        // Ranks 1..size with frequency proportional to 1 / rank (s = 1), by inverting the
+        // continuous CDF; scattered over the key range so frequent keys are not all small
+        std::uniform_real_distribution<double> u(0.0, 1.0);
+        const double log_size = std::log(size + 1.0);
+        std::generate(data.begin(), data.end(), [&]() {
+            const auto rank = static_cast<std::uint32_t>(std::exp(u(gen) * log_size));
+            return static_cast<int>((rank * 2654435761u) >> 1);
+        });
+    } else if (type == "sawtooth") {
+        // 16 ascending runs
+        const size_t period = std::max<size_t>(1, size / 16);
+        for (size_t i = 0; i < size; ++i) data[i] = static_cast<int>(i % period);
+    } else if (type == "organ_pipe") {
+        // Ascending to the middle, then descending
+        for (size_t i = 0; i < size; ++i) data[i] = static_cast<int>(std::min(i, size - 1 - i));
+    } else if (type == "nearly_sorted") {
+        data = generate_nearly_sorted(size, 10);
     }
-    // Add other types if needed: nearly_sorted, few_unique etc.
     return data;
 }
 
+static const char* const DISTRIBUTIONS[] = {"random", "few_unique", "all_equal", "zipf", "sawtooth",
+                                            "organ_pipe", "nearly_sorted", "sorted", "reversed"};
+
+// Fresh copies of one input for the timing loop, so the copy is not timed. The copies are
+// refilled together between timed iterations: one PauseTiming per refill rather than per
+// iteration, whose overhead would swamp small sorts. The pool stays within POOL_BYTES
+// (about an L2) unless a single copy is larger.
+template <typename T>
+class InputPool {
+public:
+    static constexpr std::size_t POOL_BYTES = 1 << 19;
+    static std::size_t copiesFor(std::size_t bytes) { return std::max<std::size_t>(1, POOL_BYTES / std::max<std::size_t>(1, bytes)); }
+
+    InputPool(const std::vector<T>& data, std::size_t copies) : data_(data), copies_(copies, data) {}
+    explicit InputPool(const std::vector<T>& data) : InputPool(data, copiesFor(data.size() * sizeof(T))) {}
+
+    std::vector<T>& next(benchmark::State& state) {
+        if (next_ == copies_.size()) {
+            state.PauseTiming();
+            for (std::vector<T>& copy : copies_) {
+                std::copy(data_.begin(), data_.end(), copy.begin());
+            }
+            state.ResumeTiming();
+            next_ = 0;
+        }
+        return copies_[next_++];
+    }
+
+private:
+    const std::vector<T>& data_;
+    std::vector<std::vector<T>> copies_;
+    std::size_t next_ = 0;
+};
+
+// Sorts a fresh copy of data per iteration with sort(std::vector<T>&), and reports keys and
+// key bytes per second
+template <typename T, typename Sort>
+static void runSortLoop(benchmark::State& state, const std::vector<T>& data, Sort sort) {
+    InputPool<T> pool(data);
+    for (auto _ : state) {
+        sort(pool.next(state));
+        benchmark::ClobberMemory(); // Prevent compiler from optimizing away the sort
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size() * sizeof(T)));
+}
+
 // --- Plain Sorter Benchmark ---
 static void BM_PlainBitonicSort(benchmark::State& state) {
     PlainBitonicSorter sorter;
     std::vector<int> data = generate_data(state.range(0));
-    for (auto _ : state) {
-        std::vector<int> current_data = data; // Copy data for each iteration
-        sorter.sort(current_data, SortOrder::Ascending);
-        benchmark::ClobberMemory(); // Prevent compiler from optimizing away the sort
-    }
+    runSortLoop(state, data, [&](std::vector<int>& keys) { sorter.sort(keys, SortOrder::Ascending); });
     state.SetComplexityN(state.range(0));
 }
 BENCHMARK(BM_PlainBitonicSort)->RangeMultiplier(2)->Range(1<<6, 1<<16)->Complexity(benchmark::oNLogN); // 64 to 65536
@@ -48,11 +142,7 @@ static void BM_StdThreadBitonicSort(benchmark::State& state) {
     StdThreadBitonicSorter sorter(num_threads);
     std::vector<int> data = generate_data(state.range(0));
 
-    for (auto _ : state) {
-        std::vector<int> current_data = data;
-        sorter.sort(current_data, SortOrder::Ascending);
-        benchmark::ClobberMemory();
-    }
+    runSortLoop(state, data, [&](std::vector<int>& keys) { sorter.sort(keys, SortOrder::Ascending); });
     state.SetComplexityN(state.range(0));
     state.counters["threads"] = num_threads;
 }
@@ -65,40 +155,599 @@ BENCHMARK(BM_StdThreadBitonicSort)
     ->Complexity(benchmark::oNLogN);
 
 
+// Sorters built on the process-wide pool: no threads are created per sorter or per sort
+static void BM_StdThreadBitonicSortSharedPool(benchmark::State& state) {
+    StdThreadBitonicSorter sorter(WorkStealingThreadPool::shared());
+    std::vector<int> data = generate_data(state.range(0));
+    runSortLoop(state, data, [&](std::vector<int>& keys) { sorter.sort(keys, SortOrder::Ascending); });
+    state.SetLabel(sorter.getName());
+}
+BENCHMARK(BM_StdThreadBitonicSortSharedPool)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+
 // --- OpenMP Sorter Benchmark ---
+// Same size x thread-count grid as BM_StdThreadBitonicSort, so the two backends line up
 static void BM_OpenMPBitonicSort(benchmark::State& state) {
-    // OpenMP typically uses OMP_NUM_THREADS environment variable.
-    // We can pass a thread count to the constructor if designed that way, or rely on env.
-    // Assuming OpenMPBitonicSorter uses omp_set_num_threads or respects OMP_NUM_THREADS
-    // For this benchmark, we'll just note that OpenMP controls threads externally or via its constructor if available.
-    // The OpenMPBitonicSorter might need modification to accept thread counts, or we test default behavior.
-    // For now, assuming default behavior. If it has a constructor for threads:
-    // OpenMPBitonicSorter sorter(state.range(1)); // if it takes thread count
-    OpenMPBitonicSorter sorter; // Assuming it uses max threads or OMP_NUM_THREADS
+    OpenMPBitonicSorter sorter(state.range(1)); // 0 means omp_get_max_threads()
     std::vector<int> data = generate_data(state.range(0));
 
-    for (auto _ : state) {
-        std::vector<int> current_data = data;
-        sorter.sort(current_data, SortOrder::Ascending);
-        benchmark::ClobberMemory();
-    }
+    runSortLoop(state, data, [&](std::vector<int>& keys) { sorter.sort(keys, SortOrder::Ascending); });
     state.SetComplexityN(state.range(0));
-    // state.counters["threads"] = omp_get_max_threads(); // If inside parallel region or after setting
+    state.counters["threads"] = sorter.getNumThreads();
+    state.SetLabel(sorter.getName());
 }
-BENCHMARK(BM_OpenMPBitonicSort)->RangeMultiplier(2)->Range(1<<6, 1<<16)->Complexity(benchmark::oNLogN);
+BENCHMARK(BM_OpenMPBitonicSort)
+    ->ArgsProduct({
+        benchmark::CreateRange(1<<6, 1<<16, 2), // Data sizes
+        benchmark::CreateDenseRange(0, std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 4, std::thread::hardware_concurrency() > 2 ? 2 : 1) // Thread counts (0, 2, 4, ...)
+    })
+    ->Complexity(benchmark::oNLogN);
+
+// Placement and task granularity at a fixed size: range(1) is the thread count, range(2)
+// the OpenMPProcBind value, range(3) the task cutoff depth (-1 = automatic)
+static void BM_OpenMPBitonicSortProcBind(benchmark::State& state) {
+    OpenMPBitonicSorter sorter(state.range(1), static_cast<OpenMPProcBind>(state.range(2)), state.range(3));
+    std::vector<int> data = generate_data(state.range(0));
+    runSortLoop(state, data, [&](std::vector<int>& keys) { sorter.sort(keys, SortOrder::Ascending); });
+    state.counters["threads"] = sorter.getNumThreads();
+    state.SetLabel(sorter.getName());
+}
+BENCHMARK(BM_OpenMPBitonicSortProcBind)
+    ->ArgsProduct({
+        {1<<18},
+        {0, 2, 4},
+        {static_cast<int64_t>(OpenMPProcBind::Close), static_cast<int64_t>(OpenMPProcBind::Spread)},
+        {OpenMPBitonicSorter::AUTO_TASK_CUTOFF_DEPTH, 2, 8}
+    })
+    ->UseRealTime() // Worker threads do not show up in the calling thread's CPU time
+    ->Unit(benchmark::kMillisecond);
+
+// --- Thread scaling: cores, vectors and both ---
+// range(1) picks the backend, range(2) the thread count:
+//   0 StdThreadBitonicSorter    cores only, scalar network
+//   1 OpenMPBitonicSorter       cores only, scalar network
+//   2 SIMDBitonicSorter         vectors only, one thread (registered at 1 thread)
+//   3 SIMDBitonicSorter         both, on a pool of threads - 1 workers plus the caller
+//   4 OpenMPSIMDBitonicSorter   both, OpenMP tasks over SIMD leaves
+// Compare items_per_second along the thread counts of one backend for its scaling, and
+// across backends at one count for what each axis is worth.
+static void BM_ThreadScaling(benchmark::State& state) {
+    const int threads = static_cast<int>(state.range(2));
+    std::unique_ptr<BitonicSort> sorter;
+    switch (state.range(1)) {
+        case 0: sorter.reset(new StdThreadBitonicSorter(threads)); break;
+        case 1: sorter.reset(new OpenMPBitonicSorter(threads)); break;
+        case 2: sorter.reset(new SIMDBitonicSorter()); break;
+        case 3: sorter.reset(new SIMDBitonicSorter(SIMDIsa::Auto, std::make_shared<WorkStealingThreadPool>(threads - 1))); break;
+        default: sorter.reset(new OpenMPSIMDBitonicSorter(SIMDIsa::Auto, threads)); break;
+    }
+    std::vector<int> data = generate_data(state.range(0));
+    runSortLoop(state, data, [&](std::vector<int>& keys) { sorter->sort(keys, SortOrder::Ascending); });
+    state.counters["threads"] = threads;
+    state.SetLabel(sorter->getName());
+}
+BENCHMARK(BM_ThreadScaling)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+        // Powers of two up to the machine's hardware threads, and that count itself
+        const int hardware = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<int> counts;
+        for (int t = 1; t < hardware; t *= 2) counts.push_back(t);
+        counts.push_back(hardware);
+        for (int64_t size : {1 << 20, 1 << 24}) {
+            b->Args({size, 2, 1});
+            for (int64_t backend : {0, 1, 3, 4}) {
+                for (int t : counts) b->Args({size, backend, t});
+            }
+        }
+    })
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
 
 // --- SIMD Sorter Benchmark ---
 static void BM_SIMDBitonicSort(benchmark::State& state) {
+    SIMDBitonicSorter sorter; // Widest ISA the CPU supports
+    std::vector<int> data = generate_data(state.range(0));
+    runSortLoop(state, data, [&](std::vector<int>& keys) { sorter.sort(keys, SortOrder::Ascending); });
+    state.SetComplexityN(state.range(0));
+    state.SetLabel(sorter.getName());
+}
+BENCHMARK(BM_SIMDBitonicSort)->RangeMultiplier(2)->Range(1<<6, 1<<16)->Complexity(benchmark::oNLogN);
+
+// --- SIMD Sorter per-ISA Benchmark ---
+// range(1) is the SIMDIsa value; ISAs the CPU lacks are skipped rather than silently downgraded.
+static void BM_SIMDBitonicSortIsa(benchmark::State& state) {
+    SIMDIsa isa = static_cast<SIMDIsa>(state.range(1));
+    if (!cpuSupports(isa)) {
+        state.SkipWithError("ISA not supported on this CPU");
+        return;
+    }
+    SIMDBitonicSorter sorter(isa);
+    std::vector<int> data = generate_data(state.range(0));
+    runSortLoop(state, data, [&](std::vector<int>& keys) { sorter.sort(keys, SortOrder::Ascending); });
+    state.SetLabel(sorter.getName());
+}
+BENCHMARK(BM_SIMDBitonicSortIsa)
+    ->ArgsProduct({
+        benchmark::CreateRange(1<<10, 1<<16, 4),
+        {static_cast<int64_t>(SIMDIsa::SSE41), static_cast<int64_t>(SIMDIsa::AVX2), static_cast<int64_t>(SIMDIsa::AVX512)}
+    });
+
+// --- SIMD Sorter per key type Benchmark ---
+// 16-bit keys fit twice the lanes of int32, 64-bit keys half.
+template <typename T>
+static void BM_SIMDBitonicSortKeyType(benchmark::State& state) {
+    BasicSIMDBitonicSorter<T> sorter;
+    std::vector<int> ints = generate_data(state.range(0));
+    std::vector<T> data(ints.begin(), ints.end());
+    runSortLoop(state, data, [&](std::vector<T>& keys) { sorter.sort(keys, SortOrder::Ascending); });
+    state.SetLabel(sorter.getName());
+}
+BENCHMARK_TEMPLATE(BM_SIMDBitonicSortKeyType, std::int16_t)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_SIMDBitonicSortKeyType, std::uint32_t)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_SIMDBitonicSortKeyType, std::int64_t)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_SIMDBitonicSortKeyType, float)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_SIMDBitonicSortKeyType, double)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+
+// Key/value sort with the payload as the original row index, to compare against keys-only
+template <typename T>
+static void BM_SIMDBitonicSortPairs(benchmark::State& state) {
+    using Payload = typename BasicSIMDBitonicSorter<T>::payload_type;
+    BasicSIMDBitonicSorter<T> sorter;
+    std::vector<int> ints = generate_data(state.range(0));
+    std::vector<T> keys(ints.begin(), ints.end());
+    std::vector<Payload> values(keys.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<Payload>(i);
+    }
+    const std::size_t copies = InputPool<T>::copiesFor(keys.size() * (sizeof(T) + sizeof(Payload)));
+    InputPool<T> key_pool(keys, copies);
+    InputPool<Payload> value_pool(values, copies); // Refilled on the same iterations as key_pool
+    for (auto _ : state) {
+        std::vector<T>& current_keys = key_pool.next(state);
+        sorter.sortPairs(current_keys, value_pool.next(state), SortOrder::Ascending);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * (sizeof(T) + sizeof(Payload)));
+    state.SetLabel(sorter.getName());
+}
+BENCHMARK_TEMPLATE(BM_SIMDBitonicSortPairs, std::int16_t)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_SIMDBitonicSortPairs, std::int32_t)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_SIMDBitonicSortPairs, float)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+BENCHMARK_TEMPLATE(BM_SIMDBitonicSortPairs, double)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+
+static void BM_SIMDArgsort(benchmark::State& state) {
     SIMDBitonicSorter sorter;
     std::vector<int> data = generate_data(state.range(0));
     for (auto _ : state) {
-        std::vector<int> current_data = data;
-        sorter.sort(current_data, SortOrder::Ascending);
+        std::vector<std::size_t> perm = sorter.argsort(data, SortOrder::Ascending);
+        benchmark::DoNotOptimize(perm.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(sorter.getName());
+}
+BENCHMARK(BM_SIMDArgsort)->RangeMultiplier(4)->Range(1<<10, 1<<16);
+
+// Adds sorter's SortStats as per-sort user counters; nothing without BITONIC_SORT_STATS.
+// The sorter's stats must have been reset before the timing loop.
+static void reportSortStats(benchmark::State& state, const BitonicSort& sorter) {
+    if (!SORT_STATS_ENABLED) {
+        return;
+    }
+    const SortStats stats = sorter.getStats();
+    auto per_sort = [](double value) { return benchmark::Counter(value, benchmark::Counter::kAvgIterations); };
+    for (SortPhase phase : {SortPhase::Sort, SortPhase::Merge, SortPhase::Copy, SortPhase::Wait}) {
+        state.counters[std::string(sortPhaseName(phase)) + "_ms"] = per_sort(stats.phaseSeconds(phase) * 1e3);
+    }
+    state.counters["compare_exchanges"] = per_sort(static_cast<double>(stats.compareExchanges()));
+    state.counters["swaps"] = per_sort(static_cast<double>(stats.swaps));
+    state.counters["simd_fraction"] = stats.simdFraction();
+    state.counters["utilization"] = stats.utilization();
+    state.counters["idle_ms"] = per_sort(stats.idleSeconds() * 1e3);
+}
+
+// --- Fixed small sizes ---
+// range(1): 0 std::sort, 1 StaticBitonicSorter, 2 PlainBitonicSorter (which dispatches to the
+// static network at these sizes, so n - 1 shows its recursive path), 3 SIMDBitonicSorter
+static void BM_SmallFixedSort(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    PlainBitonicSorter plain;
+    SIMDBitonicSorter simd;
+    std::vector<int> data = generate_data(size);
+    switch (state.range(1)) {
+        case 0:
+            runSortLoop(state, data, [](std::vector<int>& keys) { std::sort(keys.begin(), keys.end()); });
+            break;
+        case 1:
+            if (!sortWithStaticNetwork(data.data(), size, SortOrder::Ascending)) {
+                state.SkipWithError("No static network for this size");
+                return;
+            }
+            data = generate_data(size);
+            runSortLoop(state, data, [](std::vector<int>& keys) {
+                sortWithStaticNetwork(keys.data(), keys.size(), SortOrder::Ascending);
+            });
+            break;
+        case 2:
+            runSortLoop(state, data, [&](std::vector<int>& keys) { plain.sort(keys, SortOrder::Ascending); });
+            break;
+        default:
+            runSortLoop(state, data, [&](std::vector<int>& keys) { simd.sort(keys, SortOrder::Ascending); });
+            state.SetLabel(simd.getName());
+            break;
+    }
+}
+BENCHMARK(BM_SmallFixedSort)
+    ->ArgsProduct({{7, 8, 16, 32, 63, 64, 128, 255, 256}, {0, 1, 2, 3}}); // size, sorter
+
+// --- Asynchronous sorts ---
+// range(1): 0 SIMDBitonicSorter on the shared pool, synchronously; 1 AsyncSorter, waiting on
+// each job; 2 AsyncSorter with PIPELINED_JOBS jobs queued at once on separate arrays, so the
+// time per item includes the staging overhead but not the caller's idle time
+static void BM_AsyncSort(benchmark::State& state) {
+    const int PIPELINED_JOBS = 4;
+    const std::size_t size = state.range(0);
+    const std::vector<int> data = generate_data(size);
+    SIMDBitonicSorter simd(SIMDIsa::Auto, WorkStealingThreadPool::shared());
+    AsyncSorter async_sorter;
+    const int jobs = state.range(1) == 2 ? PIPELINED_JOBS : 1;
+    std::vector<std::vector<int>> keys(jobs, data);
+    std::vector<AsyncSortJob> pending(jobs);
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (std::vector<int>& k : keys) {
+            std::copy(data.begin(), data.end(), k.begin());
+        }
+        state.ResumeTiming();
+        if (state.range(1) == 0) {
+            simd.sort(keys[0], SortOrder::Ascending);
+        } else {
+            for (int j = 0; j < jobs; ++j) {
+                pending[j] = async_sorter.sortAsync(keys[j], SortOrder::Ascending);
+            }
+            for (const AsyncSortJob& job : pending) {
+                job.get();
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size) * jobs);
+    state.SetLabel(state.range(1) == 0 ? simd.getName() : async_sorter.getName());
+}
+BENCHMARK(BM_AsyncSort)
+    ->ArgsProduct({{1 << 20, 1 << 24}, {0, 1, 2}}) // size, mode
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// --- Out-of-cache sizes: recursive SIMD sorter vs the cache-blocked loop nest ---
+// streaming_passes counts the blocked sorter's full-array passes.
+static void BM_LargeSort(benchmark::State& state, BitonicSort& sorter) {
+    std::vector<int> data = generate_data(state.range(0));
+    sorter.resetStats();
+    runSortLoop(state, data, [&](std::vector<int>& keys) { sorter.sort(keys, SortOrder::Ascending); });
+    state.SetLabel(sorter.getName());
+    reportSortStats(state, sorter);
+}
+
+static void BM_SIMDBitonicSortLarge(benchmark::State& state) {
+    SIMDBitonicSorter sorter;
+    BM_LargeSort(state, sorter);
+}
+BENCHMARK(BM_SIMDBitonicSortLarge)->RangeMultiplier(4)->Range(1<<20, 1<<26)->Unit(benchmark::kMillisecond);
+
+// Sizes just past a power of two: the network runs on exactly n elements, so 2^20 + 1
+// should cost about as much as 2^20, not 2^21
+static void BM_SIMDBitonicSortNonPowerOfTwo(benchmark::State& state) {
+    SIMDBitonicSorter sorter;
+    BM_LargeSort(state, sorter);
+}
+BENCHMARK(BM_SIMDBitonicSortNonPowerOfTwo)
+    ->Arg((1<<20) - 1)->Arg(1<<20)->Arg((1<<20) + 1)->Arg(3 * (1<<19))->Arg((1<<21) - 1)->Arg(1<<21)
+    ->Unit(benchmark::kMillisecond);
+
+// --- Buffer alignment ---
+// Sorts keys starting range(1) ints past a 64-byte boundary. The kernels peel a head to reach
+// a vector boundary, so misaligned inputs should cost about what aligned ones do.
+static void BM_SIMDBitonicSortAlignment(benchmark::State& state) {
+    SIMDBitonicSorter sorter;
+    const std::size_t size = state.range(0);
+    const std::vector<int> data = generate_data(size);
+    std::vector<int> backing(size + 2 * 64 / sizeof(int));
+    int* base = backing.data();
+    while (reinterpret_cast<std::uintptr_t>(base) % 64 != 0) ++base;
+    int* keys = base + state.range(1);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::copy(data.begin(), data.end(), keys);
+        state.ResumeTiming();
+        sorter.sort(keys, size, SortOrder::Ascending);
         benchmark::ClobberMemory();
     }
-    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size));
+    state.SetLabel(sorter.getName());
 }
-BENCHMARK(BM_SIMDBitonicSort)->RangeMultiplier(2)->Range(1<<6, 1<<16)->Complexity(benchmark::oNLogN);
+BENCHMARK(BM_SIMDBitonicSortAlignment)
+    ->ArgsProduct({{1<<16, 1<<20, 1<<24}, {0, 1, 4, 15}}) // size, offset in ints
+    ->Unit(benchmark::kMillisecond);
 
+// One merge pass, n compare-exchanges between two halves of a 2n buffer that starts range(1)
+// ints past a 64-byte boundary; range(2) selects the streaming-store kernel. Non-temporal
+// stores only pay once the buffer is well past the last-level cache.
+static void BM_CompareAndSwapPass(benchmark::State& state) {
+    const SIMDKernels<int>& kernels = selectSIMDKernels<int>();
+    const int count = static_cast<int>(state.range(0));
+    std::vector<int> backing(2 * static_cast<std::size_t>(count) + 2 * 64 / sizeof(int));
+    int* base = backing.data();
+    while (reinterpret_cast<std::uintptr_t>(base) % 64 != 0) ++base;
+    int* lo = base + state.range(1);
+    std::mt19937 gen(42);
+    std::generate(lo, lo + 2 * static_cast<std::size_t>(count), [&]() { return static_cast<int>(gen()); });
+    const auto pass = state.range(2) ? kernels.compareAndSwapBlocksStreaming : kernels.compareAndSwapBlocks;
+    SortOrder order = SortOrder::Ascending;
+    for (auto _ : state) {
+        pass(lo, lo + count, count, order); // Alternating orders keep every pass swapping
+        order = order == SortOrder::Ascending ? SortOrder::Descending : SortOrder::Ascending;
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * 2 * static_cast<int64_t>(count) * sizeof(int));
+    state.SetLabel(simdIsaName(kernels.isa));
+    state.counters["streaming_threshold_mib"] = static_cast<double>(streamingStoreThresholdBytes() >> 20);
+}
+BENCHMARK(BM_CompareAndSwapPass)
+    ->ArgsProduct({{1<<16, 1<<22, 1<<26}, {0, 1}, {0, 1}}) // n, offset in ints, streaming
+    ->Unit(benchmark::kMillisecond);
+
+// --- Segmented Sort Benchmark ---
+// range(0) segments with log-uniform lengths in [16, 512]. range(1) selects the method:
+// 0 = one sort() call per segment, 1 = sortSegments, 2 = sortSegments on the shared pool.
+static void BM_SortSegments(benchmark::State& state) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> log_length(std::log(16.0), std::log(513.0));
+    std::vector<std::size_t> offsets = {0};
+    for (int64_t s = 0; s < state.range(0); ++s) {
+        offsets.push_back(offsets.back() + static_cast<std::size_t>(std::exp(log_length(gen))));
+    }
+    std::vector<int> data = generate_data(offsets.back());
+
+    SIMDBitonicSorter sorter = state.range(1) == 2 ? SIMDBitonicSorter(SIMDIsa::Auto, WorkStealingThreadPool::shared())
+                                                   : SIMDBitonicSorter();
+    runSortLoop(state, data, [&](std::vector<int>& keys) {
+        if (state.range(1) == 0) {
+            for (std::size_t s = 0; s + 1 < offsets.size(); ++s) {
+                sorter.sort(keys.data() + offsets[s], offsets[s + 1] - offsets[s], SortOrder::Ascending);
+            }
+        } else {
+            sorter.sortSegments(keys, offsets, SortOrder::Ascending);
+        }
+    });
+    state.counters["segments_per_second"] =
+        benchmark::Counter(static_cast<double>(state.iterations() * state.range(0)), benchmark::Counter::kIsRate);
+    state.SetLabel(sorter.getName());
+}
+BENCHMARK(BM_SortSegments)
+    ->ArgsProduct({{1<<14, 1<<20}, {0, 1, 2}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Same sizes with the top merge levels split across the shared pool
+static void BM_SIMDBitonicSortLargeThreaded(benchmark::State& state) {
+    SIMDBitonicSorter sorter(SIMDIsa::Auto, WorkStealingThreadPool::shared());
+    BM_LargeSort(state, sorter);
+}
+BENCHMARK(BM_SIMDBitonicSortLargeThreaded)->RangeMultiplier(4)->Range(1<<20, 1<<26)->Unit(benchmark::kMillisecond);
+
+static void BM_BlockedBitonicSortLarge(benchmark::State& state) {
+    BlockedBitonicSorter sorter(state.range(1) * 1024);
+    BM_LargeSort(state, sorter);
+    state.counters["streaming_passes"] = sorter.countStreamingPasses(state.range(0));
+}
+BENCHMARK(BM_BlockedBitonicSortLarge)
+    ->ArgsProduct({benchmark::CreateRange(1<<20, 1<<26, 4), {64, 256, 1024}}) // size, tile KiB
+    ->Unit(benchmark::kMillisecond);
+
+// Bitonic blocks merged with merge path; std::sort as the O(N log N) reference
+static void BM_HybridBitonicSortLarge(benchmark::State& state) {
+    HybridBitonicSorter sorter(SIMDIsa::Auto, state.range(1) ? WorkStealingThreadPool::shared() : nullptr);
+    BM_LargeSort(state, sorter);
+}
+BENCHMARK(BM_HybridBitonicSortLarge)
+    ->ArgsProduct({benchmark::CreateRange(1<<20, 1<<26, 4), {0, 1}}) // size, on the shared pool
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_StdSortLarge(benchmark::State& state) {
+    std::vector<int> data = generate_data(state.range(0));
+    runSortLoop(state, data, [](std::vector<int>& keys) { std::sort(keys.begin(), keys.end()); });
+}
+BENCHMARK(BM_StdSortLarge)->RangeMultiplier(4)->Range(1<<20, 1<<26)->Unit(benchmark::kMillisecond);
+
+// --- Input distributions against the standard library ---
+// range(1) indexes DISTRIBUTIONS; range(2) is the sorter: 0 = std::sort, 1 = std::stable_sort,
+// 2 = std::sort(std::execution::par) (skipped in builds without parallel algorithms),
+// 3 = plain, 4 = SIMD, 5 = SIMD on the shared pool, 6 = hybrid on the shared pool,
+// 7 = adaptive around the SIMD sorter on the shared pool.
+static void BM_SortDistribution(benchmark::State& state) {
+    const std::string distribution = DISTRIBUTIONS[state.range(1)];
+    std::function<void(std::vector<int>&)> sort;
+    std::string name;
+    std::unique_ptr<BitonicSort> sorter;
+    switch (state.range(2)) {
+    case 0:
+        sort = [](std::vector<int>& keys) { std::sort(keys.begin(), keys.end()); };
+        name = "std::sort";
+        break;
+    case 1:
+        sort = [](std::vector<int>& keys) { std::stable_sort(keys.begin(), keys.end()); };
+        name = "std::stable_sort";
+        break;
+    case 2:
+#ifdef BITONIC_BENCH_PARALLEL_STL
+        sort = [](std::vector<int>& keys) { std::sort(std::execution::par, keys.begin(), keys.end()); };
+        name = "std::sort(par)";
+        break;
+#else
+        state.SkipWithError("parallel algorithms not available in this build");
+        return;
+#endif
+    case 3: sorter.reset(new PlainBitonicSorter()); break;
+    case 4: sorter.reset(new SIMDBitonicSorter()); break;
+    case 5: sorter.reset(new SIMDBitonicSorter(SIMDIsa::Auto, WorkStealingThreadPool::shared())); break;
+    case 6: sorter.reset(new HybridBitonicSorter(SIMDIsa::Auto, WorkStealingThreadPool::shared())); break;
+    default:
+        sorter.reset(new AdaptiveSorter(std::make_shared<SIMDBitonicSorter>(SIMDIsa::Auto, WorkStealingThreadPool::shared())));
+        break;
+    }
+    if (sorter) {
+        sort = [&](std::vector<int>& keys) { sorter->sort(keys, SortOrder::Ascending); };
+        name = sorter->getName();
+    }
+    std::vector<int> data = generate_data(state.range(0), distribution);
+    runSortLoop(state, data, sort);
+    state.SetLabel(distribution + ", " + name);
+}
+// Powers of two and sizes just off them, up to 2^26; the plain network stops at 2^20
+static void distributionArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"n", "distribution", "sorter"});
+    for (int64_t size : {1000, 1 << 10, 100000, 1 << 17, 1000000, 1 << 20, 10000000, 1 << 26}) {
+        for (int64_t distribution = 0; distribution < int64_t(std::size(DISTRIBUTIONS)); ++distribution) {
+            for (int64_t sorter = 0; sorter < 8; ++sorter) {
+                if (sorter != 3 || size <= (1 << 20)) {
+                    b->Args({size, distribution, sorter});
+                }
+            }
+        }
+    }
+}
+BENCHMARK(BM_SortDistribution)
+    ->Apply(distributionArgs)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+// --- Top-K Benchmark ---
+// Best range(1) of range(0) keys; range(2) runs the stream on the shared pool
+static void BM_SIMDTopK(benchmark::State& state) {
+    SIMDBitonicSorter sorter = state.range(2) ? SIMDBitonicSorter(SIMDIsa::Auto, WorkStealingThreadPool::shared())
+                                              : SIMDBitonicSorter();
+    std::vector<int> data = generate_data(state.range(0));
+    for (auto _ : state) {
+        std::vector<int> top = sorter.topK(data, state.range(1), SortOrder::Descending);
+        benchmark::DoNotOptimize(top.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(sorter.getName());
+}
+BENCHMARK(BM_SIMDTopK)
+    ->ArgsProduct({{1<<20, 10000000}, {16, 100, 1000}, {0, 1}}) // size, k, on the shared pool
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// --- Presortedness Benchmark ---
+// range(1) keys per 1000 out of place (-1: reversed input), sorted by SIMDBitonicSorter
+// (range(2) == 0) or by AdaptiveSorter around it (1), both on the shared pool
+static void BM_NearlySortedSort(benchmark::State& state) {
+    std::vector<int> data = state.range(1) < 0 ? generate_data(state.range(0), "reversed")
+                                                : generate_nearly_sorted(state.range(0), state.range(1));
+    auto simd = std::make_shared<SIMDBitonicSorter>(SIMDIsa::Auto, WorkStealingThreadPool::shared());
+    std::unique_ptr<BitonicSort> sorter;
+    if (state.range(2)) sorter.reset(new AdaptiveSorter(simd));
+    runSortLoop(state, data, [&](std::vector<int>& keys) { (sorter ? *sorter : *simd).sort(keys, SortOrder::Ascending); });
+    state.SetLabel((sorter ? *sorter : *simd).getName());
+}
+BENCHMARK(BM_NearlySortedSort)
+    ->ArgsProduct({{1<<20}, {0, 1, 10, 100, 1000, -1}, {0, 1}}) // size, disorder per mille, adaptive
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// --- Merge Benchmark ---
+// Merges two sorted halves of range(0) keys with std::merge (range(1) == 0), the SIMD
+// sorter's merge path (1), the same on the shared pool (2) and the StdThread bitonic merge (3)
+static void BM_MergeSorted(benchmark::State& state) {
+    const std::size_t half = state.range(0) / 2;
+    std::vector<int> a = generate_data(half);
+    std::vector<int> b = generate_data(state.range(0) - half);
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    std::vector<int> out(a.size() + b.size());
+    std::unique_ptr<BitonicSort> sorter;
+    switch (state.range(1)) {
+    case 1: sorter.reset(new SIMDBitonicSorter()); break;
+    case 2: sorter.reset(new SIMDBitonicSorter(SIMDIsa::Auto, WorkStealingThreadPool::shared())); break;
+    case 3: sorter.reset(new StdThreadBitonicSorter(WorkStealingThreadPool::shared())); break;
+    default: break;
+    }
+    for (auto _ : state) {
+        if (sorter) {
+            sorter->merge(a, b, out, SortOrder::Ascending);
+        } else {
+            std::merge(a.begin(), a.end(), b.begin(), b.end(), out.begin());
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(sorter ? sorter->getName() : "std::merge");
+}
+BENCHMARK(BM_MergeSorted)
+    ->ArgsProduct({{1<<16, 1<<20, 10000001}, {0, 1, 2, 3}}) // size, merger
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// --- Instrumented sorts ---
+// Where the time of one sort goes, per backend: range(1) is 0 = plain, 1 = std::thread,
+// 2 = OpenMP, 3 = SIMD on the shared pool, 4 = hybrid on the shared pool. Build with
+// -DBITONIC_SORT_STATS=ON for the phase, compare/swap and utilization counters.
+static void BM_InstrumentedSort(benchmark::State& state) {
+    std::unique_ptr<BitonicSort> sorter;
+    switch (state.range(1)) {
+    case 0: sorter.reset(new PlainBitonicSorter()); break;
+    case 1: sorter.reset(new StdThreadBitonicSorter(WorkStealingThreadPool::shared())); break;
+    case 2: sorter.reset(new OpenMPBitonicSorter()); break;
+    case 3: sorter.reset(new SIMDBitonicSorter(SIMDIsa::Auto, WorkStealingThreadPool::shared())); break;
+    default: sorter.reset(new HybridBitonicSorter(SIMDIsa::Auto, WorkStealingThreadPool::shared())); break;
+    }
+    BM_LargeSort(state, *sorter);
+}
+BENCHMARK(BM_InstrumentedSort)
+    ->ArgsProduct({{1<<16, 1<<20}, {0, 1, 2, 3, 4}}) // size, sorter
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// --- External Sort Benchmark ---
+// Sorts a file of range(0) MiB of ints with a memory budget of range(1) MiB, so the file
+// is range(0) / range(1) * 2 runs. Temp files go to the system temp directory.
+static void BM_ExternalSort(benchmark::State& state) {
+    const std::size_t keys = static_cast<std::size_t>(state.range(0)) * (1 << 20) / sizeof(int);
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string input = (dir / "bitonic_bm_external_in.bin").string();
+    const std::string output = (dir / "bitonic_bm_external_out.bin").string();
+    {
+        std::vector<int> data = generate_data(keys);
+        std::FILE* f = std::fopen(input.c_str(), "wb");
+        if (!f || std::fwrite(data.data(), sizeof(int), data.size(), f) != data.size()) {
+            state.SkipWithError("cannot write the input file");
+        }
+        if (f) std::fclose(f);
+    }
+
+    ExternalSortOptions options;
+    options.memory_budget_bytes = static_cast<std::size_t>(state.range(1)) << 20;
+    ExternalSorter sorter(options);
+    ExternalSortStats stats;
+    for (auto _ : state) {
+        stats = sorter.sortFile(input, output, SortOrder::Ascending);
+    }
+    std::filesystem::remove(input);
+    std::filesystem::remove(output);
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(stats.bytes));
+    state.counters["runs"] = static_cast<double>(stats.runs);
+    state.counters["merge_passes"] = stats.merge_passes;
+    state.counters["run_phase_s"] = stats.run_seconds;
+    state.counters["merge_phase_s"] = stats.merge_seconds;
+    state.SetLabel(sorter.getName());
+}
+BENCHMARK(BM_ExternalSort)
+    ->Args({256, 1024})->Args({256, 64})->Args({256, 16}) // file MiB, budget MiB
+    ->Iterations(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,247 @@
+// Heap and resident memory of each sorter, by input size. The global operator new and
+// delete are replaced to count every allocation in the process, so this is a separate
+// executable from run_benchmarks, whose timings should not pay for the counting:
+//
+//   memory_benchmarks --benchmark_format=csv > doc/data/memory_results.csv
+//
+// Counters, per measured call:
+//   allocs_per_sort       operator new calls
+//   alloc_bytes_per_sort  bytes they requested
+//   peak_extra_bytes      most heap in use above the start of the call, largest of the calls
+//   peak_rss_kib          the process's peak resident set so far (POSIX; 0 elsewhere)
+// Thread stacks are not on the heap; they only show up in peak_rss_kib. BM_<Sorter>Memory
+// includes a fresh sorter's first call; BM_<Sorter>SteadyStateMemory sorts once before
+// measuring, so its allocs_per_sort is what a sorter that is reused keeps paying, zero
+// for the sorters that keep their scratch in a SortWorkspace.
+// BM_<Sorter>SteadyStateSegmentsMemory and BM_<Sorter>SteadyStateTopKMemory measure
+// sortSegments() over segments of 1 to MAX_SEGMENT_KEYS keys, and topK() of TOPK_KEYS
+// keys, the same way.
+#include "benchmark/benchmark.h"
+#include "plain_bitonic_sorter.h"
+#include "std_thread_bitonic_sorter.h"
+#include "openmp_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include "blocked_bitonic_sorter.h"
+#include "hybrid_bitonic_sorter.h"
+#include "adaptive_sorter.h"
+#include <algorithm> // For std::generate, std::max
+#include <atomic>
+#include <cstdint>   // For std::uintptr_t
+#include <cstdlib>   // For std::malloc, std::free
+#include <functional>
+#include <memory>    // For std::unique_ptr
+#include <new>
+#include <random>    // For std::mt19937
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h> // For getrusage
+#endif
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> allocated_bytes{0};
+std::atomic<std::size_t> bytes_in_use{0};
+std::atomic<std::size_t> peak_bytes_in_use{0};
+
+// The block's size and the offset of the caller's pointer into the malloc block sit just
+// before that pointer
+constexpr std::size_t HEADER_BYTES = alignof(std::max_align_t);
+
+void* allocate(std::size_t size, std::size_t alignment) {
+    alignment = std::max(alignment, HEADER_BYTES);
+    char* block = static_cast<char*>(std::malloc(size + alignment));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block) + HEADER_BYTES;
+    char* user = block + (address + alignment - 1) / alignment * alignment - reinterpret_cast<std::uintptr_t>(block);
+    reinterpret_cast<std::size_t*>(user)[-1] = size;
+    reinterpret_cast<std::size_t*>(user)[-2] = static_cast<std::size_t>(user - block);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    const std::size_t in_use = bytes_in_use.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak = peak_bytes_in_use.load(std::memory_order_relaxed);
+    while (in_use > peak && !peak_bytes_in_use.compare_exchange_weak(peak, in_use, std::memory_order_relaxed)) {
+    }
+    return user;
+}
+
+void release(void* user) noexcept {
+    if (!user) {
+        return;
+    }
+    const std::size_t size = static_cast<std::size_t*>(user)[-1];
+    const std::size_t offset = static_cast<std::size_t*>(user)[-2];
+    bytes_in_use.fetch_sub(size, std::memory_order_relaxed);
+    std::free(static_cast<char*>(user) - offset);
+}
+
+std::size_t peakRssKiB() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<std::size_t>(usage.ru_maxrss) / 1024; // Bytes on macOS
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#endif
+#else
+    return 0;
+#endif
+}
+
+const std::size_t MAX_SEGMENT_KEYS = 100;
+const std::size_t TOPK_KEYS = 1000;
+
+using MakeSorter = std::function<std::unique_ptr<BitonicSort>()>;
+// One measured call on keys, which are reset to the same input before each
+using SorterCall = std::function<void(BitonicSort&, std::vector<int>&)>;
+
+std::vector<int> generateData(std::size_t size) {
+    std::vector<int> data(size);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> distrib(0, static_cast<int>(size * 10));
+    std::generate(data.begin(), data.end(), [&]() { return distrib(gen); });
+    return data;
+}
+
+// Segment boundaries over size keys, each segment 1 to MAX_SEGMENT_KEYS long
+std::vector<std::size_t> generateOffsets(std::size_t size) {
+    std::vector<std::size_t> offsets = {0};
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<std::size_t> distrib(1, MAX_SEGMENT_KEYS);
+    while (offsets.back() < size) {
+        offsets.push_back(std::min(size, offsets.back() + distrib(gen)));
+    }
+    return offsets;
+}
+
+void measureSorter(benchmark::State& state, const MakeSorter& make, bool warm_up, const SorterCall& call) {
+    std::unique_ptr<BitonicSort> sorter = make();
+    const std::vector<int> data = generateData(state.range(0));
+    std::vector<int> keys = data;
+    if (warm_up) {
+        call(*sorter, keys);
+    }
+    std::size_t sort_allocations = 0;
+    std::size_t sort_bytes = 0;
+    std::size_t peak_extra = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::copy(data.begin(), data.end(), keys.begin());
+        const std::size_t allocations_before = allocations.load();
+        const std::size_t bytes_before = allocated_bytes.load();
+        const std::size_t in_use_before = bytes_in_use.load();
+        peak_bytes_in_use.store(in_use_before);
+        state.ResumeTiming();
+
+        call(*sorter, keys);
+
+        state.PauseTiming();
+        sort_allocations += allocations.load() - allocations_before;
+        sort_bytes += allocated_bytes.load() - bytes_before;
+        peak_extra = std::max(peak_extra, peak_bytes_in_use.load() - in_use_before);
+        state.ResumeTiming();
+    }
+    using benchmark::Counter;
+    state.counters["allocs_per_sort"] = Counter(static_cast<double>(sort_allocations), Counter::kAvgIterations);
+    state.counters["alloc_bytes_per_sort"] = Counter(static_cast<double>(sort_bytes), Counter::kAvgIterations);
+    state.counters["peak_extra_bytes"] = static_cast<double>(peak_extra);
+    state.counters["peak_rss_kib"] = static_cast<double>(peakRssKiB());
+    state.SetLabel(sorter->getName());
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return allocate(size, HEADER_BYTES); }
+void* operator new[](std::size_t size) { return allocate(size, HEADER_BYTES); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size, HEADER_BYTES); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size, HEADER_BYTES); } catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+
+int main(int argc, char** argv) {
+    // Named BM_<Sorter>Memory/<size>, which utils/plot_benchmarks.py parses like the timings
+    const std::vector<std::pair<std::string, MakeSorter>> sorters = {
+        {"Plain", [] { return std::make_unique<PlainBitonicSorter>(); }},
+        {"StdThread", [] { return std::make_unique<StdThreadBitonicSorter>(); }},
+        {"StdThreadSharedPool", [] { return std::make_unique<StdThreadBitonicSorter>(WorkStealingThreadPool::shared()); }},
+        {"OpenMP", [] { return std::make_unique<OpenMPBitonicSorter>(); }},
+        {"SIMD", [] { return std::make_unique<SIMDBitonicSorter>(); }},
+        {"SIMDSharedPool", [] { return std::make_unique<SIMDBitonicSorter>(SIMDIsa::Auto, WorkStealingThreadPool::shared()); }},
+        {"Blocked", [] { return std::make_unique<BlockedBitonicSorter>(); }},
+        {"Hybrid", [] { return std::make_unique<HybridBitonicSorter>(SIMDIsa::Auto, WorkStealingThreadPool::shared()); }},
+        {"Adaptive", [] { return std::make_unique<AdaptiveSorter>(); }},
+    };
+    const SorterCall sort = [](BitonicSort& sorter, std::vector<int>& keys) { sorter.sort(keys, SortOrder::Ascending); };
+    for (const auto& sorter : sorters) {
+        const auto make = sorter.second;
+        benchmark::RegisterBenchmark(("BM_" + sorter.first + "Memory").c_str(),
+                                     [make, sort](benchmark::State& state) { measureSorter(state, make, false, sort); })
+            ->RangeMultiplier(16)
+            ->Range(1 << 10, sorter.first == "Plain" ? 1 << 18 : 1 << 22)
+            ->Arg(1000000) // Not a power of two
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+    }
+    for (const auto& sorter : sorters) {
+        const auto make = sorter.second;
+        benchmark::RegisterBenchmark(("BM_" + sorter.first + "SteadyStateMemory").c_str(),
+                                     [make, sort](benchmark::State& state) { measureSorter(state, make, true, sort); })
+            ->Arg(1 << 16)
+            ->Arg(1000000)
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+    }
+    for (const auto& sorter : sorters) {
+        const auto make = sorter.second;
+        benchmark::RegisterBenchmark(
+            ("BM_" + sorter.first + "SteadyStateSegmentsMemory").c_str(), [make](benchmark::State& state) {
+                const std::vector<std::size_t> offsets = generateOffsets(state.range(0));
+                measureSorter(state, make, true, [&offsets](BitonicSort& sorter, std::vector<int>& keys) {
+                    sorter.sortSegments(keys, offsets, SortOrder::Ascending);
+                });
+            })
+            ->Arg(1 << 16)
+            ->Arg(1000000)
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+    }
+    for (const auto& sorter : sorters) {
+        const auto make = sorter.second;
+        benchmark::RegisterBenchmark(
+            ("BM_" + sorter.first + "SteadyStateTopKMemory").c_str(), [make](benchmark::State& state) {
+                std::vector<int> best(TOPK_KEYS);
+                measureSorter(state, make, true, [&best](BitonicSort& sorter, std::vector<int>& keys) {
+                    sorter.topK(keys.data(), keys.size(), best.size(), best.data(), SortOrder::Ascending);
+                });
+            })
+            ->Arg(1 << 16)
+            ->Arg(1000000)
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+    }
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include "adaptive_sorter.h"
+#include "merge_path.h"
+#include "simd_bitonic_sorter.h"
+#include "work_stealing_thread_pool.h"
+#include <algorithm> // For std::copy, std::copy_backward, std::min, std::reverse, std::upper_bound
+
+namespace {
+
+// Merges data[0, m) and aside[0, k), both sorted in order, into data[0, m + k) from the
+// back, so no key of data is overwritten before it has moved. Each key of the smaller input
+// is placed by a binary search in the larger one, whose keys in between move as a block:
+// O(min(m, k) log max(m, k) + m + k).
+template <typename T>
+void mergeBackInPlace(T* data, std::size_t m, const T* aside, std::size_t k, SortOrder order) {
+    auto before = [order](T a, T b) { return sortsBefore(a, b, order); };
+    std::size_t out = m + k;
+    if (k <= m) {
+        while (k > 0) {
+            const T key = aside[k - 1];
+            const std::size_t pos = std::upper_bound(data, data + m, key, before) - data;
+            std::copy_backward(data + pos, data + m, data + out);
+            out -= m - pos;
+            m = pos;
+            data[--out] = key;
+            --k;
+        }
+    } else {
+        while (m > 0) {
+            const T key = data[m - 1];
+            const std::size_t pos = std::upper_bound(aside, aside + k, key, before) - aside;
+            std::copy_backward(aside + pos, aside + k, data + out);
+            out -= k - pos;
+            k = pos;
+            data[--out] = key;
+            --m;
+        }
+        std::copy(aside, aside + k, data);
+    }
+}
+
+} // namespace
+
+template <typename T>
+BasicAdaptiveSorter<T>::BasicAdaptiveSorter(std::shared_ptr<BasicBitonicSort<T>> inner, SIMDIsa isa)
+    : inner_(std::move(inner)), kernels_(&selectSIMDKernels<T>(isa)) {
+    if (!inner_) {
+        inner_ = std::make_shared<BasicSIMDBitonicSorter<T>>(isa, WorkStealingThreadPool::shared());
+    }
+}
+
+template <typename T>
+bool BasicAdaptiveSorter<T>::sortIfMonotonic(T* keys, payload_type* values, int count, SortOrder order) {
+    if (kernels_->sortedPrefix(keys, count, order) == count) {
+        return true;
+    }
+    if (kernels_->sortedPrefix(keys, count, this->oppositeOrder(order)) != count) {
+        return false;
+    }
+    std::reverse(keys, keys + count);
+    if (values) {
+        std::reverse(values, values + count);
+    }
+    return true;
+}
+
+template <typename T>
+void BasicAdaptiveSorter<T>::sort(T* data, std::size_t count, SortOrder order) {
+    if (count <= 1) {
+        return;
+    }
+    const int n = this->checkedCount(count);
+    SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+    if (sortIfMonotonic(data, nullptr, n, order)) {
+        return;
+    }
+
+    const SortOrder against = this->oppositeOrder(order);
+    const std::size_t max_aside = count / MAX_ASIDE_DIVISOR;
+    // Every key aside was scanned, so at most n of them
+    SortWorkspace::Lease workspace(this->workspace_);
+    T* aside = workspace.get<T>(0, n);
+    std::size_t k = 0;
+    int kept = 0;    // data[0, kept) is the sorted prefix
+    int i = 0;       // Next key to scan
+    int checked = 0; // Keys before this were already tried as the start of a reversed run
+    while (i < n) {
+        if (kept > 0 && sortsBefore(data[i], data[kept - 1], order)) {
+            if (i >= checked) {
+                const int reversed = kernels_->sortedPrefix(data + i, n - i, against);
+                checked = i + reversed;
+                if (reversed >= MIN_REVERSED_RUN) {
+                    std::reverse(data + i, data + checked);
+                    continue;
+                }
+            }
+            aside[k++] = data[--kept];
+            aside[k++] = data[i++];
+            if (i >= PROBE_KEYS && k * 2 > static_cast<std::size_t>(i)) {
+                // Mostly out of order: data[kept, i) has room for the keys aside
+                std::copy(aside, aside + k, data + kept);
+                inner_->sort(data, count, order);
+                return;
+            }
+            if (k > max_aside) {
+                k = std::copy(data + i, data + n, aside + k) - aside;
+                i = n;
+            }
+            continue;
+        }
+        const int run = kernels_->sortedPrefix(data + i, n - i, order);
+        if (kept != i) {
+            std::copy(data + i, data + i + run, data + kept);
+        }
+        kept += run;
+        i += run;
+    }
+
+    inner_->sort(aside, k, order);
+    if (std::min<std::size_t>(kept, k) <= count / GALLOP_DIVISOR) {
+        SortStatsTimer timer(&this->stats_, SortPhase::Merge);
+        mergeBackInPlace(data, kept, aside, k, order);
+    } else {
+        T* prefix = workspace.get<T>(1, kept);
+        std::copy(data, data + kept, prefix);
+        inner_->merge(prefix, kept, aside, k, data, order);
+    }
+}
+
+template <typename T>
+void BasicAdaptiveSorter<T>::sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) {
+    if (count <= 1) {
+        return;
+    }
+    SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+    if (!sortIfMonotonic(keys, values, this->checkedCount(count), order)) {
+        inner_->sortPairs(keys, values, count, order);
+    }
+}
+
+template <typename T>
+void BasicAdaptiveSorter<T>::merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, SortOrder order) {
+    inner_->merge(a, na, b, nb, out, order);
+}
+
+template <typename T>
+std::size_t BasicAdaptiveSorter<T>::topK(const T* data, std::size_t count, std::size_t k, T* out, SortOrder order) {
+    return inner_->topK(data, count, k, out, order);
+}
+
+template <typename T>
+SortStats BasicAdaptiveSorter<T>::getStats() const {
+    SortStats stats = this->stats_.get();
+    stats.add(inner_->getStats(), true);
+    return stats;
+}
+
+template <typename T>
+void BasicAdaptiveSorter<T>::resetStats() {
+    this->stats_.reset();
+    inner_->resetStats();
+}
+
+template <typename T>
+std::size_t BasicAdaptiveSorter<T>::getWorkspaceBytes() const {
+    return BasicBitonicSort<T>::getWorkspaceBytes() + inner_->getWorkspaceBytes();
+}
+
+template <typename T>
+void BasicAdaptiveSorter<T>::releaseWorkspace() {
+    BasicBitonicSort<T>::releaseWorkspace();
+    inner_->releaseWorkspace();
+}
+
+template <typename T>
+std::string BasicAdaptiveSorter<T>::getName() const {
+    return "AdaptiveSorter" + keyTypeSuffix<T>() + " (" + inner_->getName() + ")";
+}
+
+#define INSTANTIATE_ADAPTIVE_SORTER(T) template class BasicAdaptiveSorter<T>;
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_ADAPTIVE_SORTER)
+#undef INSTANTIATE_ADAPTIVE_SORTER
@@ -0,0 +1,69 @@
+#ifndef ADAPTIVE_SORTER_H
+#define ADAPTIVE_SORTER_H
+
+#include "bitonic_sort.h"
+#include <string>
+#include <cstddef>   // For std::size_t
+#include <memory>    // For std::shared_ptr
+#include "simd_kernels.h"
+
+// Presortedness-adaptive front end for another sorter. A bitonic network does the same
+// O(N log^2 N) work on any input, so sort() first scans it with the sortedPrefix kernel:
+//   - input already sorted in order returns at once, and input sorted against it is reversed;
+//   - otherwise one pass keeps the keys that extend a sorted prefix where they are and takes
+//     each key that breaks it aside, together with the prefix's last key (Cook and Kim).
+//     Runs of at least MIN_REVERSED_RUN keys sorted against the order are reversed first;
+//   - the keys taken aside are sorted by the inner sorter and merged back.
+// Nearly sorted input therefore costs a linear scan plus a sort of its disorder. The scan
+// gives up on input where more than half of the keys scanned went aside (after the first
+// PROBE_KEYS), which leaves random input to the inner sorter for the price of a short
+// probe. Once more than 1 / MAX_ASIDE_DIVISOR of the input is aside, the rest goes aside
+// unscanned, so a sorted prefix followed by unsorted keys is still only merged.
+template <typename T>
+class BasicAdaptiveSorter : public BasicBitonicSort<T> {
+public:
+    // The inner sorter defaults to SIMDBitonicSorter on the shared pool
+    explicit BasicAdaptiveSorter(std::shared_ptr<BasicBitonicSort<T>> inner = nullptr, SIMDIsa isa = SIMDIsa::Auto);
+    ~BasicAdaptiveSorter() override = default;
+
+    using payload_type = typename BasicBitonicSort<T>::payload_type;
+
+    using BasicBitonicSort<T>::sort;
+    using BasicBitonicSort<T>::sortPairs;
+    void sort(T* data, std::size_t count, SortOrder order) override;
+    // Sorted and reversed keys are handled as in sort(); anything else goes to the inner sorter
+    void sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) override;
+    using BasicBitonicSort<T>::merge;
+    void merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, SortOrder order) override;
+    using BasicBitonicSort<T>::topK;
+    std::size_t topK(const T* data, std::size_t count, std::size_t k, T* out, SortOrder order) override;
+    std::string getName() const override;
+    // Includes the inner sorter's work
+    SortStats getStats() const override;
+    void resetStats() override;
+    std::size_t getWorkspaceBytes() const override;
+    void releaseWorkspace() override;
+
+    const std::shared_ptr<BasicBitonicSort<T>>& getInnerSorter() const { return inner_; }
+
+    // Shortest run sorted against the order that the scan reverses in place
+    static const int MIN_REVERSED_RUN = 64;
+    // Keys scanned before mostly unsorted input is handed to the inner sorter
+    static const int PROBE_KEYS = 4096;
+    // The scan stops once more than count / MAX_ASIDE_DIVISOR keys are aside
+    static const int MAX_ASIDE_DIVISOR = 8;
+    // The keys aside are merged back in place while the smaller of the two sides has at
+    // most count / GALLOP_DIVISOR keys, otherwise through the inner sorter's merge
+    static const int GALLOP_DIVISOR = 32;
+
+private:
+    std::shared_ptr<BasicBitonicSort<T>> inner_;
+    const SIMDKernels<T>* kernels_;
+
+    // Handles sorted and reversed input; false when keys are neither
+    bool sortIfMonotonic(T* keys, payload_type* values, int count, SortOrder order);
+};
+
+using AdaptiveSorter = BasicAdaptiveSorter<int>;
+
+#endif // ADAPTIVE_SORTER_H
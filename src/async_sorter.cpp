@@ -0,0 +1,247 @@
+#include "async_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include "sort_key_traits.h" // For keyTypeSuffix
+#include "sort_stats.h"      // For bitonicSortComparators, bitonicMergeComparators
+#include <algorithm>         // For std::min, std::max
+#include <limits>            // For std::numeric_limits
+
+namespace {
+
+// As BasicBitonicSort::splitPoint
+int splitPoint(int count) {
+    int k = 1;
+    while (k < count - k) {
+        k *= 2;
+    }
+    return k;
+}
+
+SortOrder oppositeOrder(SortOrder order) {
+    return (order == SortOrder::Ascending) ? SortOrder::Descending : SortOrder::Ascending;
+}
+
+} // namespace
+
+template <typename T>
+BasicAsyncSorter<T>::BasicAsyncSorter(SIMDIsa isa, std::shared_ptr<WorkStealingThreadPool> pool, int stage_keys)
+    : kernels_(&selectSIMDKernels<T>(isa)), pool_(std::move(pool)), stage_keys_(stage_keys) {
+    if (stage_keys < 1) {
+        throw std::invalid_argument("AsyncSorter: stage_keys must be positive");
+    }
+    executor_ = std::thread([this] { executorLoop(); });
+}
+
+template <typename T>
+BasicAsyncSorter<T>::~BasicAsyncSorter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        // Queued jobs still run, but stop at their first checkpoint
+        for (Job& job : queue_) {
+            job.state->cancel_requested.store(true, std::memory_order_relaxed);
+        }
+        if (running_) {
+            running_->cancel_requested.store(true, std::memory_order_relaxed);
+        }
+    }
+    wake_.notify_one();
+    executor_.join();
+}
+
+template <typename T>
+AsyncSortJob BasicAsyncSorter<T>::sortAsync(T* data, std::size_t count, SortOrder order, AsyncSortOptions options) {
+    if (count > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+        throw std::length_error("bitonic sort: more than INT_MAX elements");
+    }
+    auto state = std::make_shared<AsyncSortState>();
+    state->comparators_total = bitonicSortComparators(count);
+    Job job{data, static_cast<int>(count), order, std::move(options), state, std::promise<void>()};
+    AsyncSortJob handle(state, job.promise.get_future().share());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(job));
+    }
+    wake_.notify_one();
+    return handle;
+}
+
+template <typename T>
+std::string BasicAsyncSorter<T>::getName() const {
+    std::string threads = std::to_string(pool_ ? pool_->getWorkerCount() + 1 : 1) + " threads";
+    return "AsyncSorter" + keyTypeSuffix<T>() + " (" + simdIsaName(kernels_->isa) + ", " + threads + ")";
+}
+
+template <typename T>
+void BasicAsyncSorter<T>::executorLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return; // Stopping, and every job has been answered
+        }
+        Job job = std::move(queue_.front());
+        queue_.pop_front();
+        running_ = job.state;
+        lock.unlock();
+        run(job);
+        lock.lock();
+        running_.reset();
+    }
+}
+
+template <typename T>
+void BasicAsyncSorter<T>::run(Job& job) {
+    std::exception_ptr error;
+    try {
+        checkpoint(job);
+        if (job.count > 1) {
+            std::vector<Frame> leaves;
+            std::vector<std::vector<Frame>> merges;
+            collectFrames({0, job.count, job.order}, 0, leaves, merges);
+            sortLeaves(job, leaves);
+            // A level's merges need every deeper level done; within a level they are disjoint
+            for (std::size_t depth = merges.size(); depth-- > 0;) {
+                mergeLevel(job, std::move(merges[depth]));
+            }
+        }
+        job.promise.set_value();
+    } catch (...) {
+        error = std::current_exception();
+        job.promise.set_exception(error);
+    }
+    if (job.options.on_complete) {
+        job.options.on_complete(error);
+    }
+}
+
+template <typename T>
+void BasicAsyncSorter<T>::checkpoint(const Job& job) const {
+    if (job.state->cancel_requested.load(std::memory_order_relaxed)) {
+        throw SortCancelled("async sort: cancelled");
+    }
+    if (job.options.deadline != std::chrono::steady_clock::time_point::max() &&
+        std::chrono::steady_clock::now() >= job.options.deadline) {
+        throw SortDeadlineExceeded("async sort: deadline exceeded");
+    }
+}
+
+// The recursion of BasicSIMDBitonicSorter::sort, flattened: frames of up to stage_keys_ are
+// leaves, and the larger ones are merged after everything below them, by depth
+template <typename T>
+void BasicAsyncSorter<T>::collectFrames(Frame frame, int depth, std::vector<Frame>& leaves,
+                                        std::vector<std::vector<Frame>>& merges) const {
+    if (frame.count <= stage_keys_) {
+        leaves.push_back(frame);
+        return;
+    }
+    int k = splitPoint(frame.count);
+    collectFrames({frame.low, k, oppositeOrder(frame.order)}, depth + 1, leaves, merges);
+    collectFrames({frame.low + k, frame.count - k, frame.order}, depth + 1, leaves, merges);
+    if (merges.size() <= static_cast<std::size_t>(depth)) {
+        merges.resize(depth + 1);
+    }
+    merges[depth].push_back(frame);
+}
+
+template <typename T>
+void BasicAsyncSorter<T>::sortLeaves(Job& job, const std::vector<Frame>& leaves) {
+    const std::size_t batch = pool_ ? pool_->getWorkerCount() + 1 : 1;
+    for (std::size_t first = 0; first < leaves.size(); first += batch) {
+        checkpoint(job);
+        const std::size_t last = std::min(first + batch, leaves.size());
+        forEach(static_cast<int>(last - first), [&](int begin, int end) {
+            BasicSIMDBitonicSorter<T> sorter(kernels_->isa);
+            for (int i = begin; i < end; ++i) {
+                const Frame& leaf = leaves[first + i];
+                sorter.sort(job.data + leaf.low, leaf.count, leaf.order);
+            }
+        });
+        std::uint64_t comparators = 0;
+        for (std::size_t i = first; i < last; ++i) {
+            comparators += bitonicSortComparators(leaves[i].count);
+        }
+        job.state->comparators_done.fetch_add(comparators, std::memory_order_relaxed);
+    }
+}
+
+// Merges frames (all larger than a leaf): one stage per compare-exchange level while the
+// subproblems are larger than a leaf, then the leaf-sized subproblems with the kernels'
+// whole-merge recursion
+template <typename T>
+void BasicAsyncSorter<T>::mergeLevel(Job& job, std::vector<Frame> frames) {
+    // One pool task's share of a level: length pairs from lo and lo + stride
+    struct PassSlice {
+        T* lo;
+        int stride;
+        int length;
+        SortOrder order;
+        bool streaming;
+    };
+    std::vector<Frame> small;
+    std::vector<Frame> next;
+    std::vector<PassSlice> slices;
+    while (!frames.empty()) {
+        checkpoint(job);
+        slices.clear();
+        next.clear();
+        std::uint64_t comparators = 0;
+        for (const Frame& frame : frames) {
+            const int k = splitPoint(frame.count);
+            const int pairs = frame.count - k;
+            // Passes much larger than the last-level cache bypass it, as in the SIMD sorter
+            const bool streaming = frame.count * sizeof(T) > streamingStoreThresholdBytes();
+            for (int begin = 0; begin < pairs; begin += PASS_SLICE_KEYS) {
+                slices.push_back({job.data + frame.low + begin, k, std::min(static_cast<int>(PASS_SLICE_KEYS), pairs - begin),
+                                  frame.order, streaming});
+            }
+            comparators += pairs;
+            for (const Frame& half : {Frame{frame.low, k, frame.order}, Frame{frame.low + k, pairs, frame.order}}) {
+                if (half.count > stage_keys_) {
+                    next.push_back(half);
+                } else if (half.count > 1) {
+                    small.push_back(half);
+                }
+            }
+        }
+        forEach(static_cast<int>(slices.size()), [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                const PassSlice& slice = slices[i];
+                (slice.streaming ? kernels_->compareAndSwapBlocksStreaming : kernels_->compareAndSwapBlocks)(
+                    slice.lo, slice.lo + slice.stride, slice.length, slice.order);
+            }
+        });
+        job.state->comparators_done.fetch_add(comparators, std::memory_order_relaxed);
+        frames.swap(next);
+    }
+
+    const std::size_t batch = pool_ ? pool_->getWorkerCount() + 1 : 1;
+    for (std::size_t first = 0; first < small.size(); first += batch) {
+        checkpoint(job);
+        const std::size_t last = std::min(first + batch, small.size());
+        forEach(static_cast<int>(last - first), [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                const Frame& frame = small[first + i];
+                kernels_->bitonicMerge(job.data + frame.low, frame.count, frame.order);
+            }
+        });
+        std::uint64_t comparators = 0;
+        for (std::size_t i = first; i < last; ++i) {
+            comparators += bitonicMergeComparators(small[i].count);
+        }
+        job.state->comparators_done.fetch_add(comparators, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+template <typename F>
+void BasicAsyncSorter<T>::forEach(int count, F&& fn) {
+    if (pool_) {
+        pool_->parallelFor(0, count, 1, fn);
+    } else {
+        fn(0, count);
+    }
+}
+
+#define INSTANTIATE_ASYNC_SORTER(T) template class BasicAsyncSorter<T>;
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_ASYNC_SORTER)
+#undef INSTANTIATE_ASYNC_SORTER
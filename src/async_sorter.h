@@ -0,0 +1,165 @@
+#ifndef ASYNC_SORTER_H
+#define ASYNC_SORTER_H
+
+#include "bitonic_sort.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>   // For std::size_t
+#include <cstdint>
+#include <deque>
+#include <exception> // For std::exception_ptr
+#include <functional> // For std::function
+#include <future>
+#include <memory>    // For std::shared_ptr
+#include <mutex>
+#include <stdexcept> // For std::runtime_error
+#include <string>
+#include <thread>
+#include <vector>
+#include "simd_kernels.h"
+#include "work_stealing_thread_pool.h"
+
+// Thrown through AsyncSortJob::get() for a job stopped by cancel() or by the destruction of
+// its sorter. The keys are left a permutation of the input, partly sorted.
+class SortCancelled : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Thrown through AsyncSortJob::get() for a job still running at its deadline
+class SortDeadlineExceeded : public SortCancelled {
+public:
+    using SortCancelled::SortCancelled;
+};
+
+struct AsyncSortOptions {
+    // Checked between stages, like cancel(); the default means none
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    // Called on the executor thread once the job's future is ready, with null on success or
+    // the exception the future holds. Must not throw.
+    std::function<void(std::exception_ptr)> on_complete;
+};
+
+// What a running job and its AsyncSortJob handles share
+struct AsyncSortState {
+    std::atomic<bool> cancel_requested{false};
+    std::atomic<std::uint64_t> comparators_done{0};
+    std::uint64_t comparators_total = 0; // Set before the job is queued
+};
+
+// Handle to one sortAsync call. Copies refer to the same job; the job runs whether or not
+// any handle is kept.
+class AsyncSortJob {
+public:
+    AsyncSortJob() = default;
+    AsyncSortJob(std::shared_ptr<AsyncSortState> state, std::shared_future<void> future)
+        : state_(std::move(state)), future_(std::move(future)) {}
+
+    // Asks the job to stop. It does so at the next stage boundary, and get() then throws
+    // SortCancelled; a job that already finished is not affected.
+    void cancel() { state_->cancel_requested.store(true, std::memory_order_relaxed); }
+
+    // Fraction of the network's compare-exchanges in completed stages, 0 to 1
+    double progress() const {
+        const std::uint64_t total = state_->comparators_total;
+        if (total == 0) {
+            return ready() ? 1.0 : 0.0;
+        }
+        return static_cast<double>(state_->comparators_done.load(std::memory_order_relaxed)) / total;
+    }
+
+    bool ready() const { return future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+    void wait() const { future_.wait(); }
+    template <typename Rep, typename Period>
+    bool waitFor(const std::chrono::duration<Rep, Period>& timeout) const {
+        return future_.wait_for(timeout) == std::future_status::ready;
+    }
+    // Waits, then rethrows what stopped the job, if anything
+    void get() const { future_.get(); }
+    const std::shared_future<void>& future() const { return future_; }
+
+private:
+    std::shared_ptr<AsyncSortState> state_;
+    std::shared_future<void> future_;
+};
+
+// Sorts on its own executor thread, so the caller never blocks on a sort. Jobs run one at a
+// time in submission order; queue several to pipeline them, or use several sorters to run
+// them concurrently. Each job is the network of BasicSIMDBitonicSorter cut into stages:
+//   1. Leaves of up to getStageKeys() keys, sorted a batch (one per pool thread) per stage.
+//   2. Per level of the sort recursion, deepest first: one compare-exchange pass over every
+//      merge still larger than a leaf per stage, then the leaf-sized merges in batches.
+// Each stage runs across the pool. cancel() and the deadline are checked before every
+// stage, and progress() advances after each one. The keys must stay valid, and must not be
+// touched by anyone else, until the job's future is ready.
+template <typename T>
+class BasicAsyncSorter {
+public:
+    explicit BasicAsyncSorter(SIMDIsa isa = SIMDIsa::Auto,
+                              std::shared_ptr<WorkStealingThreadPool> pool = WorkStealingThreadPool::shared(),
+                              int stage_keys = DEFAULT_STAGE_KEYS);
+    // Cancels the queued and running jobs, then joins the executor; every future is ready
+    // by the time it returns
+    ~BasicAsyncSorter();
+    BasicAsyncSorter(const BasicAsyncSorter&) = delete;
+    BasicAsyncSorter& operator=(const BasicAsyncSorter&) = delete;
+
+    // Queues a sort of data[0, count). Throws std::length_error if count exceeds INT_MAX.
+    AsyncSortJob sortAsync(T* data, std::size_t count, SortOrder order, AsyncSortOptions options = AsyncSortOptions());
+    AsyncSortJob sortAsync(std::vector<T>& arr, SortOrder order, AsyncSortOptions options = AsyncSortOptions()) {
+        return sortAsync(arr.data(), arr.size(), order, std::move(options));
+    }
+
+    std::string getName() const;
+    int getStageKeys() const { return stage_keys_; }
+
+    // Leaf size: a few milliseconds of work per pool thread, so a stop takes effect quickly
+    static const int DEFAULT_STAGE_KEYS = 1 << 16;
+    // Compare-exchange pairs per pool task in a stage of one merge level, as the SIMD
+    // sorter's PARALLEL_COMPARE_GRAIN_SIMD
+    static const int PASS_SLICE_KEYS = 1 << 13;
+
+private:
+    struct Job {
+        T* data;
+        int count;
+        SortOrder order;
+        AsyncSortOptions options;
+        std::shared_ptr<AsyncSortState> state;
+        std::promise<void> promise;
+    };
+    // A subproblem of the sort recursion
+    struct Frame {
+        int low;
+        int count;
+        SortOrder order;
+    };
+
+    const SIMDKernels<T>* kernels_;
+    std::shared_ptr<WorkStealingThreadPool> pool_;
+    int stage_keys_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<Job> queue_;
+    std::shared_ptr<AsyncSortState> running_; // State of the job on the executor, if any
+    bool stopping_ = false;
+    std::thread executor_; // Last: started once everything above is constructed
+
+    void executorLoop();
+    void run(Job& job);
+    // Throws when the job must stop before its next stage
+    void checkpoint(const Job& job) const;
+    void collectFrames(Frame frame, int depth, std::vector<Frame>& leaves,
+                       std::vector<std::vector<Frame>>& merges) const;
+    void sortLeaves(Job& job, const std::vector<Frame>& leaves);
+    void mergeLevel(Job& job, std::vector<Frame> frames);
+    // fn(begin, end) over [0, count), across the pool when there is one
+    template <typename F>
+    void forEach(int count, F&& fn);
+};
+
+using AsyncSorter = BasicAsyncSorter<int>;
+
+#endif // ASYNC_SORTER_H
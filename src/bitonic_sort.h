@@ -3,7 +3,15 @@
 
 #include <vector>
 #include <string>
-#include <algorithm> // Required for std::swap
+#include <algorithm> // Required for std::swap, std::copy, std::fill, std::reverse, std::reverse_copy
+#include <cstddef>   // For std::size_t
+#include <limits>    // For std::numeric_limits
+#include <numeric>   // For std::iota
+#include <stdexcept> // For std::invalid_argument, std::length_error
+#include <type_traits>
+#include "sort_key_traits.h"
+#include "sort_stats.h"
+#include "sort_workspace.h"
 
 // Forward declaration for different sorting orders
 enum class SortOrder {
@@ -11,49 +19,331 @@ enum class SortOrder {
     Descending
 };
 
-class BitonicSort {
+// Payload carried alongside each key by sortPairs/argsort: a row index, pointer bits or
+// any 32-bit value for keys up to 32 bits, 64 bits for 64-bit keys. Payloads of the key's
+// width let the SIMD kernels move them with the same compare masks as the keys.
+template <typename T>
+using PayloadOf = typename std::conditional<sizeof(T) == 8, std::uint64_t, std::uint32_t>::type;
+
+// Runtime cutoffs of the threaded sorters (StdThread, OpenMP, and SIMD on a pool). A zero
+// field keeps the sorter's compiled-in default; getThresholds() reports the values in use.
+struct ParallelThresholds {
+    int sequential = 0;    // Subproblems of up to this many keys run on one thread
+    int compare_grain = 0; // Fewest compare-exchanges of one merge level handed to a task
+};
+
+// requested with its zero fields taken from defaults. Throws std::invalid_argument for a
+// negative field.
+inline ParallelThresholds resolveThresholds(ParallelThresholds requested, ParallelThresholds defaults) {
+    if (requested.sequential < 0 || requested.compare_grain < 0) {
+        throw std::invalid_argument("ParallelThresholds: thresholds must be non-negative");
+    }
+    if (requested.sequential == 0) requested.sequential = defaults.sequential;
+    if (requested.compare_grain == 0) requested.compare_grain = defaults.compare_grain;
+    return requested;
+}
+
+// Common interface for all sorters, parameterised on the key type. The supported key
+// types are listed in BITONIC_SORT_FOR_EACH_KEY_TYPE; BitonicSort is the int instance.
+template <typename T>
+class BasicBitonicSort {
 public:
-    virtual ~BitonicSort() = default;
+    using value_type = T;
+    using payload_type = PayloadOf<T>;
+
+    virtual ~BasicBitonicSort() = default;
+
+    // Sorts data[0, count) in place: a slice of a larger buffer, an mmap'd file or a
+    // column can be sorted without copying it into a vector. Derived classes implement
+    // this; derived classes that declare it should add `using BasicBitonicSort<T>::sort;`
+    // so the vector overload stays visible. Throws std::length_error if count exceeds
+    // INT_MAX.
+    virtual void sort(T* data, std::size_t count, SortOrder order) = 0;
+
+    void sort(std::vector<T>& arr, SortOrder order) { sort(arr.data(), arr.size(), order); }
+
+    // Sorts keys[0, count) and applies the same permutation to values[0, count). Keys that
+    // compare equal may come out in any order.
+    virtual void sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) = 0;
 
-    // Pure virtual function to be implemented by derived classes
-    virtual void sort(std::vector<int>& arr, SortOrder order) = 0;
+    // Throws std::invalid_argument if the sizes differ
+    void sortPairs(std::vector<T>& keys, std::vector<payload_type>& values, SortOrder order) {
+        checkPairSizes(keys, values);
+        sortPairs(keys.data(), values.data(), keys.size(), order);
+    }
+
+    // Sorts each segment data[offsets[s], offsets[s + 1]) for s in [0, num_segments)
+    // independently, in place; offsets holds num_segments + 1 non-decreasing entries. The
+    // default sorts the segments one by one; SIMDBitonicSorter batches equal-length
+    // segments across SIMD lanes and threads. Throws std::invalid_argument for decreasing
+    // offsets.
+    virtual void sortSegments(T* data, const std::size_t* offsets, std::size_t num_segments, SortOrder order) {
+        checkSegmentOffsets(offsets, num_segments);
+        SortStatsCall call(&stats_, SortPhase::Sort, num_segments > 0 ? offsets[num_segments] - offsets[0] : 0);
+        for (std::size_t s = 0; s < num_segments; ++s) {
+            sort(data + offsets[s], offsets[s + 1] - offsets[s], order);
+        }
+    }
+
+    // offsets.size() is the number of segments plus one; an empty offsets means no segments.
+    // Also throws std::invalid_argument if the last offset is past the end of data.
+    void sortSegments(std::vector<T>& data, const std::vector<std::size_t>& offsets, SortOrder order) {
+        if (offsets.empty()) {
+            return;
+        }
+        if (offsets.back() > data.size()) {
+            throw std::invalid_argument("sortSegments: offsets extend past the end of data");
+        }
+        sortSegments(data.data(), offsets.data(), offsets.size() - 1, order);
+    }
+
+    // Writes the k keys of data[0, count) that come first in order to out, in order, and
+    // returns how many were written: min(k, count). data is not modified. The best keys
+    // seen so far are kept sorted and bitonic-merged with each chunk of k candidates (see
+    // topKStream), so the rest of the input is never fully sorted. SIMDBitonicSorter runs
+    // the networks in SIMD and splits the input across its pool.
+    virtual std::size_t topK(const T* data, std::size_t count, std::size_t k, T* out, SortOrder order) {
+        const std::size_t n = std::min(k, count);
+        SortStatsCall call(&stats_, SortPhase::Sort, count);
+        std::copy(data, data + n, out);
+        sort(out, n, order);
+        // Not workspace_: sort() may take that, and a busy workspace lends a fresh one
+        SortWorkspace::Lease workspace(topk_workspace_);
+        topKStream(
+            data + n, count - n, out, checkedCount(n), order, workspace.get<T>(0, n),
+            [&](T* chunk, int m, SortOrder o) { sort(chunk, m, o); },
+            [&](T* best, T* chunk, int m, SortOrder o) {
+                for (int i = 0; i < m; ++i) {
+                    if (sortsBefore(chunk[i], best[i], o)) {
+                        best[i] = chunk[i];
+                    }
+                }
+            },
+            [&](T* arr, int m, SortOrder o) { bitonicMerge(arr, 0, m, o); });
+        return n;
+    }
+
+    std::vector<T> topK(const std::vector<T>& data, std::size_t k, SortOrder order) {
+        std::vector<T> out(std::min(k, data.size()));
+        topK(data.data(), data.size(), k, out.data(), order);
+        return out;
+    }
+
+    // Merges a[0, na) and b[0, nb), each sorted in order, into out[0, na + nb), which must
+    // not overlap either input. Nothing is sorted: the default copies a reversed and then b
+    // into out, a run against order followed by one along it, which bitonicMerge takes for
+    // any two lengths, and runs that one merge. The threaded sorters run their parallel
+    // merge; SIMDBitonicSorter and HybridBitonicSorter split the output with merge path and
+    // merge each piece with the mergeSorted kernel. Throws std::length_error if na + nb
+    // exceeds INT_MAX.
+    virtual void merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, SortOrder order) {
+        const int count = checkedCount(na + nb);
+        SortStatsCall call(&stats_, SortPhase::Merge, na + nb);
+        copyBitonic(a, na, b, nb, out);
+        bitonicMerge(out, 0, count, order);
+    }
+
+    // out is resized to a.size() + b.size() and must not be a or b
+    void merge(const std::vector<T>& a, const std::vector<T>& b, std::vector<T>& out, SortOrder order) {
+        out.resize(a.size() + b.size());
+        merge(a.data(), a.size(), b.data(), b.size(), out.data(), order);
+    }
+
+    // Returns the permutation that sorts keys: keys[perm[0]], keys[perm[1]], ... is in
+    // order. keys itself is left untouched.
+    std::vector<std::size_t> argsort(const std::vector<T>& keys, SortOrder order) {
+        if (keys.size() > static_cast<std::size_t>(std::numeric_limits<payload_type>::max())) {
+            throw std::length_error("argsort: more keys than payload_type can index");
+        }
+        std::vector<T> sorted_keys = keys;
+        std::vector<payload_type> indices(keys.size());
+        std::iota(indices.begin(), indices.end(), payload_type(0));
+        sortPairs(sorted_keys, indices, order);
+        return std::vector<std::size_t>(indices.begin(), indices.end());
+    }
 
     // Helper function to get the name of the sorter (optional, but useful for benchmarks/tests)
     virtual std::string getName() const = 0;
 
+    // What the calls since construction or resetStats() did: time per phase and merge
+    // stride, compare-exchange and swap counts, SIMD share and per-thread busy time. All
+    // zero unless built with BITONIC_SORT_STATS (SORT_STATS_ENABLED). Sorters that wrap
+    // others add in the work of the inner ones.
+    virtual SortStats getStats() const { return stats_.get(); }
+    virtual void resetStats() { stats_.reset(); }
+
+    // Scratch memory kept between calls for merge buffers and the like (see SortWorkspace),
+    // and releasing it. Sorters that wrap others include the inner ones. Neither may run
+    // while a call on the sorter does.
+    virtual std::size_t getWorkspaceBytes() const { return workspace_.capacity() + topk_workspace_.capacity(); }
+    virtual void releaseWorkspace() {
+        workspace_.release();
+        topk_workspace_.release();
+    }
+
 protected:
-    // Protected helper for bitonic merge part
-    void bitonicMerge(std::vector<int>& arr, int low, int count, SortOrder order) {
+    SortStatsRecorder stats_;
+    SortWorkspace workspace_;
+    // The default topK's chunk, held across the sort() calls it makes
+    SortWorkspace topk_workspace_;
+
+    // Keys plus a payload array that follows every swap. The network helpers below are
+    // templates over the storage, so sort() passes a T* and sortPairs() this.
+    struct KeyValueArrays {
+        T* keys;
+        payload_type* values;
+    };
+
+    // The networks index with int; larger inputs are rejected up front
+    static int checkedCount(std::size_t count) {
+        if (count > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+            throw std::length_error("bitonic sort: more than INT_MAX elements");
+        }
+        return static_cast<int>(count);
+    }
+
+    // The network works on any count, not just powers of two. It behaves as if the input
+    // were padded to the next power of two with values that sort last, with every
+    // comparator that touches padding skipped (such a comparator never swaps). Those
+    // virtual pads stay at the end as long as the first part is sorted against the final
+    // order and the rest along it, so the split is at splitPoint(count).
+
+    // Protected helper for bitonic merge part. arr[low, low + count) must be bitonic; when
+    // count is not a power of two, a run sorted against order followed by one sorted in order.
+    template <typename Arr>
+    void bitonicMerge(Arr& arr, int low, int count, SortOrder order) {
         if (count > 1) {
-            int k = count / 2;
-            for (int i = low; i < low + k; ++i) {
-                compareAndSwap(arr, i, i + k, order);
+            int k = splitPoint(count);
+            {
+                SortStatsStride stride(&stats_, k, count - k);
+                for (int i = low; i < low + count - k; ++i) {
+                    compareAndSwap(arr, i, i + k, order);
+                }
             }
             bitonicMerge(arr, low, k, order);
-            bitonicMerge(arr, low + k, k, order);
+            bitonicMerge(arr, low + k, count - k, order);
         }
     }
 
     // Protected helper for the recursive sort part
-    void bitonicSortRecursive(std::vector<int>& arr, int low, int count, SortOrder order) {
+    template <typename Arr>
+    void bitonicSortRecursive(Arr& arr, int low, int count, SortOrder order) {
         if (count > 1) {
-            int k = count / 2;
-            // Sort first half in ascending order
-            bitonicSortRecursive(arr, low, k, SortOrder::Ascending);
-            // Sort second half in descending order
-            bitonicSortRecursive(arr, low + k, k, SortOrder::Descending);
+            int k = splitPoint(count);
+            // Sort the first part against the final order and the rest along it
+            bitonicSortRecursive(arr, low, k, oppositeOrder(order));
+            bitonicSortRecursive(arr, low + k, count - k, order);
             // Merge the whole sequence
+            SortStatsTimer timer(count > SortStats::MIN_TIMED_KEYS ? &stats_ : nullptr, SortPhase::Merge);
             bitonicMerge(arr, low, count, order);
         }
     }
 
+    // Largest power of two below count (count >= 2); count / 2 when count is a power of two
+    static int splitPoint(int count) {
+        int k = 1;
+        while (k < count - k) {
+            k *= 2;
+        }
+        return k;
+    }
+
+    static SortOrder oppositeOrder(SortOrder order) {
+        return (order == SortOrder::Ascending) ? SortOrder::Descending : SortOrder::Ascending;
+    }
+
     // Protected helper to compare and swap elements based on order
-    void compareAndSwap(std::vector<int>& arr, int i, int j, SortOrder order) {
-        bool condition = (order == SortOrder::Ascending) ? (arr[i] > arr[j]) : (arr[i] < arr[j]);
+    void compareAndSwap(T* arr, int i, int j, SortOrder order) {
+        bool condition = (order == SortOrder::Ascending) ? SortKeyTraits<T>::less(arr[j], arr[i])
+                                                         : SortKeyTraits<T>::less(arr[i], arr[j]);
+        countScalarCompareExchange(condition);
         if (condition) {
             std::swap(arr[i], arr[j]); // Changed to std::swap
         }
     }
+
+    void compareAndSwap(const KeyValueArrays& kv, int i, int j, SortOrder order) {
+        bool condition = (order == SortOrder::Ascending) ? SortKeyTraits<T>::less(kv.keys[j], kv.keys[i])
+                                                         : SortKeyTraits<T>::less(kv.keys[i], kv.keys[j]);
+        countScalarCompareExchange(condition);
+        if (condition) {
+            std::swap(kv.keys[i], kv.keys[j]);
+            std::swap(kv.values[i], kv.values[j]);
+        }
+    }
+
+    // Lays out a and b for bitonicMerge: a reversed (against order), then b (along it)
+    void copyBitonic(const T* a, std::size_t na, const T* b, std::size_t nb, T* out) {
+        SortStatsTimer timer(&stats_, SortPhase::Copy);
+        std::reverse_copy(a, a + na, out);
+        std::copy(b, b + nb, out + na);
+    }
+
+    static bool sortsBefore(T a, T b, SortOrder order) {
+        return (order == SortOrder::Ascending) ? SortKeyTraits<T>::less(a, b) : SortKeyTraits<T>::less(b, a);
+    }
+
+    // Streams data[0, count) into best[0, n), which holds the n keys so far that come first
+    // in order, sorted in order. Keys that beat the worst of best are collected into a chunk
+    // of n; a full chunk is sorted against best's current direction and best[i] keeps the
+    // winner of best[i] and chunk[i]. Since one side rises where the other falls, the
+    // winners hold the n best keys of both and first follow order, then run against it:
+    // one bitonic merge against order sorts them again. best therefore stays sorted
+    // against order after the first round and is reversed once at the end. chunk is the
+    // caller's scratch for n keys.
+    //   sort_chunk(chunk, n, direction)            sorts the chunk
+    //   keep_winners(best, chunk, n, order)        best[i] = whichever comes first in order
+    //   merge(best, n, direction)                  bitonic merge as in bitonicMerge
+    template <typename SortChunk, typename KeepWinners, typename Merge>
+    static void topKStream(const T* data, std::size_t count, T* best, int n, SortOrder order, T* chunk,
+                           SortChunk&& sort_chunk, KeepWinners&& keep_winners, Merge&& merge) {
+        if (count == 0 || n == 0) {
+            return;
+        }
+        SortOrder best_order = order;
+        int filled = 0;
+        auto round = [&] {
+            sort_chunk(chunk, n, oppositeOrder(best_order));
+            keep_winners(best, chunk, n, order);
+            best_order = oppositeOrder(order);
+            merge(best, n, best_order);
+            filled = 0;
+        };
+        for (std::size_t i = 0; i < count; ++i) {
+            const T worst = (best_order == order) ? best[n - 1] : best[0];
+            if (sortsBefore(data[i], worst, order)) {
+                chunk[filled++] = data[i];
+                if (filled == n) {
+                    round();
+                }
+            }
+        }
+        if (filled > 0) {
+            // Pad with keys that never win
+            const T loser = (order == SortOrder::Ascending) ? SortKeyTraits<T>::highest() : SortKeyTraits<T>::lowest();
+            std::fill(chunk + filled, chunk + n, loser);
+            round();
+        }
+        if (best_order != order) {
+            std::reverse(best, best + n);
+        }
+    }
+
+    static void checkSegmentOffsets(const std::size_t* offsets, std::size_t num_segments) {
+        for (std::size_t s = 0; s < num_segments; ++s) {
+            if (offsets[s + 1] < offsets[s]) {
+                throw std::invalid_argument("sortSegments: offsets must be non-decreasing");
+            }
+        }
+    }
+
+    static void checkPairSizes(const std::vector<T>& keys, const std::vector<payload_type>& values) {
+        if (keys.size() != values.size()) {
+            throw std::invalid_argument("sortPairs: keys and values must have the same size");
+        }
+    }
 };
 
+using BitonicSort = BasicBitonicSort<int>;
+
 #endif // BITONIC_SORT_H
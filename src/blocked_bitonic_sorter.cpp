@@ -0,0 +1,254 @@
+#include "blocked_bitonic_sorter.h"
+#include "packed_pairs.h"
+#include <algorithm> // For std::min, std::max
+
+namespace {
+
+// Views the network runs on; offsets and counts are in elements
+template <typename T>
+struct KeyNetwork {
+    const SIMDKernels<T>& kernels;
+    T* keys;
+
+    int blockSize() const { return kernels.blockSize; }
+    void sortBlock(int offset, int count, SortOrder order) const {
+        kernels.sortBlock(keys + offset, count, order);
+        countKernelCompareExchanges(kernels, bitonicSortComparators(count));
+    }
+    void merge(int offset, int count, SortOrder order) const {
+        kernels.bitonicMerge(keys + offset, count, order);
+        countKernelCompareExchanges(kernels, bitonicMergeComparators(count));
+    }
+    // Elements [lo, lo + count) against [hi, hi + count)
+    void exchange(int lo, int hi, int count, SortOrder order) const {
+        kernels.compareAndSwapBlocks(keys + lo, keys + hi, count, order);
+        countKernelCompareExchanges(kernels, count);
+    }
+};
+
+template <typename T>
+struct PairNetwork {
+    const SIMDKernels<T>& kernels;
+    T* keys;
+    PayloadOf<T>* values;
+
+    int blockSize() const { return kernels.pairBlockSize; }
+    void sortBlock(int offset, int count, SortOrder order) const {
+        kernels.sortBlockPairs(keys + offset, values + offset, count, order);
+        countKernelCompareExchanges(kernels, bitonicSortComparators(count));
+    }
+    void merge(int offset, int count, SortOrder order) const {
+        kernels.bitonicMergePairs(keys + offset, values + offset, count, order);
+        countKernelCompareExchanges(kernels, bitonicMergeComparators(count));
+    }
+    void exchange(int lo, int hi, int count, SortOrder order) const {
+        kernels.compareAndSwapBlocksPairs(keys + lo, values + lo, hi - lo, count, order);
+        countKernelCompareExchanges(kernels, count);
+    }
+};
+
+// Bytes of each run a fused sweep processes at a time; with up to 2^MAX_FUSED_STRIDES runs
+// in flight the working set stays within L1
+const int FUSED_CHUNK_BYTES = 2048;
+
+// Runs strides j, j/2, ..., j >> (levels - 1) of one stage on the group [base, base + 2j)
+// in a single sweep. The group splits into 2^levels runs of s = j >> (levels - 1)
+// elements, and the strides pair run m with run m + 2^(levels-1), then m + 2^(levels-2),
+// and so on. Going through the runs a chunk at a time keeps every chunk in L1 for all
+// fused strides, so the group is read from memory once instead of levels times.
+template <typename Network>
+void fusedExchange(const Network& net, int base, int j, int levels, int chunk, SortOrder order) {
+    const int s = j >> (levels - 1);
+    const int runs = 1 << levels;
+    chunk = std::min(chunk, s);
+    for (int i = 0; i < s; i += chunk) {
+        for (int h = runs / 2; h >= 1; h /= 2) {
+            for (int m = 0; m < runs; ++m) {
+                if ((m & h) == 0) {
+                    net.exchange(base + m * s + i, base + (m + h) * s + i, chunk, order);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+template <typename T>
+BasicBlockedBitonicSorter<T>::BasicBlockedBitonicSorter(std::size_t tile_bytes, SIMDIsa isa)
+    : kernels_(&selectSIMDKernels<T>(isa)), tile_bytes_(tile_bytes) {
+}
+
+template <typename T>
+int BasicBlockedBitonicSorter<T>::tileElements(std::size_t element_bytes, int block_size) const {
+    std::size_t elements = tile_bytes_ / element_bytes;
+    int tile = block_size;
+    while (static_cast<std::size_t>(tile) * 2 <= elements && tile < (1 << 30)) {
+        tile *= 2;
+    }
+    return tile;
+}
+
+template <typename T>
+int BasicBlockedBitonicSorter<T>::fusedLevels(int j, int tile) {
+    int levels = 1;
+    while (levels < MAX_FUSED_STRIDES && (j >> levels) >= tile) {
+        ++levels;
+    }
+    return levels;
+}
+
+template <typename T>
+int BasicBlockedBitonicSorter<T>::countStreamingPasses(int count) const {
+    const int tile = getTileSize();
+    int passes = 1; // Sorting the tiles
+    for (int k = 2 * tile; k <= count; k *= 2) {
+        for (int j = k / 2; j >= tile; j >>= fusedLevels(j, tile)) {
+            ++passes;
+        }
+        ++passes; // Per-tile merges
+    }
+    return passes;
+}
+
+template <typename T>
+template <typename Network>
+void BasicBlockedBitonicSorter<T>::sortPowerOfTwo(const Network& net, int base, int count, int tile,
+                                                  SortOrder order) {
+    const int block = net.blockSize();
+    if (count <= block) {
+        net.sortBlock(base, count, order);
+        return;
+    }
+    tile = std::min(tile, count);
+
+    // A run of k elements at offset s is sorted in the final order when s & k is zero and
+    // in the opposite one otherwise, so neighbouring runs form bitonic sequences.
+    const SortOrder opposite = this->oppositeOrder(order);
+    auto direction = [&](int offset, int k) { return ((offset - base) & k) == 0 ? order : opposite; };
+
+    // Stages up to the tile size: each tile is sorted completely while it is in cache
+    for (int t = base; t < base + count; t += tile) {
+        for (int b = t; b < t + tile; b += block) {
+            net.sortBlock(b, block, direction(b, block));
+        }
+        for (int k = 2 * block; k <= tile; k *= 2) {
+            for (int s = t; s < t + tile; s += k) {
+                net.merge(s, k, direction(s, k));
+            }
+        }
+    }
+
+    // Larger stages stream the array
+    SortStatsTimer timer(&this->stats_, SortPhase::Merge);
+    for (int k = 2 * tile; k <= count; k *= 2) {
+        for (int s = base; s < base + count; s += k) {
+            mergePowerOfTwo(net, s, k, tile, direction(s, k));
+        }
+    }
+}
+
+template <typename T>
+template <typename Network>
+void BasicBlockedBitonicSorter<T>::mergePowerOfTwo(const Network& net, int base, int count, int tile,
+                                                   SortOrder order) {
+    if (count <= tile) {
+        net.merge(base, count, order);
+        return;
+    }
+    // Strides of at least a tile stream the range, up to MAX_FUSED_STRIDES of them per
+    // pass, then every tile finishes the remaining strides in cache
+    const int chunk = std::max(FUSED_CHUNK_BYTES / static_cast<int>(sizeof(T)), net.blockSize());
+    for (int j = count / 2; j >= tile;) {
+        int levels = fusedLevels(j, tile);
+        for (int group = base; group < base + count; group += 2 * j) {
+            fusedExchange(net, group, j, levels, chunk, order);
+        }
+        j >>= levels;
+    }
+    for (int t = base; t < base + count; t += tile) {
+        net.merge(t, tile, order);
+    }
+}
+
+// Arbitrary counts follow BasicBitonicSort::bitonicSortRecursive: the power-of-two first
+// part, sorted against the final order, goes through the tiled network above, and only the
+// shorter rest recurses. No element is padded, so no comparator is wasted on padding.
+template <typename T>
+template <typename Network>
+void BasicBlockedBitonicSorter<T>::runNetwork(const Network& net, int base, int count, int tile, SortOrder order) {
+    if (count <= net.blockSize() || (count & (count - 1)) == 0) {
+        sortPowerOfTwo(net, base, count, tile, order); // Partial blocks are sorted in registers
+        return;
+    }
+    const int k = this->splitPoint(count);
+    sortPowerOfTwo(net, base, k, tile, this->oppositeOrder(order));
+    runNetwork(net, base + k, count - k, tile, order);
+    SortStatsTimer timer(count > SortStats::MIN_TIMED_KEYS ? &this->stats_ : nullptr, SortPhase::Merge);
+    mergeAnyCount(net, base, count, tile, order);
+}
+
+template <typename T>
+template <typename Network>
+void BasicBlockedBitonicSorter<T>::mergeAnyCount(const Network& net, int base, int count, int tile,
+                                                 SortOrder order) {
+    if (count <= tile || (count & (count - 1)) == 0) {
+        mergePowerOfTwo(net, base, count, tile, order); // Kernel merges take any count in cache
+        return;
+    }
+    const int k = this->splitPoint(count);
+    net.exchange(base, base + k, count - k, order);
+    mergePowerOfTwo(net, base, k, tile, order);
+    mergeAnyCount(net, base + k, count - k, tile, order);
+}
+
+template <typename T>
+void BasicBlockedBitonicSorter<T>::sort(T* data, std::size_t count, SortOrder order) {
+    if (count <= 1) {
+        return;
+    }
+    SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+    KeyNetwork<T> net{*kernels_, data};
+    runNetwork(net, 0, this->checkedCount(count), tileElements(sizeof(T), kernels_->blockSize), order);
+}
+
+template <typename T>
+void BasicBlockedBitonicSorter<T>::sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) {
+    if (count <= 1) {
+        return;
+    }
+    SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+    if constexpr (sizeof(T) == 2) {
+        BasicBlockedBitonicSorter<std::int64_t> wide_sorter(tile_bytes_, kernels_->isa);
+        SortWorkspace::Lease workspace(this->workspace_);
+        sortPairsPacked(wide_sorter, keys, values, count, order, workspace.get<std::int64_t>(0, count));
+        this->stats_.add(wide_sorter.getStats(), true);
+    } else {
+        PairNetwork<T> net{*kernels_, keys, values};
+        runNetwork(net, 0, this->checkedCount(count),
+                   tileElements(sizeof(T) + sizeof(payload_type), kernels_->pairBlockSize), order);
+    }
+}
+
+template <typename T>
+void BasicBlockedBitonicSorter<T>::merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out,
+                                         SortOrder order) {
+    const int count = this->checkedCount(na + nb);
+    SortStatsCall call(&this->stats_, SortPhase::Merge, count);
+    this->copyBitonic(a, na, b, nb, out);
+    if (count <= 1) {
+        return;
+    }
+    KeyNetwork<T> net{*kernels_, out};
+    mergeAnyCount(net, 0, count, tileElements(sizeof(T), kernels_->blockSize), order);
+}
+
+template <typename T>
+std::string BasicBlockedBitonicSorter<T>::getName() const {
+    return "BlockedBitonicSorter" + keyTypeSuffix<T>() + " (" + simdIsaName(kernels_->isa) +
+           ", tile=" + std::to_string(tile_bytes_ / 1024) + "KiB)";
+}
+
+#define INSTANTIATE_BLOCKED_SORTER(T) template class BasicBlockedBitonicSorter<T>;
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_BLOCKED_SORTER)
+#undef INSTANTIATE_BLOCKED_SORTER
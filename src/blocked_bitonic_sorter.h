@@ -0,0 +1,69 @@
+#ifndef BLOCKED_BITONIC_SORTER_H
+#define BLOCKED_BITONIC_SORTER_H
+
+#include "bitonic_sort.h"
+#include <vector>
+#include <string>
+#include <cstddef>   // For std::size_t
+#include "simd_kernels.h"
+
+// Runs the bitonic network stage by stage with an explicit loop nest instead of recursion.
+// Every stage whose strides fit in a cache tile is finished for that tile before the next
+// tile is touched, so only strides of at least a tile stream the whole array through
+// memory: about log(N/tile)^2 / 2 strides instead of log(N)^2 / 2. Those strides are
+// further fused up to MAX_FUSED_STRIDES per pass. The compare-exchange loops and the
+// in-tile merges use the same SIMD kernels as SIMDBitonicSorter.
+template <typename T>
+class BasicBlockedBitonicSorter : public BasicBitonicSort<T> {
+public:
+    // 256 KiB: half of a typical per-core L2, leaving room for the other stream
+    static const std::size_t DEFAULT_TILE_BYTES = 256 * 1024;
+
+    explicit BasicBlockedBitonicSorter(std::size_t tile_bytes = DEFAULT_TILE_BYTES, SIMDIsa isa = SIMDIsa::Auto);
+    ~BasicBlockedBitonicSorter() override = default;
+
+    using payload_type = typename BasicBitonicSort<T>::payload_type;
+
+    using BasicBitonicSort<T>::sort;
+    using BasicBitonicSort<T>::sortPairs;
+    void sort(T* data, std::size_t count, SortOrder order) override;
+    void sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) override;
+    // The single bitonic merge of the default, run through the tiled merge stages
+    using BasicBitonicSort<T>::merge;
+    void merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, SortOrder order) override;
+    std::string getName() const override;
+
+    SIMDIsa getIsa() const { return kernels_->isa; }
+    std::size_t getTileBytes() const { return tile_bytes_; }
+    // Keys per tile in sort(): a power of two, at least one register block
+    int getTileSize() const { return tileElements(sizeof(T), kernels_->blockSize); }
+    // Full-array passes sort() makes over count keys (a power of two); lets benchmarks
+    // relate time to memory traffic
+    int countStreamingPasses(int count) const;
+
+    // Strides of at least a tile handled by one sweep over the array
+    static const int MAX_FUSED_STRIDES = 3;
+
+private:
+    const SIMDKernels<T>* kernels_;
+    std::size_t tile_bytes_;
+
+    int tileElements(std::size_t element_bytes, int block_size) const;
+    static int fusedLevels(int j, int tile);
+
+    // Network is a key or key/value view over the array (see the .cpp). runNetwork sorts
+    // [base, base + count) for any count; the PowerOfTwo stages need count a power of two
+    // (or, for sortPowerOfTwo, at most one register block).
+    template <typename Network>
+    void runNetwork(const Network& net, int base, int count, int tile, SortOrder order);
+    template <typename Network>
+    void mergeAnyCount(const Network& net, int base, int count, int tile, SortOrder order);
+    template <typename Network>
+    void sortPowerOfTwo(const Network& net, int base, int count, int tile, SortOrder order);
+    template <typename Network>
+    void mergePowerOfTwo(const Network& net, int base, int count, int tile, SortOrder order);
+};
+
+using BlockedBitonicSorter = BasicBlockedBitonicSorter<int>;
+
+#endif // BLOCKED_BITONIC_SORTER_H
@@ -0,0 +1,147 @@
+#include "cpu_features.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>   // For __cpuid, __cpuidex
+#include <immintrin.h> // For _xgetbv
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>    // For __get_cpuid_max, __cpuid_count
+#endif
+#if defined(__linux__)
+#include <unistd.h>   // For sysconf
+#endif
+
+namespace {
+
+struct CpuFeatureFlags {
+    bool sse41 = false;
+    bool avx2 = false;
+    bool avx512 = false;
+};
+
+CpuFeatureFlags queryCpuFeatures() {
+    CpuFeatureFlags flags;
+#if defined(__GNUC__) || defined(__clang__)
+    // libgcc/compiler-rt also check XCR0, so AVX/AVX-512 are only reported when the OS saves the registers.
+    __builtin_cpu_init();
+    flags.sse41 = __builtin_cpu_supports("sse4.1");
+    flags.avx2 = __builtin_cpu_supports("avx2");
+    flags.avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#elif defined(_MSC_VER)
+    int regs[4] = {0, 0, 0, 0};
+    __cpuid(regs, 0);
+    int max_leaf = regs[0];
+
+    __cpuid(regs, 1);
+    flags.sse41 = (regs[2] & (1 << 19)) != 0;
+    bool osxsave = (regs[2] & (1 << 27)) != 0;
+    unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    bool os_avx = (xcr0 & 0x6) == 0x6;       // XMM and YMM state
+    bool os_avx512 = (xcr0 & 0xE6) == 0xE6;  // plus opmask and ZMM state
+
+    if (max_leaf >= 7) {
+        __cpuidex(regs, 7, 0);
+        flags.avx2 = os_avx && (regs[1] & (1 << 5)) != 0;
+        flags.avx512 = os_avx512 && (regs[1] & (1 << 16)) != 0 && (regs[1] & (1 << 30)) != 0;
+    }
+#endif
+    return flags;
+}
+
+// Largest data or unified cache described by CPUID leaf 4 (deterministic cache parameters)
+std::size_t queryCpuidCacheBytes() {
+    std::size_t largest = 0;
+    unsigned int regs[4] = {0, 0, 0, 0}; // EAX, EBX, ECX, EDX
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 4) {
+        return 0;
+    }
+#elif defined(__x86_64__) || defined(__i386__)
+    if (__get_cpuid_max(0, nullptr) < 4) {
+        return 0;
+    }
+#else
+    return 0;
+#endif
+    for (unsigned int index = 0; index < 16; ++index) {
+#if defined(_MSC_VER)
+        __cpuidex(info, 4, static_cast<int>(index));
+        for (int r = 0; r < 4; ++r) regs[r] = static_cast<unsigned int>(info[r]);
+#elif defined(__x86_64__) || defined(__i386__)
+        __cpuid_count(4, index, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        const unsigned int type = regs[0] & 0x1F; // 0: no more caches, 2: instruction
+        if (type == 0) {
+            break;
+        }
+        if (type == 2) {
+            continue;
+        }
+        const std::size_t ways = ((regs[1] >> 22) & 0x3FF) + 1;
+        const std::size_t partitions = ((regs[1] >> 12) & 0x3FF) + 1;
+        const std::size_t line = (regs[1] & 0xFFF) + 1;
+        const std::size_t sets = static_cast<std::size_t>(regs[2]) + 1;
+        const std::size_t bytes = ways * partitions * line * sets;
+        largest = bytes > largest ? bytes : largest;
+    }
+    return largest;
+}
+
+std::size_t queryLastLevelCacheBytes() {
+#if defined(__linux__) && defined(_SC_LEVEL3_CACHE_SIZE)
+    // glibc knows AMD's cache leaves too
+    for (int name : {_SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE}) {
+        const long bytes = sysconf(name);
+        if (bytes > 0) {
+            return static_cast<std::size_t>(bytes);
+        }
+    }
+#endif
+    return queryCpuidCacheBytes();
+}
+
+const CpuFeatureFlags& cpuFeatures() {
+    static const CpuFeatureFlags flags = queryCpuFeatures();
+    return flags;
+}
+
+} // namespace
+
+bool cpuSupports(SIMDIsa isa) {
+    switch (isa) {
+        case SIMDIsa::Auto:
+        case SIMDIsa::Scalar:
+            return true;
+        case SIMDIsa::SSE41:
+            return cpuFeatures().sse41;
+        case SIMDIsa::AVX2:
+            return cpuFeatures().avx2;
+        case SIMDIsa::AVX512:
+            return cpuFeatures().avx512;
+    }
+    return false;
+}
+
+SIMDIsa detectBestSIMDIsa() {
+    if (cpuSupports(SIMDIsa::AVX512)) return SIMDIsa::AVX512;
+    if (cpuSupports(SIMDIsa::AVX2)) return SIMDIsa::AVX2;
+    if (cpuSupports(SIMDIsa::SSE41)) return SIMDIsa::SSE41;
+    return SIMDIsa::Scalar;
+}
+
+std::string simdIsaName(SIMDIsa isa) {
+    switch (isa) {
+        case SIMDIsa::Auto:   return "Auto";
+        case SIMDIsa::Scalar: return "Scalar";
+        case SIMDIsa::SSE41:  return "SSE4.1";
+        case SIMDIsa::AVX2:   return "AVX2";
+        case SIMDIsa::AVX512: return "AVX-512";
+    }
+    return "Unknown";
+}
+
+std::size_t lastLevelCacheBytes() {
+    static const std::size_t bytes = queryLastLevelCacheBytes();
+    return bytes;
+}
@@ -0,0 +1,27 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <cstddef> // For std::size_t
+#include <string>
+
+// Instruction sets the SIMD kernels are compiled for, in increasing order of width.
+enum class SIMDIsa {
+    Auto,    // Pick the widest ISA supported by the running CPU
+    Scalar,  // No usable SIMD extension; plain C++ fallback
+    SSE41,   // 128-bit, 4 x int32
+    AVX2,    // 256-bit, 8 x int32
+    AVX512   // 512-bit, 16 x int32 (AVX-512F + BW)
+};
+
+// Queries CPUID (and XGETBV for OS register-state support) once and caches the result.
+bool cpuSupports(SIMDIsa isa);
+
+// Widest ISA that is both compiled in and supported by the running CPU.
+SIMDIsa detectBestSIMDIsa();
+
+std::string simdIsaName(SIMDIsa isa);
+
+// Size in bytes of the largest data cache, from the OS or CPUID leaf 4; 0 when unknown
+std::size_t lastLevelCacheBytes();
+
+#endif // CPU_FEATURES_H
@@ -0,0 +1,141 @@
+#include "dispatch_sorter.h"
+#include "plain_bitonic_sorter.h"
+#include "std_thread_bitonic_sorter.h"
+#include "openmp_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include "blocked_bitonic_sorter.h"
+#include "hybrid_bitonic_sorter.h"
+#include "work_stealing_thread_pool.h"
+#include <fstream>
+
+template <typename T>
+std::unique_ptr<BasicBitonicSort<T>> makeProfiledSorter(const SortProfileEntry& entry, SIMDIsa isa) {
+    switch (entry.backend) {
+        case SortBackend::Plain:
+            return std::make_unique<BasicPlainBitonicSorter<T>>();
+        case SortBackend::StdThread: {
+            auto sorter = std::make_unique<BasicStdThreadBitonicSorter<T>>(WorkStealingThreadPool::shared());
+            sorter->setThresholds(entry.thresholds);
+            return sorter;
+        }
+        case SortBackend::OpenMP: {
+            auto sorter = std::make_unique<BasicOpenMPBitonicSorter<T>>();
+            sorter->setThresholds(entry.thresholds);
+            return sorter;
+        }
+        case SortBackend::SIMD: {
+            auto sorter = std::make_unique<BasicSIMDBitonicSorter<T>>(isa, WorkStealingThreadPool::shared());
+            sorter->setThresholds(entry.thresholds);
+            return sorter;
+        }
+        case SortBackend::Blocked:
+            return std::make_unique<BasicBlockedBitonicSorter<T>>(
+                entry.block_bytes ? entry.block_bytes : std::size_t(BasicBlockedBitonicSorter<T>::DEFAULT_TILE_BYTES), isa);
+        case SortBackend::Hybrid:
+            return std::make_unique<BasicHybridBitonicSorter<T>>(
+                isa, WorkStealingThreadPool::shared(),
+                entry.block_bytes ? entry.block_bytes : std::size_t(BasicHybridBitonicSorter<T>::DEFAULT_BLOCK_BYTES));
+    }
+    throw std::invalid_argument("makeProfiledSorter: unknown backend");
+}
+
+namespace {
+
+SortProfile loadDefaultProfile() {
+    const std::string path = SortProfile::defaultPath();
+    return std::ifstream(path) ? SortProfile::load(path) : SortProfile::defaults();
+}
+
+} // namespace
+
+template <typename T>
+BasicDispatchSorter<T>::BasicDispatchSorter() : BasicDispatchSorter(loadDefaultProfile()) {
+}
+
+template <typename T>
+BasicDispatchSorter<T>::BasicDispatchSorter(SortProfile profile) : profile_(std::move(profile)) {
+    if (profile_.entries.empty()) {
+        profile_ = SortProfile::defaults();
+    }
+    for (const SortProfileEntry& entry : profile_.entries) {
+        sorters_.push_back(makeProfiledSorter<T>(entry, profile_.isa));
+    }
+}
+
+template <typename T>
+BasicBitonicSort<T>& BasicDispatchSorter<T>::sorterFor(std::size_t count) {
+    for (std::size_t i = 0; i + 1 < sorters_.size(); ++i) {
+        if (count <= profile_.entries[i].max_count) {
+            return *sorters_[i];
+        }
+    }
+    return *sorters_.back();
+}
+
+template <typename T>
+void BasicDispatchSorter<T>::sort(T* data, std::size_t count, SortOrder order) {
+    sorterFor(count).sort(data, count, order);
+}
+
+template <typename T>
+void BasicDispatchSorter<T>::sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) {
+    sorterFor(count).sortPairs(keys, values, count, order);
+}
+
+template <typename T>
+void BasicDispatchSorter<T>::merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, SortOrder order) {
+    sorterFor(na + nb).merge(a, na, b, nb, out, order);
+}
+
+template <typename T>
+std::size_t BasicDispatchSorter<T>::topK(const T* data, std::size_t count, std::size_t k, T* out, SortOrder order) {
+    return sorterFor(count).topK(data, count, k, out, order);
+}
+
+template <typename T>
+SortStats BasicDispatchSorter<T>::getStats() const {
+    SortStats stats = this->stats_.get();
+    for (const auto& sorter : sorters_) {
+        stats.add(sorter->getStats());
+    }
+    return stats;
+}
+
+template <typename T>
+void BasicDispatchSorter<T>::resetStats() {
+    this->stats_.reset();
+    for (const auto& sorter : sorters_) {
+        sorter->resetStats();
+    }
+}
+
+template <typename T>
+std::size_t BasicDispatchSorter<T>::getWorkspaceBytes() const {
+    std::size_t bytes = 0;
+    for (const auto& sorter : sorters_) {
+        bytes += sorter->getWorkspaceBytes();
+    }
+    return bytes;
+}
+
+template <typename T>
+void BasicDispatchSorter<T>::releaseWorkspace() {
+    for (const auto& sorter : sorters_) {
+        sorter->releaseWorkspace();
+    }
+}
+
+template <typename T>
+std::string BasicDispatchSorter<T>::getName() const {
+    std::string routes;
+    for (std::size_t i = 0; i < sorters_.size(); ++i) {
+        routes += (i ? ", " : "") + sorters_[i]->getName();
+    }
+    return "DispatchSorter" + keyTypeSuffix<T>() + " (" + routes + ")";
+}
+
+#define INSTANTIATE_DISPATCH_SORTER(T)                                                                     \
+    template class BasicDispatchSorter<T>;                                                                 \
+    template std::unique_ptr<BasicBitonicSort<T>> makeProfiledSorter<T>(const SortProfileEntry&, SIMDIsa);
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_DISPATCH_SORTER)
+#undef INSTANTIATE_DISPATCH_SORTER
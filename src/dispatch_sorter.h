@@ -0,0 +1,57 @@
+#ifndef DISPATCH_SORTER_H
+#define DISPATCH_SORTER_H
+
+#include "bitonic_sort.h"
+#include <string>
+#include <cstddef>   // For std::size_t
+#include <memory>    // For std::unique_ptr
+#include <vector>
+#include "sort_profile.h"
+
+// The sorter entry describes, with its thresholds and block size; the threaded backends run
+// on WorkStealingThreadPool::shared(). isa applies to the SIMD, Blocked and Hybrid backends.
+template <typename T>
+std::unique_ptr<BasicBitonicSort<T>> makeProfiledSorter(const SortProfileEntry& entry, SIMDIsa isa = SIMDIsa::Auto);
+
+// Routes every call to the sorter that a SortProfile (written by the autotune tool) found
+// fastest for its input size on this host. One sorter per profile entry is built up front,
+// so a call costs a search of the few entries and one virtual call.
+template <typename T>
+class BasicDispatchSorter : public BasicBitonicSort<T> {
+public:
+    // Loads SortProfile::defaultPath() when that file exists, else uses SortProfile::defaults().
+    // Throws std::runtime_error for a profile file that does not parse.
+    BasicDispatchSorter();
+    explicit BasicDispatchSorter(SortProfile profile);
+    ~BasicDispatchSorter() override = default;
+
+    using payload_type = typename BasicBitonicSort<T>::payload_type;
+
+    using BasicBitonicSort<T>::sort;
+    using BasicBitonicSort<T>::sortPairs;
+    void sort(T* data, std::size_t count, SortOrder order) override;
+    void sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) override;
+    // Routed by na + nb
+    using BasicBitonicSort<T>::merge;
+    void merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, SortOrder order) override;
+    using BasicBitonicSort<T>::topK;
+    std::size_t topK(const T* data, std::size_t count, std::size_t k, T* out, SortOrder order) override;
+    std::string getName() const override;
+    // The routed sorters' stats added up
+    SortStats getStats() const override;
+    void resetStats() override;
+    std::size_t getWorkspaceBytes() const override;
+    void releaseWorkspace() override;
+
+    const SortProfile& getProfile() const { return profile_; }
+    // Where a call on count keys goes
+    BasicBitonicSort<T>& sorterFor(std::size_t count);
+
+private:
+    SortProfile profile_;
+    std::vector<std::unique_ptr<BasicBitonicSort<T>>> sorters_; // One per profile entry
+};
+
+using DispatchSorter = BasicDispatchSorter<int>;
+
+#endif // DISPATCH_SORTER_H
@@ -0,0 +1,504 @@
+#include "external_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include <algorithm> // For std::min, std::max, std::reverse_copy
+#include <atomic>
+#include <chrono>
+#include <cstdio>    // For std::FILE, std::fopen, std::fread, std::fwrite
+#include <cstring>   // For std::memcpy
+#include <filesystem>
+#include <future>    // For std::async, std::future
+#include <limits>    // For std::numeric_limits
+#include <stdexcept> // For std::runtime_error, std::invalid_argument
+
+namespace {
+
+struct FileCloser {
+    void operator()(std::FILE* file) const { std::fclose(file); }
+};
+using File = std::unique_ptr<std::FILE, FileCloser>;
+
+File openFile(const std::string& path, const char* mode) {
+    File file(std::fopen(path.c_str(), mode));
+    if (!file) {
+        throw std::runtime_error("external sort: cannot open " + path);
+    }
+    return file;
+}
+
+// Reads up to count keys; fewer only at the end of the file
+template <typename T>
+std::size_t readKeys(std::FILE* file, T* keys, std::size_t count) {
+    std::size_t got = std::fread(keys, sizeof(T), count, file);
+    if (got < count && std::ferror(file)) {
+        throw std::runtime_error("external sort: read failed");
+    }
+    return got;
+}
+
+template <typename T>
+void writeKeys(std::FILE* file, const T* keys, std::size_t count) {
+    if (std::fwrite(keys, sizeof(T), count, file) != count) {
+        throw std::runtime_error("external sort: write failed");
+    }
+}
+
+void closeFile(File& file) {
+    if (std::fclose(file.release()) != 0) {
+        throw std::runtime_error("external sort: close failed");
+    }
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Sorted runs and intermediate merge outputs; removed on every exit path
+struct TempFiles {
+    std::string prefix;
+    std::vector<std::string> paths;
+
+    explicit TempFiles(const std::string& directory) {
+        static std::atomic<unsigned> sequence{0};
+        std::filesystem::path dir = directory.empty() ? std::filesystem::temp_directory_path()
+                                                      : std::filesystem::path(directory);
+        prefix = (dir / ("bitonic_external_" +
+                         std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_" +
+                         std::to_string(sequence++) + "_")).string();
+    }
+    ~TempFiles() {
+        for (const std::string& path : paths) {
+            std::error_code ignored;
+            std::filesystem::remove(path, ignored);
+        }
+    }
+    std::string create() {
+        paths.push_back(prefix + std::to_string(paths.size()) + ".run");
+        return paths.back();
+    }
+};
+
+template <typename T>
+class KeyStream {
+public:
+    virtual ~KeyStream() = default;
+    // Copies up to count keys to out; fewer only at the end of the stream
+    virtual std::size_t read(T* out, std::size_t count) = 0;
+};
+
+// Reads a sorted run through two buffers: the next one is filled on a background thread
+// while the current one is consumed
+template <typename T>
+class RunReader : public KeyStream<T> {
+public:
+    RunReader(const std::string& path, std::size_t buffer_keys)
+        : file_(openFile(path, "rb")), current_(buffer_keys), next_(buffer_keys) {
+        size_ = readKeys(file_.get(), current_.data(), current_.size());
+        prefetch();
+    }
+    ~RunReader() override {
+        if (pending_.valid()) {
+            pending_.wait();
+        }
+    }
+
+    std::size_t read(T* out, std::size_t count) override {
+        std::size_t done = 0;
+        while (done < count) {
+            if (pos_ == size_) {
+                if (!pending_.valid()) {
+                    break;
+                }
+                size_ = pending_.get();
+                pos_ = 0;
+                current_.swap(next_);
+                prefetch();
+                if (size_ == 0) {
+                    break;
+                }
+            }
+            std::size_t take = std::min(count - done, size_ - pos_);
+            std::memcpy(out + done, current_.data() + pos_, take * sizeof(T));
+            pos_ += take;
+            done += take;
+        }
+        return done;
+    }
+
+private:
+    File file_;
+    std::vector<T> current_;
+    std::vector<T> next_;
+    std::size_t pos_ = 0;
+    std::size_t size_ = 0;
+    std::future<std::size_t> pending_;
+
+    void prefetch() {
+        if (size_ == current_.size()) { // A short read means the file has ended
+            pending_ = std::async(std::launch::async,
+                                  [this] { return readKeys(file_.get(), next_.data(), next_.size()); });
+        }
+    }
+};
+
+// Writes through two buffers: a full buffer is written on a background thread while the
+// other one fills
+template <typename T>
+class RunWriter {
+public:
+    RunWriter(const std::string& path, std::size_t buffer_keys)
+        : file_(openFile(path, "wb")), current_(buffer_keys), flushing_(buffer_keys) {
+    }
+    ~RunWriter() {
+        if (pending_.valid()) {
+            pending_.wait();
+        }
+    }
+
+    // Writes everything stream produces, then closes the file
+    void drain(KeyStream<T>& stream) {
+        for (;;) {
+            std::size_t room = current_.size() - size_;
+            std::size_t got = stream.read(current_.data() + size_, room);
+            size_ += got;
+            if (size_ == current_.size()) {
+                flush();
+            }
+            if (got < room) {
+                break;
+            }
+        }
+        flush();
+        if (pending_.valid()) {
+            pending_.get();
+        }
+        closeFile(file_);
+    }
+
+private:
+    File file_;
+    std::vector<T> current_;
+    std::vector<T> flushing_;
+    std::size_t size_ = 0;
+    std::future<void> pending_;
+
+    void flush() {
+        if (pending_.valid()) {
+            pending_.get();
+        }
+        current_.swap(flushing_);
+        std::size_t count = size_;
+        size_ = 0;
+        if (count > 0) {
+            pending_ = std::async(std::launch::async,
+                                  [this, count] { writeKeys(file_.get(), flushing_.data(), count); });
+        }
+    }
+};
+
+// 2-way merge of two sorted streams, half a register block at a time. carry holds the
+// half-block of largest keys left over from the previous step; the next half-block comes
+// from the input with the smaller head. Reversing the carry makes the pair bitonic, and one
+// in-register bitonic merge yields the next half-block of output plus the new carry.
+// Every key emitted is then no larger than any key not yet read: only the half-block just
+// taken can hold keys past the other input's head. Once an input has fewer than half a
+// block left, the remaining keys are finished with a scalar merge.
+template <typename T>
+class MergeNode : public KeyStream<T> {
+public:
+    MergeNode(const SIMDKernels<T>& kernels, SortOrder order, std::unique_ptr<KeyStream<T>> a,
+              std::unique_ptr<KeyStream<T>> b, std::size_t buffer_keys)
+        : kernels_(kernels), order_(order), half_(std::max(kernels.blockSize / 2, 1)),
+          scratch_(2 * static_cast<std::size_t>(half_)) {
+        buffer_keys = std::max(buffer_keys, scratch_.size());
+        inputs_[0].stream = std::move(a);
+        inputs_[0].buffer.resize(buffer_keys);
+        inputs_[1].stream = std::move(b);
+        inputs_[1].buffer.resize(buffer_keys);
+    }
+
+    std::size_t read(T* out, std::size_t count) override {
+        std::size_t done = 0;
+        while (done < count) {
+            if (ready_pos_ < ready_size_) {
+                std::size_t take = std::min(count - done, ready_size_ - ready_pos_);
+                std::memcpy(out + done, scratch_.data() + ready_pos_, take * sizeof(T));
+                ready_pos_ += take;
+                done += take;
+            } else if (tail_) {
+                return done + readTail(out + done, count - done);
+            } else {
+                mergeStep();
+            }
+        }
+        return done;
+    }
+
+private:
+    struct Input {
+        std::unique_ptr<KeyStream<T>> stream;
+        std::vector<T> buffer;
+        std::size_t pos = 0;
+        std::size_t size = 0;
+        bool ended = false;
+
+        std::size_t available() const { return size - pos; }
+        const T* head() const { return buffer.data() + pos; }
+
+        // Tops the buffer up so that at least want keys are available unless the stream ends
+        void fill(std::size_t want) {
+            if (available() >= want || ended) {
+                return;
+            }
+            std::memmove(buffer.data(), head(), available() * sizeof(T));
+            size = available();
+            pos = 0;
+            std::size_t room = buffer.size() - size;
+            std::size_t got = stream->read(buffer.data() + size, room);
+            ended = got < room;
+            size += got;
+        }
+
+        std::size_t take(T* out, std::size_t count) {
+            std::size_t done = std::min(count, available());
+            std::memcpy(out, head(), done * sizeof(T));
+            pos += done;
+            if (done < count && !ended) {
+                done += stream->read(out + done, count - done);
+            }
+            return done;
+        }
+    };
+
+    const SIMDKernels<T>& kernels_;
+    SortOrder order_;
+    int half_;
+    Input inputs_[2];
+    // scratch_[0, half_) is the output of the last step, scratch_[half_, 2 * half_) the carry
+    std::vector<T> scratch_;
+    std::size_t ready_pos_ = 0;
+    std::size_t ready_size_ = 0;
+    bool has_carry_ = false;
+    bool tail_ = false;
+    std::vector<T> tail_keys_; // Carry merged with the shorter input's last keys
+    std::size_t tail_pos_ = 0;
+    int rest_ = 0;             // The input merged with tail_keys_
+
+    bool before(T a, T b) const {
+        return order_ == SortOrder::Ascending ? SortKeyTraits<T>::less(a, b) : SortKeyTraits<T>::less(b, a);
+    }
+
+    void mergeStep() {
+        const std::size_t half = static_cast<std::size_t>(half_);
+        inputs_[0].fill(half);
+        inputs_[1].fill(half);
+        for (int i = 0; i < 2; ++i) {
+            if (inputs_[i].available() < half) {
+                startTail(i);
+                return;
+            }
+        }
+        Input& next = inputs_[before(*inputs_[1].head(), *inputs_[0].head()) ? 1 : 0];
+        T* carry = scratch_.data() + half;
+        if (!has_carry_) {
+            std::memcpy(carry, next.head(), half * sizeof(T));
+            next.pos += half;
+            has_carry_ = true;
+            return;
+        }
+        std::reverse_copy(carry, carry + half, scratch_.data());
+        std::memcpy(carry, next.head(), half * sizeof(T));
+        next.pos += half;
+        kernels_.bitonicMerge(scratch_.data(), half_ * 2, order_);
+        ready_pos_ = 0;
+        ready_size_ = half;
+    }
+
+    // Input shorter has ended with fewer than half a block left
+    void startTail(int shorter) {
+        const std::size_t half = static_cast<std::size_t>(half_);
+        Input& in = inputs_[shorter];
+        const std::size_t carried = has_carry_ ? half : 0;
+        tail_keys_.resize(carried + in.available());
+        std::reverse_copy(scratch_.data() + half, scratch_.data() + half + carried, tail_keys_.data());
+        std::memcpy(tail_keys_.data() + carried, in.head(), in.available() * sizeof(T));
+        in.pos = in.size;
+        if (carried > 0) {
+            kernels_.bitonicMerge(tail_keys_.data(), static_cast<int>(tail_keys_.size()), order_);
+        }
+        rest_ = 1 - shorter;
+        tail_ = true;
+    }
+
+    std::size_t readTail(T* out, std::size_t count) {
+        Input& rest = inputs_[rest_];
+        std::size_t done = 0;
+        while (done < count && tail_pos_ < tail_keys_.size()) {
+            rest.fill(1);
+            if (rest.available() > 0 && before(*rest.head(), tail_keys_[tail_pos_])) {
+                out[done++] = *rest.head();
+                ++rest.pos;
+            } else {
+                out[done++] = tail_keys_[tail_pos_++];
+            }
+        }
+        return done + rest.take(out + done, count - done);
+    }
+};
+
+} // namespace
+
+template <typename T>
+BasicExternalSorter<T>::BasicExternalSorter(ExternalSortOptions options,
+                                            std::shared_ptr<BasicBitonicSort<T>> run_sorter)
+    : options_(std::move(options)), run_sorter_(std::move(run_sorter)),
+      kernels_(&selectSIMDKernels<T>(options_.isa)) {
+    if (!run_sorter_) {
+        run_sorter_ = std::make_shared<BasicSIMDBitonicSorter<T>>(options_.isa, WorkStealingThreadPool::shared());
+    }
+    if (options_.max_merge_fan_in < 2) {
+        throw std::invalid_argument("external sort: max_merge_fan_in must be at least 2");
+    }
+}
+
+template <typename T>
+std::size_t BasicExternalSorter<T>::getRunSize() const {
+    std::size_t keys = options_.memory_budget_bytes / 2 / sizeof(T);
+    return std::max<std::size_t>(1, std::min<std::size_t>(keys, std::numeric_limits<int>::max()));
+}
+
+template <typename T>
+ExternalSortStats BasicExternalSorter<T>::sortFile(const std::string& input_path, const std::string& output_path,
+                                                   SortOrder order) {
+    const auto start = std::chrono::steady_clock::now();
+    ExternalSortStats stats;
+    stats.bytes = std::filesystem::file_size(input_path);
+    if (stats.bytes % sizeof(T) != 0) {
+        throw std::invalid_argument("external sort: file size is not a multiple of the key size");
+    }
+    const std::size_t total_keys = static_cast<std::size_t>(stats.bytes / sizeof(T));
+    const std::size_t run_keys = getRunSize();
+
+    if (total_keys <= run_keys) {
+        std::vector<T> keys(total_keys);
+        File in = openFile(input_path, "rb");
+        if (readKeys(in.get(), keys.data(), total_keys) != total_keys) {
+            throw std::runtime_error("external sort: " + input_path + " ended early");
+        }
+        in.reset();
+        run_sorter_->sort(keys.data(), keys.size(), order);
+        File out = openFile(output_path, "wb");
+        writeKeys(out.get(), keys.data(), keys.size());
+        closeFile(out);
+        stats.runs = 1;
+        stats.run_seconds = secondsSince(start);
+        stats.total_seconds = stats.run_seconds;
+        return stats;
+    }
+
+    // Run formation. While one buffer is sorted, a background thread writes the previously
+    // sorted run from the other buffer and then reads the next run into it.
+    TempFiles temp(options_.temp_directory);
+    std::vector<std::string> runs;
+    {
+        std::vector<T> buffers[2] = {std::vector<T>(run_keys), std::vector<T>(run_keys)};
+        File in = openFile(input_path, "rb");
+        auto write_run = [&](const T* keys, std::size_t count) {
+            File out = openFile(temp.create(), "wb");
+            writeKeys(out.get(), keys, count);
+            closeFile(out);
+            runs.push_back(temp.paths.back());
+        };
+        std::size_t count = readKeys(in.get(), buffers[0].data(), run_keys);
+        std::size_t previous = 0; // Keys of the sorted run waiting in the other buffer
+        int current = 0;
+        while (count > 0) {
+            T* other = buffers[1 - current].data();
+            std::future<std::size_t> io = std::async(std::launch::async, [&, other, previous] {
+                if (previous > 0) {
+                    write_run(other, previous);
+                }
+                return readKeys(in.get(), other, run_keys);
+            });
+            run_sorter_->sort(buffers[current].data(), count, order);
+            previous = count;
+            count = io.get();
+            current = 1 - current;
+        }
+        write_run(buffers[1 - current].data(), previous);
+    }
+    stats.runs = runs.size();
+    stats.run_seconds = secondsSince(start);
+
+    const auto merge_start = std::chrono::steady_clock::now();
+    stats.merge_passes = mergeRuns(std::move(runs), output_path, order, [&] { return temp.create(); });
+    stats.merge_seconds = secondsSince(merge_start);
+    stats.total_seconds = secondsSince(start);
+    return stats;
+}
+
+template <typename T>
+int BasicExternalSorter<T>::mergeFanIn() const {
+    // Every run reader and the writer keep two buffers of at least MIN_IO_BUFFER_BYTES
+    std::size_t streams = options_.memory_budget_bytes / (2 * MIN_IO_BUFFER_BYTES);
+    std::size_t fan_in = std::min<std::size_t>(options_.max_merge_fan_in, streams > 1 ? streams - 1 : 1);
+    return static_cast<int>(std::max<std::size_t>(fan_in, 2));
+}
+
+template <typename T>
+int BasicExternalSorter<T>::mergeRuns(std::vector<std::string> inputs, const std::string& output, SortOrder order,
+                                      const std::function<std::string()>& create_temp) {
+    const std::size_t fan_in = static_cast<std::size_t>(mergeFanIn());
+    int passes = 1;
+    for (; inputs.size() > fan_in; ++passes) {
+        std::vector<std::string> merged;
+        for (std::size_t first = 0; first < inputs.size(); first += fan_in) {
+            std::vector<std::string> group(inputs.begin() + first,
+                                           inputs.begin() + std::min(first + fan_in, inputs.size()));
+            if (group.size() == 1) {
+                merged.push_back(group[0]);
+                continue;
+            }
+            merged.push_back(create_temp());
+            mergeOnePass(group, merged.back(), order);
+            for (const std::string& path : group) {
+                std::error_code ignored;
+                std::filesystem::remove(path, ignored); // Frees the disk space early
+            }
+        }
+        inputs = std::move(merged);
+    }
+    mergeOnePass(inputs, output, order);
+    return passes;
+}
+
+template <typename T>
+void BasicExternalSorter<T>::mergeOnePass(const std::vector<std::string>& inputs, const std::string& output,
+                                          SortOrder order) {
+    // Two buffers for every reader and for the writer
+    const std::size_t io_keys =
+        std::max(MIN_IO_BUFFER_BYTES, options_.memory_budget_bytes / (2 * (inputs.size() + 1))) / sizeof(T);
+    const std::size_t node_keys = NODE_BUFFER_BYTES / sizeof(T);
+
+    // Balanced binary tree of MergeNodes over the runs
+    std::function<std::unique_ptr<KeyStream<T>>(std::size_t, std::size_t)> build =
+        [&](std::size_t first, std::size_t last) -> std::unique_ptr<KeyStream<T>> {
+        if (last - first == 1) {
+            return std::make_unique<RunReader<T>>(inputs[first], io_keys);
+        }
+        std::size_t middle = first + (last - first) / 2;
+        return std::make_unique<MergeNode<T>>(*kernels_, order, build(first, middle), build(middle, last), node_keys);
+    };
+    std::unique_ptr<KeyStream<T>> root = build(0, inputs.size());
+    RunWriter<T> writer(output, io_keys);
+    writer.drain(*root);
+}
+
+template <typename T>
+std::string BasicExternalSorter<T>::getName() const {
+    return "ExternalSorter" + keyTypeSuffix<T>() + " (" + run_sorter_->getName() +
+           ", budget=" + std::to_string(options_.memory_budget_bytes >> 20) + "MiB)";
+}
+
+#define INSTANTIATE_EXTERNAL_SORTER(T) template class BasicExternalSorter<T>;
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_EXTERNAL_SORTER)
+#undef INSTANTIATE_EXTERNAL_SORTER
@@ -0,0 +1,86 @@
+#ifndef EXTERNAL_SORTER_H
+#define EXTERNAL_SORTER_H
+
+#include "bitonic_sort.h"
+#include <cstddef>   // For std::size_t
+#include <cstdint>
+#include <functional> // For std::function
+#include <memory>    // For std::shared_ptr
+#include <string>
+#include <vector>
+#include "simd_kernels.h"
+
+// Limits for BasicExternalSorter. memory_budget_bytes bounds the key buffers of both
+// phases; it does not count the in-memory sorter's own stack or the pool's threads.
+struct ExternalSortOptions {
+    std::size_t memory_budget_bytes = std::size_t(1) << 30;
+    // Where the sorted runs go; empty means std::filesystem::temp_directory_path()
+    std::string temp_directory;
+    // Runs merged by one pass. More runs than this take extra passes over intermediate files.
+    int max_merge_fan_in = 64;
+    SIMDIsa isa = SIMDIsa::Auto;
+};
+
+// What sortFile did, for throughput reporting
+struct ExternalSortStats {
+    std::uint64_t bytes = 0;
+    std::uint64_t runs = 0;        // Sorted runs written by the first phase
+    int merge_passes = 0;          // 0 when the input fit in a single run
+    double run_seconds = 0.0;      // Reading, sorting and writing the runs
+    double merge_seconds = 0.0;
+    double total_seconds = 0.0;
+
+    double bytesPerSecond() const { return total_seconds > 0.0 ? bytes / total_seconds : 0.0; }
+};
+
+// Sorts a binary file of native-endian T keys that may be much larger than RAM:
+//   1. The input is read in runs of half the memory budget with large sequential reads.
+//   2. Each run is sorted by the in-memory sorter (SIMDBitonicSorter on the shared pool by
+//      default) while a background thread writes the previous run to a temp file and reads
+//      the next one into the other half, so I/O overlaps with sorting.
+//   3. The runs are merged through a binary tree of 2-way merges. Each merge step is a SIMD
+//      bitonic merge network: the half-block of largest keys carried from the previous step
+//      is merged in registers with the next half-block of the input whose head is smaller.
+//      Run reads and the output writes are double-buffered on background threads.
+// Temp files are removed before sortFile returns or throws. I/O errors throw
+// std::runtime_error; a file size that is not a multiple of sizeof(T) throws
+// std::invalid_argument.
+template <typename T>
+class BasicExternalSorter {
+public:
+    explicit BasicExternalSorter(ExternalSortOptions options = ExternalSortOptions(),
+                                 std::shared_ptr<BasicBitonicSort<T>> run_sorter = nullptr);
+
+    // input_path and output_path may name the same file
+    ExternalSortStats sortFile(const std::string& input_path, const std::string& output_path, SortOrder order);
+
+    std::string getName() const;
+
+    const ExternalSortOptions& getOptions() const { return options_; }
+    // Keys per sorted run: half the budget, at most INT_MAX
+    std::size_t getRunSize() const;
+
+    // Smallest buffer a run reader or the output writer gets during the merge
+    static const std::size_t MIN_IO_BUFFER_BYTES = 64 * 1024;
+
+private:
+    ExternalSortOptions options_;
+    std::shared_ptr<BasicBitonicSort<T>> run_sorter_;
+    const SIMDKernels<T>* kernels_;
+
+    // Buffer between two merge nodes; it only amortises the calls that refill it
+    static const std::size_t NODE_BUFFER_BYTES = 16 * 1024;
+
+    // Runs merged per pass: max_merge_fan_in, fewer when the budget cannot give every
+    // stream its buffers
+    int mergeFanIn() const;
+    // Merges the sorted files inputs into output; intermediate passes write to files from
+    // create_temp. Returns the number of passes.
+    int mergeRuns(std::vector<std::string> inputs, const std::string& output, SortOrder order,
+                  const std::function<std::string()>& create_temp);
+    void mergeOnePass(const std::vector<std::string>& inputs, const std::string& output, SortOrder order);
+};
+
+using ExternalSorter = BasicExternalSorter<int>;
+
+#endif // EXTERNAL_SORTER_H
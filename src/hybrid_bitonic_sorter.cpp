@@ -0,0 +1,214 @@
+#include "hybrid_bitonic_sorter.h"
+#include "merge_path.h"
+#include <algorithm> // For std::min, std::max, std::swap
+#include <cstring>   // For std::memcpy
+
+namespace {
+
+// Key/value merge for the sortPairs passes; ties go to a, as in mergePathSplit
+template <typename T>
+void mergePairs(const T* ka, const PayloadOf<T>* va, std::size_t na, const T* kb, const PayloadOf<T>* vb,
+                std::size_t nb, T* keys, PayloadOf<T>* values, SortOrder order) {
+    std::size_t i = 0;
+    std::size_t j = 0;
+    std::size_t k = 0;
+    while (i < na && j < nb) {
+        if (sortsBefore(kb[j], ka[i], order)) {
+            keys[k] = kb[j];
+            values[k++] = vb[j++];
+        } else {
+            keys[k] = ka[i];
+            values[k++] = va[i++];
+        }
+    }
+    for (; i < na; ++i, ++k) {
+        keys[k] = ka[i];
+        values[k] = va[i];
+    }
+    for (; j < nb; ++j, ++k) {
+        keys[k] = kb[j];
+        values[k] = vb[j];
+    }
+}
+
+} // namespace
+
+template <typename T>
+BasicHybridBitonicSorter<T>::BasicHybridBitonicSorter(SIMDIsa isa, std::size_t block_bytes)
+    : BasicHybridBitonicSorter(isa, nullptr, block_bytes) {
+}
+
+template <typename T>
+BasicHybridBitonicSorter<T>::BasicHybridBitonicSorter(SIMDIsa isa, std::shared_ptr<WorkStealingThreadPool> pool,
+                                                      std::size_t block_bytes)
+    : kernels_(&selectSIMDKernels<T>(isa)), pool_(std::move(pool)), block_bytes_(block_bytes), block_sorter_(isa) {
+    this->stats_.setThreadCount(pool_ ? pool_->getWorkerCount() + 1 : 1);
+}
+
+template <typename T>
+int BasicHybridBitonicSorter<T>::getBlockSize() const {
+    std::size_t keys = std::min<std::size_t>(block_bytes_ / sizeof(T), 1 << 30);
+    return std::max(static_cast<int>(keys), kernels_->blockSize);
+}
+
+template <typename T>
+template <typename F>
+void BasicHybridBitonicSorter<T>::forEach(SortPhase phase, int begin, int end, F&& fn) {
+    auto timed = [&](int first, int last) {
+        SortStatsTimer timer(&this->stats_, phase);
+        fn(first, last);
+    };
+    if (pool_ && pool_->getWorkerCount() > 0) {
+        pool_->parallelFor(begin, end, 1, timed);
+    } else {
+        timed(begin, end);
+    }
+}
+
+template <typename T>
+template <typename F>
+void BasicHybridBitonicSorter<T>::forEachMergePiece(int count, int width, F&& merge_piece) {
+    const int pieces = (count + MERGE_PIECE_KEYS - 1) / MERGE_PIECE_KEYS;
+    forEach(SortPhase::Merge, 0, pieces, [&](int first, int last) {
+        for (int p = first; p < last; ++p) {
+            int begin = p * MERGE_PIECE_KEYS;
+            const int end = static_cast<int>(std::min<long long>(begin + static_cast<long long>(MERGE_PIECE_KEYS), count));
+            while (begin < end) { // A piece may straddle two merges
+                const int lo = begin - begin % (2 * width);
+                const int mid = static_cast<int>(std::min<long long>(lo + static_cast<long long>(width), count));
+                const int hi = static_cast<int>(std::min<long long>(lo + 2 * static_cast<long long>(width), count));
+                const int piece_end = std::min(end, hi);
+                merge_piece(lo, mid, hi, begin, piece_end);
+                begin = piece_end;
+            }
+        }
+    });
+}
+
+template <typename T>
+void BasicHybridBitonicSorter<T>::sort(T* data, std::size_t count, SortOrder order) {
+    if (count <= 1) {
+        return;
+    }
+    const int n = this->checkedCount(count);
+    SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+    const int block = getBlockSize();
+    forEach(SortPhase::Sort, 0, (n + block - 1) / block, [&](int first, int last) {
+        for (int b = first; b < last; ++b) {
+            block_sorter_.sort(data + static_cast<std::size_t>(b) * block, std::min(block, n - b * block), order);
+        }
+    });
+    if (n <= block) {
+        return;
+    }
+
+    SortWorkspace::Lease workspace(this->workspace_);
+    T* src = data;
+    T* dst = workspace.get<T>(0, n);
+    for (long long width = block; width < n; width *= 2) {
+        forEachMergePiece(n, static_cast<int>(width), [&](int lo, int mid, int hi, int begin, int end) {
+            MergePathPiece piece = mergePathPiece<T>(src + lo, mid - lo, src + mid, hi - mid, begin - lo, end - lo, order);
+            kernels_->mergeSorted(src + lo + piece.a_begin, static_cast<int>(piece.a_end - piece.a_begin),
+                                  src + mid + piece.b_begin, static_cast<int>(piece.b_end - piece.b_begin),
+                                  dst + begin, order);
+            countKernelCompareExchanges(*kernels_, mergeSortedComparators(*kernels_, end - begin));
+        });
+        std::swap(src, dst);
+    }
+    if (src != data) {
+        forEach(SortPhase::Copy, 0, (n + MERGE_PIECE_KEYS - 1) / MERGE_PIECE_KEYS, [&](int first, int last) {
+            const int begin = first * MERGE_PIECE_KEYS;
+            const int end = static_cast<int>(std::min<long long>(static_cast<long long>(last) * MERGE_PIECE_KEYS, n));
+            std::memcpy(data + begin, src + begin, sizeof(T) * (end - begin));
+        });
+    }
+}
+
+template <typename T>
+void BasicHybridBitonicSorter<T>::sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) {
+    if (count <= 1) {
+        return;
+    }
+    const int n = this->checkedCount(count);
+    SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+    const int block = std::max(static_cast<int>(std::min<std::size_t>(block_bytes_ / (sizeof(T) + sizeof(payload_type)),
+                                                                      1 << 30)),
+                               kernels_->blockSize);
+    forEach(SortPhase::Sort, 0, (n + block - 1) / block, [&](int first, int last) {
+        for (int b = first; b < last; ++b) {
+            const std::size_t offset = static_cast<std::size_t>(b) * block;
+            block_sorter_.sortPairs(keys + offset, values + offset, std::min(block, n - b * block), order);
+        }
+    });
+    if (n <= block) {
+        return;
+    }
+
+    SortWorkspace::Lease workspace(this->workspace_);
+    T* src_keys = keys;
+    payload_type* src_values = values;
+    T* dst_keys = workspace.get<T>(0, n);
+    payload_type* dst_values = workspace.get<payload_type>(1, n);
+    for (long long width = block; width < n; width *= 2) {
+        forEachMergePiece(n, static_cast<int>(width), [&](int lo, int mid, int hi, int begin, int end) {
+            MergePathPiece piece =
+                mergePathPiece<T>(src_keys + lo, mid - lo, src_keys + mid, hi - mid, begin - lo, end - lo, order);
+            mergePairs(src_keys + lo + piece.a_begin, src_values + lo + piece.a_begin, piece.a_end - piece.a_begin,
+                       src_keys + mid + piece.b_begin, src_values + mid + piece.b_begin, piece.b_end - piece.b_begin,
+                       dst_keys + begin, dst_values + begin, order);
+            countKernelCompareExchanges(end - begin, false); // One scalar comparison per key
+        });
+        std::swap(src_keys, dst_keys);
+        std::swap(src_values, dst_values);
+    }
+    if (src_keys != keys) {
+        SortStatsTimer timer(&this->stats_, SortPhase::Copy);
+        std::memcpy(keys, src_keys, sizeof(T) * n);
+        std::memcpy(values, src_values, sizeof(payload_type) * n);
+    }
+}
+
+template <typename T>
+void BasicHybridBitonicSorter<T>::merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out,
+                                        SortOrder order) {
+    const int count = this->checkedCount(na + nb);
+    SortStatsCall call(&this->stats_, SortPhase::Merge, count);
+    mergeSortedPieces(*kernels_, a, na, b, nb, out, order, MERGE_PIECE_KEYS,
+                      [&](int pieces, auto&& fn) { forEach(SortPhase::Merge, 0, pieces, fn); });
+    countKernelCompareExchanges(*kernels_, mergeSortedComparators(*kernels_, count));
+}
+
+template <typename T>
+SortStats BasicHybridBitonicSorter<T>::getStats() const {
+    SortStats stats = this->stats_.get();
+    stats.add(block_sorter_.getStats(), true);
+    return stats;
+}
+
+template <typename T>
+void BasicHybridBitonicSorter<T>::resetStats() {
+    this->stats_.reset();
+    block_sorter_.resetStats();
+}
+
+template <typename T>
+std::size_t BasicHybridBitonicSorter<T>::getWorkspaceBytes() const {
+    return BasicBitonicSort<T>::getWorkspaceBytes() + block_sorter_.getWorkspaceBytes();
+}
+
+template <typename T>
+void BasicHybridBitonicSorter<T>::releaseWorkspace() {
+    BasicBitonicSort<T>::releaseWorkspace();
+    block_sorter_.releaseWorkspace();
+}
+
+template <typename T>
+std::string BasicHybridBitonicSorter<T>::getName() const {
+    std::string threads = pool_ ? ", " + std::to_string(pool_->getWorkerCount() + 1) + " threads" : "";
+    return "HybridBitonicSorter" + keyTypeSuffix<T>() + " (" + simdIsaName(kernels_->isa) +
+           ", block=" + std::to_string(block_bytes_ / 1024) + "KiB" + threads + ")";
+}
+
+#define INSTANTIATE_HYBRID_SORTER(T) template class BasicHybridBitonicSorter<T>;
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_HYBRID_SORTER)
+#undef INSTANTIATE_HYBRID_SORTER
@@ -0,0 +1,77 @@
+#ifndef HYBRID_BITONIC_SORTER_H
+#define HYBRID_BITONIC_SORTER_H
+
+#include "bitonic_sort.h"
+#include <vector>
+#include <string>
+#include <cstddef>   // For std::size_t
+#include <memory>    // For std::shared_ptr
+#include "simd_bitonic_sorter.h"
+#include "simd_kernels.h"
+#include "work_stealing_thread_pool.h"
+
+// Bitonic sort does O(N log^2 N) compare-exchanges, which loses to O(N log N) sorts once N
+// is well past the cache. This sorter keeps the network only where it fits in cache:
+//   1. Blocks of block_bytes are sorted by the SIMD bitonic network, one block per task.
+//   2. Sorted runs are merged pairwise, log(N / block) passes between data and a scratch
+//      buffer. Each pass cuts its output into pieces of MERGE_PIECE_KEYS with merge path,
+//      so every task merges the same number of keys, and merges a piece with the kernels'
+//      mergeSorted: a 2-register bitonic merge network per step.
+// That is O(N log N) work overall. Without a pool (or with no workers) both phases run on
+// the calling thread.
+template <typename T>
+class BasicHybridBitonicSorter : public BasicBitonicSort<T> {
+public:
+    // 256 KiB: half of a typical per-core L2, as for BlockedBitonicSorter's tiles
+    static const std::size_t DEFAULT_BLOCK_BYTES = 256 * 1024;
+
+    explicit BasicHybridBitonicSorter(SIMDIsa isa = SIMDIsa::Auto, std::size_t block_bytes = DEFAULT_BLOCK_BYTES);
+    BasicHybridBitonicSorter(SIMDIsa isa, std::shared_ptr<WorkStealingThreadPool> pool,
+                             std::size_t block_bytes = DEFAULT_BLOCK_BYTES);
+    ~BasicHybridBitonicSorter() override = default;
+
+    using payload_type = typename BasicBitonicSort<T>::payload_type;
+
+    using BasicBitonicSort<T>::sort;
+    using BasicBitonicSort<T>::sortPairs;
+    void sort(T* data, std::size_t count, SortOrder order) override;
+    // Blocks are sorted with SIMDBitonicSorter::sortPairs; the merge passes move payloads
+    // with a scalar merge, since mergeSorted has no key/value version.
+    void sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) override;
+    // As SIMDBitonicSorter::merge
+    using BasicBitonicSort<T>::merge;
+    void merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, SortOrder order) override;
+    std::string getName() const override;
+    // Includes the block sorter's work
+    SortStats getStats() const override;
+    void resetStats() override;
+    std::size_t getWorkspaceBytes() const override;
+    void releaseWorkspace() override;
+
+    SIMDIsa getIsa() const { return kernels_->isa; }
+    std::size_t getBlockBytes() const { return block_bytes_; }
+    // Keys per block in sort(), at least one register block
+    int getBlockSize() const;
+
+    // Output keys per merge task
+    static const int MERGE_PIECE_KEYS = 1 << 15;
+
+private:
+    const SIMDKernels<T>* kernels_;
+    std::shared_ptr<WorkStealingThreadPool> pool_; // Null when single-threaded
+    std::size_t block_bytes_;
+    BasicSIMDBitonicSorter<T> block_sorter_;
+
+    // fn(first, last) over [begin, end) on the pool, charged to phase
+    template <typename F>
+    void forEach(SortPhase phase, int begin, int end, F&& fn);
+    // Calls merge_piece(lo, mid, hi, begin, end) for every piece [begin, end) of the
+    // output of one pass, where runs [lo, mid) and [mid, hi) are merged; count keys in
+    // runs of width
+    template <typename F>
+    void forEachMergePiece(int count, int width, F&& merge_piece);
+};
+
+using HybridBitonicSorter = BasicHybridBitonicSorter<int>;
+
+#endif // HYBRID_BITONIC_SORTER_H
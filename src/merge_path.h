@@ -0,0 +1,68 @@
+#ifndef MERGE_PATH_H
+#define MERGE_PATH_H
+
+#include "bitonic_sort.h" // For SortOrder, SortKeyTraits
+#include "simd_kernels.h"
+#include <algorithm>      // For std::min
+#include <cstddef>        // For std::size_t
+
+// Merge path (Odeh, Green, Mwassi, Shmueli, Birk): the first d keys of the merge of a and b
+// are a[0, i) and b[0, d - i) for a single i, found by a binary search along the d-th
+// cross diagonal of the merge matrix. Splitting the output at evenly spaced d gives pieces
+// of equal size that threads merge independently, however the keys are distributed.
+
+template <typename T>
+inline bool sortsBefore(T a, T b, SortOrder order) {
+    return (order == SortOrder::Ascending) ? SortKeyTraits<T>::less(a, b) : SortKeyTraits<T>::less(b, a);
+}
+
+// Keys of a among the first d keys of the merge; ties go to a
+template <typename T>
+std::size_t mergePathSplit(const T* a, std::size_t na, const T* b, std::size_t nb, std::size_t d, SortOrder order) {
+    std::size_t lo = d > nb ? d - nb : 0;
+    std::size_t hi = std::min(d, na);
+    while (lo < hi) {
+        std::size_t mid = lo + (hi - lo) / 2;
+        if (sortsBefore(b[d - mid - 1], a[mid], order)) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+// The slices of a and b that make up output [begin, end) of their merge
+struct MergePathPiece {
+    std::size_t a_begin, a_end;
+    std::size_t b_begin, b_end;
+};
+
+template <typename T>
+MergePathPiece mergePathPiece(const T* a, std::size_t na, const T* b, std::size_t nb, std::size_t begin,
+                              std::size_t end, SortOrder order) {
+    std::size_t a_begin = mergePathSplit(a, na, b, nb, begin, order);
+    std::size_t a_end = mergePathSplit(a, na, b, nb, end, order);
+    return {a_begin, a_end, begin - a_begin, end - a_end};
+}
+
+// Merges a and b into out with kernels.mergeSorted, one piece of piece_keys output keys
+// at a time. for_each(pieces, fn) calls fn(first, last) over the piece indices [0, pieces),
+// on as many threads as it likes. na + nb must fit in an int.
+template <typename T, typename ForEach>
+void mergeSortedPieces(const SIMDKernels<T>& kernels, const T* a, std::size_t na, const T* b, std::size_t nb, T* out,
+                       SortOrder order, std::size_t piece_keys, ForEach&& for_each) {
+    const std::size_t count = na + nb;
+    const int pieces = static_cast<int>((count + piece_keys - 1) / piece_keys);
+    for_each(pieces, [&](int first, int last) {
+        for (int p = first; p < last; ++p) {
+            const std::size_t begin = p * piece_keys;
+            const std::size_t end = std::min(begin + piece_keys, count);
+            MergePathPiece piece = mergePathPiece(a, na, b, nb, begin, end, order);
+            kernels.mergeSorted(a + piece.a_begin, static_cast<int>(piece.a_end - piece.a_begin), b + piece.b_begin,
+                                static_cast<int>(piece.b_end - piece.b_begin), out + begin, order);
+        }
+    });
+}
+
+#endif // MERGE_PATH_H
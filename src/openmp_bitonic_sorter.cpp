@@ -1,131 +1,326 @@
 #include "openmp_bitonic_sorter.h"
-#include <cmath>    // For std::pow, std::log2, std::ceil
-#include <limits>   // For std::numeric_limits
+#include <type_traits> // For std::is_same
 #include <iostream> // For debugging
 
-OpenMPBitonicSorter::OpenMPBitonicSorter() {
-    // Optionally, set number of threads if not relying on environment variable or default
-    // For example: omp_set_num_threads(omp_get_max_threads());
-    // But usually, it's better to let OpenMP manage this unless specific control is needed.
+template <typename T>
+BasicOpenMPBitonicSorter<T>::BasicOpenMPBitonicSorter(int num_threads, OpenMPProcBind proc_bind, int task_cutoff_depth)
+    : BasicOpenMPBitonicSorter(nullptr, num_threads, proc_bind, task_cutoff_depth) {
 }
 
-void OpenMPBitonicSorter::padData(std::vector<int>& arr, int& original_size, int& padded_size, SortOrder order) {
-    original_size = arr.size();
-    if (original_size == 0) {
-        padded_size = 0;
-        return;
+template <typename T>
+BasicOpenMPBitonicSorter<T>::BasicOpenMPBitonicSorter(const SIMDKernels<T>* leaf_kernels, int num_threads,
+                                                      OpenMPProcBind proc_bind, int task_cutoff_depth)
+    : num_threads_(num_threads), proc_bind_(proc_bind), task_cutoff_depth_(task_cutoff_depth),
+      leaf_kernels_(leaf_kernels) {
+    if (num_threads < 0) {
+        throw std::invalid_argument("OpenMPBitonicSorter: num_threads must be non-negative");
+    }
+    if (task_cutoff_depth < AUTO_TASK_CUTOFF_DEPTH) {
+        throw std::invalid_argument("OpenMPBitonicSorter: task_cutoff_depth must be non-negative or AUTO");
+    }
+    if (num_threads_ == 0) {
+        num_threads_ = omp_get_max_threads();
+    }
+    if (task_cutoff_depth_ == AUTO_TASK_CUTOFF_DEPTH) {
+        // Each level doubles the task count: ceil(log2(threads)) levels give one task per
+        // thread, three more give eight, which leaves room for stealing to even out the load
+        int levels = 0;
+        while ((1 << levels) < num_threads_) {
+            ++levels;
+        }
+        task_cutoff_depth_ = levels + 3;
     }
-    padded_size = std::pow(2, std::ceil(std::log2(original_size)));
-    if (padded_size > original_size) {
-        arr.resize(padded_size, (order == SortOrder::Ascending) ? std::numeric_limits<int>::max() : std::numeric_limits<int>::min());
+    if (leaf_kernels_) {
+        thresholds_ = {SEQUENTIAL_THRESHOLD_OMP_SIMD, PARALLEL_COMPARE_GRAIN_OMP_SIMD};
     }
+    this->stats_.setThreadCount(num_threads_);
+}
+
+template <typename T>
+BasicOpenMPSIMDBitonicSorter<T>::BasicOpenMPSIMDBitonicSorter(SIMDIsa isa, int num_threads, OpenMPProcBind proc_bind,
+                                                              int task_cutoff_depth)
+    : BasicOpenMPBitonicSorter<T>(&selectSIMDKernels<T>(isa), num_threads, proc_bind, task_cutoff_depth) {
 }
 
-void OpenMPBitonicSorter::unpadData(std::vector<int>& arr, int original_size, int padded_size) {
-    if (padded_size > original_size) {
-        arr.resize(original_size);
+template <typename T>
+void BasicOpenMPBitonicSorter<T>::setThresholds(ParallelThresholds thresholds) {
+    if (leaf_kernels_) {
+        thresholds_ = resolveThresholds(thresholds, {SEQUENTIAL_THRESHOLD_OMP_SIMD, PARALLEL_COMPARE_GRAIN_OMP_SIMD});
+    } else {
+        thresholds_ = resolveThresholds(thresholds, {SEQUENTIAL_THRESHOLD_OMP, PARALLEL_COMPARE_GRAIN_OMP});
     }
 }
 
-void OpenMPBitonicSorter::sort(std::vector<int>& arr, SortOrder order) {
-    if (arr.empty()) {
-        return;
+template <typename T>
+void BasicOpenMPBitonicSorter<T>::sort(T* data, std::size_t count, SortOrder order) {
+    if (count > 1) {
+        SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+        runParallelRegion(data, this->checkedCount(count), order);
     }
+}
 
-    int original_size = 0;
-    int padded_size = 0;
-    bool is_power_of_two = (arr.size() > 0) && ((arr.size() & (arr.size() - 1)) == 0);
+template <typename T>
+void BasicOpenMPBitonicSorter<T>::sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) {
+    if (count > 1) {
+        SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+        typename BasicBitonicSort<T>::KeyValueArrays kv{keys, values};
+        runParallelRegion(kv, this->checkedCount(count), order);
+    }
+}
 
-    if (!is_power_of_two) {
-        padData(arr, original_size, padded_size, order);
-    } else {
-        original_size = arr.size();
-        padded_size = arr.size();
+template <typename T>
+void BasicOpenMPBitonicSorter<T>::merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out,
+                                        SortOrder order) {
+    const int count = this->checkedCount(na + nb);
+    SortStatsCall call(&this->stats_, SortPhase::Merge, na + nb);
+    this->copyBitonic(a, na, b, nb, out);
+    if (count > 1) {
+        runParallelRegion(out, count, order, true);
     }
+}
+
+template <typename T>
+std::string BasicOpenMPBitonicSorter<T>::getName() const {
+    static const char* const bind_names[] = {"default", "close", "spread"};
+    return "OpenMPBitonicSorter" + keyTypeSuffix<T>() + "(num_threads=" + std::to_string(num_threads_) +
+           ", proc_bind=" + bind_names[static_cast<int>(proc_bind_)] +
+           ", cutoff_depth=" + std::to_string(task_cutoff_depth_) + ")";
+}
 
-    if (padded_size > 0) {
-        // Enclose the initial call in a parallel region to enable nested tasking if desired
-        // However, tasks created with 'task' directive are part of the current task region.
-        // A single parallel region at the top level is often sufficient.
-        // Pass correct 'low' which is 0 for the initial call.
-        #pragma omp parallel default(none) shared(arr, padded_size, order) if(padded_size > SEQUENTIAL_THRESHOLD_OMP)
+template <typename T>
+std::string BasicOpenMPSIMDBitonicSorter<T>::getName() const {
+    static const char* const bind_names[] = {"default", "close", "spread"};
+    return "OpenMPSIMDBitonicSorter" + keyTypeSuffix<T>() + "(" + simdIsaName(getIsa()) +
+           ", num_threads=" + std::to_string(this->getNumThreads()) +
+           ", proc_bind=" + bind_names[static_cast<int>(this->getProcBind())] +
+           ", cutoff_depth=" + std::to_string(this->getTaskCutoffDepth()) + ")";
+}
+
+template <typename T>
+template <typename Arr>
+void BasicOpenMPBitonicSorter<T>::runParallelRegion(Arr& arr, int count, SortOrder order, bool merge_only) {
+    // One thread starts the recursion; the rest of the team picks up its tasks. proc_bind
+    // only accepts a keyword, hence one region per policy. The implicit barrier at the end
+    // of each region waits for every task.
+    const int threads = num_threads_;
+    switch (proc_bind_) {
+    case OpenMPProcBind::Close:
+        #pragma omp parallel default(none) shared(arr, count, order, merge_only) num_threads(threads) proc_bind(close) \
+            if(count > thresholds_.sequential)
         {
             #pragma omp single nowait
-            {
-                bitonicSortRecursiveOMP(arr, 0, padded_size, order);
-            }
-        } // Implicit barrier here
-    }
-
-    if (!is_power_of_two && padded_size > 0) {
-        unpadData(arr, original_size, padded_size);
+            runRecursion(arr, count, order, merge_only);
+        }
+        break;
+    case OpenMPProcBind::Spread:
+        #pragma omp parallel default(none) shared(arr, count, order, merge_only) num_threads(threads) proc_bind(spread) \
+            if(count > thresholds_.sequential)
+        {
+            #pragma omp single nowait
+            runRecursion(arr, count, order, merge_only);
+        }
+        break;
+    default:
+        #pragma omp parallel default(none) shared(arr, count, order, merge_only) num_threads(threads) \
+            if(count > thresholds_.sequential)
+        {
+            #pragma omp single nowait
+            runRecursion(arr, count, order, merge_only);
+        }
+        break;
     }
 }
 
-std::string OpenMPBitonicSorter::getName() const {
-    // Could try to get omp_get_max_threads() here, but it might vary
-    return "OpenMPBitonicSorter";
+template <typename T>
+template <typename Arr>
+void BasicOpenMPBitonicSorter<T>::runRecursion(Arr& arr, int count, SortOrder order, bool merge_only) {
+    // The single construct may pick a thread other than the caller
+    SortStatsTimer timer(&this->stats_, merge_only ? SortPhase::Merge : SortPhase::Sort);
+    if (merge_only) {
+        bitonicMergeOMP(arr, 0, count, order, 0);
+    } else {
+        bitonicSortRecursiveOMP(arr, 0, count, order, 0);
+    }
 }
 
-void OpenMPBitonicSorter::bitonicSortRecursiveOMP(std::vector<int>& arr, int low, int count, SortOrder order) {
+template <typename T>
+template <typename Arr>
+void BasicOpenMPBitonicSorter<T>::bitonicSortRecursiveOMP(Arr& arr, int low, int count, SortOrder order, int depth) {
     if (count <= 1) {
         return;
     }
 
-    int k = count / 2;
+    // Power-of-two first part sorted against the final order, the rest along it (see
+    // BasicBitonicSort::bitonicMerge)
+    int k = this->splitPoint(count);
+    SortOrder first_order = this->oppositeOrder(order);
 
-    if (count > SEQUENTIAL_THRESHOLD_OMP) {
+    if (count > thresholds_.sequential && depth < task_cutoff_depth_) {
         // Using OpenMP tasks for recursive calls
-        #pragma omp task default(none) shared(arr, low, k, order)
+        #pragma omp task default(none) shared(arr, low, k, first_order, depth)
+        {
+            SortStatsTimer timer(&this->stats_, SortPhase::Sort);
+            bitonicSortRecursiveOMP(arr, low, k, first_order, depth + 1);
+        }
+        #pragma omp task default(none) shared(arr, low, k, count, order, depth)
         {
-            bitonicSortRecursiveOMP(arr, low, k, SortOrder::Ascending);
+            SortStatsTimer timer(&this->stats_, SortPhase::Sort);
+            bitonicSortRecursiveOMP(arr, low + k, count - k, order, depth + 1);
         }
-        // Pass correct 'low + k' for the second half.
-        #pragma omp task default(none) shared(arr, low, k, order)
         {
-            bitonicSortRecursiveOMP(arr, low + k, k, SortOrder::Descending);
+            SortStatsTimer timer(&this->stats_, SortPhase::Wait);
+            #pragma omp taskwait // Wait for the two sorting tasks to complete before merging
         }
-        #pragma omp taskwait // Wait for the two sorting tasks to complete before merging
 
-        bitonicMergeOMP(arr, low, count, order);
+        bitonicMergeOMP(arr, low, count, order, depth);
 
+    } else if (hasLeafKernels<Arr>()) {
+        sortLeafSIMD(arr, low, count, order);
     } else {
         // Use base class sequential versions for small subproblems
-        BitonicSort::bitonicSortRecursive(arr, low, k, SortOrder::Ascending);
-        BitonicSort::bitonicSortRecursive(arr, low + k, k, SortOrder::Descending);
-        BitonicSort::bitonicMerge(arr, low, count, order);
+        BasicBitonicSort<T>::bitonicSortRecursive(arr, low, k, first_order);
+        BasicBitonicSort<T>::bitonicSortRecursive(arr, low + k, count - k, order);
+        SortStatsTimer timer(count > SortStats::MIN_TIMED_KEYS ? &this->stats_ : nullptr, SortPhase::Merge);
+        BasicBitonicSort<T>::bitonicMerge(arr, low, count, order);
     }
 }
 
-void OpenMPBitonicSorter::bitonicMergeOMP(std::vector<int>& arr, int low, int count, SortOrder order) {
+template <typename T>
+template <typename Arr>
+void BasicOpenMPBitonicSorter<T>::bitonicMergeOMP(Arr& arr, int low, int count, SortOrder order, int depth) {
     if (count <= 1) {
         return;
     }
 
-    int k = count / 2;
-    // The loop for compareAndSwap can be parallelized if k is large enough
-    // However, bitonic merge itself is recursive. Parallelizing the loop here might be
-    // too fine-grained if the recursive calls are already tasked.
-    // For now, keeping this loop sequential within each task.
-    for (int i = low; i < low + k; ++i) {
-        compareAndSwap(arr, i, i + k, order);
+    // Only the first count - k elements have a partner; the rest would meet virtual padding
+    int k = this->splitPoint(count);
+    int pairs = count - k;
+    SortStatsTimer timer(count > SortStats::MIN_TIMED_KEYS ? &this->stats_ : nullptr, SortPhase::Merge);
+    // The compare-exchanges of one level are independent. Splitting the large ones into
+    // tasks of grain each keeps the top levels of the merge from running on a single
+    // thread; taskloop waits for its tasks before the recursive halves start.
+    const bool spawn_tasks = depth < task_cutoff_depth_;
+    const int grain = thresholds_.compare_grain;
+    // Levels much larger than the last-level cache bypass it, as in the SIMD sorter
+    const bool streaming = leaf_kernels_ && count * sizeof(T) > streamingStoreThresholdBytes();
+    {
+        SortStatsStride stride(&this->stats_, k, pairs);
+        if (spawn_tasks && pairs >= 2 * grain) {
+            #pragma omp taskloop default(none) shared(arr) firstprivate(low, k, pairs, order, grain, streaming) \
+                grainsize(1)
+            for (int begin = low; begin < low + pairs; begin += grain) {
+                SortStatsTimer chunk_timer(&this->stats_, SortPhase::Merge);
+                compareExchangeRange(arr, begin, std::min(begin + grain, low + pairs), k, order, streaming);
+            }
+        } else {
+            compareExchangeRange(arr, low, low + pairs, k, order, streaming);
+        }
     }
 
-    if (count > SEQUENTIAL_THRESHOLD_OMP) {
-        #pragma omp task default(none) shared(arr, low, k, order)
+    if (count > thresholds_.sequential && spawn_tasks) {
+        #pragma omp task default(none) shared(arr, low, k, order, depth)
         {
-            bitonicMergeOMP(arr, low, k, order);
+            SortStatsTimer task_timer(&this->stats_, SortPhase::Merge);
+            bitonicMergeOMP(arr, low, k, order, depth + 1);
         }
-        // Pass correct 'low + k' for the second half.
-        #pragma omp task default(none) shared(arr, low, k, order)
+        #pragma omp task default(none) shared(arr, low, k, pairs, order, depth)
         {
-            bitonicMergeOMP(arr, low + k, k, order);
+            SortStatsTimer task_timer(&this->stats_, SortPhase::Merge);
+            bitonicMergeOMP(arr, low + k, pairs, order, depth + 1);
         }
         // #pragma omp taskwait // Not strictly needed here if the merge is the last thing in the calling task
                                 // and the calling task has a taskwait. But for clarity or safety:
+        SortStatsTimer wait_timer(&this->stats_, SortPhase::Wait);
         #pragma omp taskwait
+    } else if (hasLeafKernels<Arr>()) {
+        mergeLeafSIMD(arr, low, k, order);
+        mergeLeafSIMD(arr, low + k, pairs, order);
+    } else {
+        BasicBitonicSort<T>::bitonicMerge(arr, low, k, order);
+        BasicBitonicSort<T>::bitonicMerge(arr, low + k, pairs, order);
+    }
+}
+
+template <typename T>
+template <typename Arr>
+bool BasicOpenMPBitonicSorter<T>::hasLeafKernels() const {
+    if constexpr (std::is_same<Arr, T*>::value) {
+        return leaf_kernels_ != nullptr;
+    } else {
+        return leaf_kernels_ != nullptr && leaf_kernels_->sortBlockPairs != nullptr;
+    }
+}
+
+// As BasicSIMDBitonicSorter::bitonicSortRecursiveSIMD without the pool
+template <typename T>
+void BasicOpenMPBitonicSorter<T>::sortLeafSIMD(T* arr, int low, int count, SortOrder order) {
+    if (count <= 1) {
+        return;
+    }
+    if (count <= leaf_kernels_->blockSize) {
+        leaf_kernels_->sortBlock(arr + low, count, order);
+        countKernelCompareExchanges(*leaf_kernels_, bitonicSortComparators(count));
+        return;
+    }
+    int k = this->splitPoint(count);
+    sortLeafSIMD(arr, low, k, this->oppositeOrder(order));
+    sortLeafSIMD(arr, low + k, count - k, order);
+    SortStatsTimer timer(count > SortStats::MIN_TIMED_KEYS ? &this->stats_ : nullptr, SortPhase::Merge);
+    mergeLeafSIMD(arr, low, count, order);
+}
+
+template <typename T>
+void BasicOpenMPBitonicSorter<T>::sortLeafSIMD(const typename BasicBitonicSort<T>::KeyValueArrays& kv, int low,
+                                               int count, SortOrder order) {
+    if (count <= 1) {
+        return;
+    }
+    if (count <= leaf_kernels_->pairBlockSize) {
+        leaf_kernels_->sortBlockPairs(kv.keys + low, kv.values + low, count, order);
+        countKernelCompareExchanges(*leaf_kernels_, bitonicSortComparators(count));
+        return;
+    }
+    int k = this->splitPoint(count);
+    sortLeafSIMD(kv, low, k, this->oppositeOrder(order));
+    sortLeafSIMD(kv, low + k, count - k, order);
+    SortStatsTimer timer(count > SortStats::MIN_TIMED_KEYS ? &this->stats_ : nullptr, SortPhase::Merge);
+    mergeLeafSIMD(kv, low, count, order);
+}
+
+template <typename T>
+void BasicOpenMPBitonicSorter<T>::mergeLeafSIMD(T* arr, int low, int count, SortOrder order) {
+    leaf_kernels_->bitonicMerge(arr + low, count, order);
+    countKernelCompareExchanges(*leaf_kernels_, bitonicMergeComparators(count));
+}
+
+template <typename T>
+void BasicOpenMPBitonicSorter<T>::mergeLeafSIMD(const typename BasicBitonicSort<T>::KeyValueArrays& kv, int low,
+                                                int count, SortOrder order) {
+    leaf_kernels_->bitonicMergePairs(kv.keys + low, kv.values + low, count, order);
+    countKernelCompareExchanges(*leaf_kernels_, bitonicMergeComparators(count));
+}
+
+template <typename T>
+template <typename Arr>
+void BasicOpenMPBitonicSorter<T>::compareExchangeRange(Arr& arr, int begin, int end, int k, SortOrder order,
+                                                       bool streaming) {
+    if (!hasLeafKernels<Arr>()) {
+        for (int i = begin; i < end; ++i) {
+            this->compareAndSwap(arr, i, i + k, order);
+        }
+        return;
+    }
+    if constexpr (std::is_same<Arr, T*>::value) {
+        (streaming ? leaf_kernels_->compareAndSwapBlocksStreaming : leaf_kernels_->compareAndSwapBlocks)(
+            arr + begin, arr + begin + k, end - begin, order);
     } else {
-        BitonicSort::bitonicMerge(arr, low, k, order);
-        BitonicSort::bitonicMerge(arr, low + k, k, order);
+        leaf_kernels_->compareAndSwapBlocksPairs(arr.keys + begin, arr.values + begin, k, end - begin, order);
     }
+    countKernelCompareExchanges(*leaf_kernels_, end - begin);
 }
+
+#define INSTANTIATE_OPENMP_SORTER(T) \
+    template class BasicOpenMPBitonicSorter<T>; \
+    template class BasicOpenMPSIMDBitonicSorter<T>;
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_OPENMP_SORTER)
+#undef INSTANTIATE_OPENMP_SORTER
@@ -6,26 +6,125 @@
 #include <string>
 #include <algorithm> // For std::min
 #include <stdexcept> // For std::invalid_argument
+#include "simd_kernels.h"
 // No specific OpenMP header needed for most directives, but omp.h can be used for runtime functions like omp_get_max_threads()
 #include <omp.h>
 
-class OpenMPBitonicSorter : public BitonicSort {
+// Thread placement for the sorter's parallel region. Default adds no proc_bind clause, so
+// OMP_PROC_BIND (or the runtime's default) decides; Close packs the team onto places next
+// to the calling thread, Spread distributes it evenly over the available places.
+enum class OpenMPProcBind {
+    Default,
+    Close,
+    Spread
+};
+
+template <typename T>
+class BasicOpenMPBitonicSorter : public BasicBitonicSort<T> {
 public:
-    OpenMPBitonicSorter(); // Constructor can set default num_threads if needed, or rely on OMP_NUM_THREADS
-    ~OpenMPBitonicSorter() override = default;
+    // num_threads = 0 uses omp_get_max_threads() at construction time. Tasks are spawned only
+    // down to task_cutoff_depth levels of recursion; AUTO_TASK_CUTOFF_DEPTH picks enough
+    // levels for about eight tasks per thread. Every setting is applied per sort through
+    // clauses on the sorter's own parallel region, so sorters with different budgets can
+    // share a process without touching OMP_NUM_THREADS. Throws std::invalid_argument for a
+    // negative num_threads or a cutoff depth below AUTO_TASK_CUTOFF_DEPTH.
+    explicit BasicOpenMPBitonicSorter(int num_threads = 0, OpenMPProcBind proc_bind = OpenMPProcBind::Default,
+                                      int task_cutoff_depth = AUTO_TASK_CUTOFF_DEPTH);
+    ~BasicOpenMPBitonicSorter() override = default;
+
+    static const int AUTO_TASK_CUTOFF_DEPTH = -1;
+
+    int getNumThreads() const { return num_threads_; }
+    OpenMPProcBind getProcBind() const { return proc_bind_; }
+    int getTaskCutoffDepth() const { return task_cutoff_depth_; }
 
-    void sort(std::vector<int>& arr, SortOrder order) override;
+    using payload_type = typename BasicBitonicSort<T>::payload_type;
+
+    using BasicBitonicSort<T>::sort;
+    using BasicBitonicSort<T>::sortPairs;
+    void sort(T* data, std::size_t count, SortOrder order) override;
+    void sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) override;
+    // The single bitonic merge of the default, run as tasks in the sorter's parallel region
+    using BasicBitonicSort<T>::merge;
+    void merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, SortOrder order) override;
     std::string getName() const override;
 
+    // Zero fields restore SEQUENTIAL_THRESHOLD_OMP and PARALLEL_COMPARE_GRAIN_OMP, or their
+    // _SIMD versions with SIMD leaves. Throws std::invalid_argument for negative ones. Not
+    // safe while a sort is running.
+    void setThresholds(ParallelThresholds thresholds);
+    ParallelThresholds getThresholds() const { return thresholds_; }
+
+    // Defaults: subproblems up to SEQUENTIAL_THRESHOLD_OMP keys spawn no tasks, and a merge
+    // level's compare-exchange loop is a taskloop with grainsize PARALLEL_COMPARE_GRAIN_OMP
+    static const int SEQUENTIAL_THRESHOLD_OMP = 1024;
+    static const int PARALLEL_COMPARE_GRAIN_OMP = 4096;
+    // Defaults with SIMD leaves (BasicOpenMPSIMDBitonicSorter), as SIMDBitonicSorter's: the
+    // vector network does a task's worth of work in far fewer cycles
+    static const int SEQUENTIAL_THRESHOLD_OMP_SIMD = (1 << 16) - 1;
+    static const int PARALLEL_COMPARE_GRAIN_OMP_SIMD = 1 << 13;
+
+protected:
+    // leaf_kernels run everything below the task levels and the chunks of each merge level's
+    // compare-exchange loop; null keeps BasicBitonicSort's scalar network there
+    BasicOpenMPBitonicSorter(const SIMDKernels<T>* leaf_kernels, int num_threads, OpenMPProcBind proc_bind,
+                             int task_cutoff_depth);
+
+    const SIMDKernels<T>* getLeafKernels() const { return leaf_kernels_; }
+
 private:
-    // Threshold for switching to sequential sort
-    static const int SEQUENTIAL_THRESHOLD_OMP = 1024; // Potentially tune this
+    int num_threads_;
+    OpenMPProcBind proc_bind_;
+    int task_cutoff_depth_;
+    const SIMDKernels<T>* leaf_kernels_;
+    ParallelThresholds thresholds_{SEQUENTIAL_THRESHOLD_OMP, PARALLEL_COMPARE_GRAIN_OMP};
+
+    // Arr is T* for sort() and KeyValueArrays for sortPairs()
+    // depth counts the task levels above this call; at task_cutoff_depth_ the
+    // remaining work runs inline in the current task.
+    template <typename Arr>
+    void bitonicSortRecursiveOMP(Arr& arr, int low, int count, SortOrder order, int depth);
+    template <typename Arr>
+    void bitonicMergeOMP(Arr& arr, int low, int count, SortOrder order, int depth);
+    // Runs the whole recursion (only the merge, with merge_only) in one parallel region
+    // with this sorter's thread and binding clauses
+    template <typename Arr>
+    void runParallelRegion(Arr& arr, int count, SortOrder order, bool merge_only = false);
+    template <typename Arr>
+    void runRecursion(Arr& arr, int count, SortOrder order, bool merge_only);
+
+    // Whether the leaf kernels take Arr: the 16-bit kernels have no key/value versions
+    template <typename Arr>
+    bool hasLeafKernels() const;
+    // The SIMD counterparts of the sequential steps, on arr[low, low + count)
+    void sortLeafSIMD(T* arr, int low, int count, SortOrder order);
+    void sortLeafSIMD(const typename BasicBitonicSort<T>::KeyValueArrays& kv, int low, int count, SortOrder order);
+    void mergeLeafSIMD(T* arr, int low, int count, SortOrder order);
+    void mergeLeafSIMD(const typename BasicBitonicSort<T>::KeyValueArrays& kv, int low, int count, SortOrder order);
+    // Compare-exchanges arr[i] with arr[i + k] for i in [begin, end); streaming bypasses the cache
+    template <typename Arr>
+    void compareExchangeRange(Arr& arr, int begin, int end, int k, SortOrder order, bool streaming);
+};
 
-    void bitonicSortRecursiveOMP(std::vector<int>& arr, int low, int count, SortOrder order);
-    void bitonicMergeOMP(std::vector<int>& arr, int low, int count, SortOrder order);
+using OpenMPBitonicSorter = BasicOpenMPBitonicSorter<int>;
 
-    void padData(std::vector<int>& arr, int& original_size, int& padded_size, SortOrder order);
-    void unpadData(std::vector<int>& arr, int original_size, int padded_size);
+// Both axes at once: OpenMP tasks over the upper levels of the sort and merge recursions
+// and over the chunks of each large merge level, as BasicOpenMPBitonicSorter, with the SIMD
+// kernels of BasicSIMDBitonicSorter in every leaf and chunk. BasicSIMDBitonicSorter on a
+// WorkStealingThreadPool is the same combination on std::thread workers.
+template <typename T>
+class BasicOpenMPSIMDBitonicSorter : public BasicOpenMPBitonicSorter<T> {
+public:
+    // As BasicOpenMPBitonicSorter's, plus the kernels' ISA (see BasicSIMDBitonicSorter)
+    explicit BasicOpenMPSIMDBitonicSorter(SIMDIsa isa = SIMDIsa::Auto, int num_threads = 0,
+                                          OpenMPProcBind proc_bind = OpenMPProcBind::Default,
+                                          int task_cutoff_depth = BasicOpenMPBitonicSorter<T>::AUTO_TASK_CUTOFF_DEPTH);
+    ~BasicOpenMPSIMDBitonicSorter() override = default;
+
+    std::string getName() const override;
+    SIMDIsa getIsa() const { return this->getLeafKernels()->isa; }
 };
 
+using OpenMPSIMDBitonicSorter = BasicOpenMPSIMDBitonicSorter<int>;
+
 #endif // OPENMP_BITONIC_SORTER_H
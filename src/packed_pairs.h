@@ -0,0 +1,28 @@
+#ifndef PACKED_PAIRS_H
+#define PACKED_PAIRS_H
+
+#include "bitonic_sort.h"
+#include <cstdint>
+#include <type_traits>
+
+// 16-bit keys have no payload of their own width to share SIMD lanes with, so sorters
+// that vectorize sortPairs turn each pair into one int64: the key's bits in an
+// order-preserving form above the 32-bit payload, in packed[0, count).
+template <typename T>
+void sortPairsPacked(BasicBitonicSort<std::int64_t>& wide_sorter, T* keys, PayloadOf<T>* values, std::size_t count,
+                     SortOrder order, std::int64_t* packed) {
+    static_assert(sizeof(T) == 2, "only 16-bit keys are packed");
+    const std::uint16_t flip = std::is_signed<T>::value ? 0x8000 : 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t key_bits = static_cast<std::uint16_t>(static_cast<std::uint16_t>(keys[i]) ^ flip);
+        packed[i] = static_cast<std::int64_t>((key_bits << 32) | values[i]);
+    }
+    wide_sorter.sort(packed, count, order);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t bits = static_cast<std::uint64_t>(packed[i]);
+        keys[i] = static_cast<T>(static_cast<std::uint16_t>((bits >> 32) ^ flip));
+        values[i] = static_cast<std::uint32_t>(bits);
+    }
+}
+
+#endif // PACKED_PAIRS_H
@@ -1,57 +1,32 @@
 #include "plain_bitonic_sorter.h"
-#include <cmath> // For std::pow, std::log2, std::ceil
-#include <limits> // For std::numeric_limits
-
-void PlainBitonicSorter::padData(std::vector<int>& arr, int& original_size, int& padded_size, SortOrder order) { // Add SortOrder parameter
-    original_size = arr.size();
-    if (original_size == 0) {
-        padded_size = 0;
-        return;
-    }
-    // Calculate the next power of 2
-    padded_size = std::pow(2, std::ceil(std::log2(original_size)));
-    if (padded_size > original_size) {
-        // Pad with a value larger than any expected element for ascending sort,
-        // or smaller for descending sort.
-        int padding_value = (order == SortOrder::Ascending) ? std::numeric_limits<int>::max() : std::numeric_limits<int>::min();
-        arr.resize(padded_size, padding_value);
+#include "static_bitonic_sorter.h"
+
+template <typename T>
+void BasicPlainBitonicSorter<T>::sort(T* data, std::size_t count, SortOrder order) {
+    if (count > 1) {
+        SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+        if (sortWithStaticNetwork(data, count, order)) { // Small power-of-two sizes, unrolled
+            countKernelCompareExchanges(bitonicSortComparators(count), false);
+            return;
+        }
+        this->bitonicSortRecursive(data, 0, this->checkedCount(count), order);
     }
 }
 
-void PlainBitonicSorter::unpadData(std::vector<int>& arr, int original_size, int padded_size) {
-    if (padded_size > original_size) {
-        arr.resize(original_size);
+template <typename T>
+void BasicPlainBitonicSorter<T>::sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) {
+    if (count > 1) {
+        SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+        typename BasicBitonicSort<T>::KeyValueArrays kv{keys, values};
+        this->bitonicSortRecursive(kv, 0, this->checkedCount(count), order);
     }
 }
 
-void PlainBitonicSorter::sort(std::vector<int>& arr, SortOrder order) {
-    if (arr.empty()) {
-        return;
-    }
-
-    int original_size = 0;
-    int padded_size = 0;
-
-    // Check if size is a power of 2. If not, pad it.
-    bool is_power_of_two = (arr.size() > 0) && ((arr.size() & (arr.size() - 1)) == 0);
-
-    if (!is_power_of_two) {
-        // original_size and padded_size are passed by reference and set in padData
-        padData(arr, original_size, padded_size, order);
-    } else {
-        original_size = arr.size();
-        padded_size = arr.size();
-    }
-
-    if (padded_size > 0) { // Ensure array is not empty after padding
-      bitonicSortRecursive(arr, 0, padded_size, order);
-    }
-
-    if (!is_power_of_two && padded_size > 0) { // Ensure unpadding only if padding happened and array was not empty
-        unpadData(arr, original_size, padded_size);
-    }
+template <typename T>
+std::string BasicPlainBitonicSorter<T>::getName() const {
+    return "PlainBitonicSorter" + keyTypeSuffix<T>();
 }
 
-std::string PlainBitonicSorter::getName() const {
-    return "PlainBitonicSorter";
-}
+#define INSTANTIATE_PLAIN_SORTER(T) template class BasicPlainBitonicSorter<T>;
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_PLAIN_SORTER)
+#undef INSTANTIATE_PLAIN_SORTER
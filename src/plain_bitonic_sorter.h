@@ -7,20 +7,23 @@
 #include <algorithm> // For std::is_sorted and std::sort (for correctness check in main, not in sort itself)
 #include <stdexcept> // For std::invalid_argument
 
-class PlainBitonicSorter : public BitonicSort {
+template <typename T>
+class BasicPlainBitonicSorter : public BasicBitonicSort<T> {
 public:
-    PlainBitonicSorter() = default;
-    ~PlainBitonicSorter() override = default;
+    BasicPlainBitonicSorter() = default;
+    ~BasicPlainBitonicSorter() override = default;
 
-    void sort(std::vector<int>& arr, SortOrder order) override;
-    std::string getName() const override;
+    using payload_type = typename BasicBitonicSort<T>::payload_type;
 
-private:
-    // The recursive sort and merge functions are already in the base class
-    // and can be called directly if arr.size() is a power of 2.
-    // This implementation will handle non-power-of-2 sizes by padding.
-    void padData(std::vector<int>& arr, int& original_size, int& padded_size, SortOrder order); // Add SortOrder parameter
-    void unpadData(std::vector<int>& arr, int original_size, int padded_size);
+    using BasicBitonicSort<T>::sort;
+    using BasicBitonicSort<T>::sortPairs;
+    void sort(T* data, std::size_t count, SortOrder order) override;
+    void sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) override;
+    std::string getName() const override;
+    // The recursive sort and merge functions are in the base class and handle any size
+    // in place, without padding.
 };
 
+using PlainBitonicSorter = BasicPlainBitonicSorter<int>;
+
 #endif // PLAIN_BITONIC_SORTER_H
@@ -1,160 +1,393 @@
 #include "simd_bitonic_sorter.h"
-#include <cmath>    // For std::pow, std::log2, std::ceil
-#include <limits>   // For std::numeric_limits
+#include "packed_pairs.h"
+#include "merge_path.h"
 #include <iostream> // For debugging
-#include <cstdio>   // For printf, if using print_m128i
 
-// Helper to print __m128i for debugging (optional)
-// void print_m128i(__m128i var) {
-//     alignas(16) int val[4];
-//     _mm_store_si128((__m128i*)val, var);
-//     printf("SIMD: %d %d %d %d\n", val[0], val[1], val[2], val[3]);
-// }
+template <typename T>
+BasicSIMDBitonicSorter<T>::BasicSIMDBitonicSorter(SIMDIsa isa)
+    : kernels_(&selectSIMDKernels<T>(isa)) {
+}
 
-SIMDBitonicSorter::SIMDBitonicSorter() {
-    // Constructor can check for CPU support if needed, though CMake should handle arch flags.
+template <typename T>
+BasicSIMDBitonicSorter<T>::BasicSIMDBitonicSorter(SIMDIsa isa, std::shared_ptr<WorkStealingThreadPool> pool)
+    : kernels_(&selectSIMDKernels<T>(isa)), pool_(std::move(pool)) {
+    this->stats_.setThreadCount(pool_ ? pool_->getWorkerCount() + 1 : 1);
 }
 
-void SIMDBitonicSorter::padData(std::vector<int>& arr, int& original_size, int& padded_size, SortOrder order) {
-    original_size = arr.size();
-    if (original_size == 0) {
-        padded_size = 0;
-        return;
-    }
-    // Pad to next power of 2 for bitonic sort requirement
-    padded_size = std::pow(2, std::ceil(std::log2(original_size)));
+template <typename T>
+void BasicSIMDBitonicSorter<T>::setThresholds(ParallelThresholds thresholds) {
+    thresholds_ = resolveThresholds(thresholds, {PARALLEL_THRESHOLD_SIMD - 1, PARALLEL_COMPARE_GRAIN_SIMD});
+}
 
-    // Further pad to be a multiple of SIMD_WIDTH if necessary, though the merge logic should handle tails.
-    // For simplicity, the main padding is to power-of-2. The SIMD merge will handle internal tails.
-    if (padded_size > original_size) {
-        arr.resize(padded_size, (order == SortOrder::Ascending) ? std::numeric_limits<int>::max() : std::numeric_limits<int>::min());
+template <typename T>
+void BasicSIMDBitonicSorter<T>::sort(T* data, std::size_t count, SortOrder order) {
+    if (count > 1) {
+        SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+        bitonicSortRecursiveSIMD(data, this->checkedCount(count), order);
     }
 }
 
-void SIMDBitonicSorter::unpadData(std::vector<int>& arr, int original_size, int padded_size) {
-    if (padded_size > original_size) {
-        arr.resize(original_size);
+template <typename T>
+void BasicSIMDBitonicSorter<T>::sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) {
+    if (count <= 1) {
+        return;
+    }
+    SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+    if constexpr (sizeof(T) == 2) {
+        BasicSIMDBitonicSorter<std::int64_t> wide_sorter(kernels_->isa, pool_);
+        wide_sorter.setThresholds(thresholds_);
+        SortWorkspace::Lease workspace(this->workspace_);
+        sortPairsPacked(wide_sorter, keys, values, count, order, workspace.get<std::int64_t>(0, count));
+        this->stats_.add(wide_sorter.getStats(), true);
+    } else {
+        bitonicSortRecursivePairsSIMD(keys, values, this->checkedCount(count), order);
     }
 }
 
-void SIMDBitonicSorter::sort(std::vector<int>& arr, SortOrder order) {
-    if (arr.empty()) {
-        return;
+template <typename T>
+void BasicSIMDBitonicSorter<T>::sortSegments(T* data, const std::size_t* offsets, std::size_t num_segments,
+                                             SortOrder order) {
+    this->checkSegmentOffsets(offsets, num_segments);
+    SortStatsCall call(&this->stats_, SortPhase::Sort, num_segments > 0 ? offsets[num_segments] - offsets[0] : 0);
+    const int width = kernels_->width;
+    // Below half a register block, sorting a lane's worth of segments at once beats the
+    // in-register sort of each one; from there on that beats the transposes
+    const int column_limit = (width > 1) ? kernels_->blockSize / 2 : 0;
+
+    // Scratch for the indices, batches and lane columns, all from the workspace. Slot 0:
+    // per_length and next (column_limit + 1 each), then by_length and long_segments (up
+    // to num_segments each).
+    SortWorkspace::Lease workspace(this->workspace_);
+    const std::size_t lengths = static_cast<std::size_t>(column_limit) + 1;
+    std::size_t* per_length = workspace.get<std::size_t>(0, 2 * lengths + 2 * num_segments);
+    std::size_t* next = per_length + lengths;
+    std::size_t* by_length = next + lengths;
+    std::size_t* long_segments = by_length + num_segments;
+    std::size_t long_count = 0;
+
+    // Counting sort of the short segments' indices by length
+    std::fill(per_length, per_length + lengths, std::size_t(0));
+    for (std::size_t s = 0; s < num_segments; ++s) {
+        std::size_t length = offsets[s + 1] - offsets[s];
+        if (length > 1 && length < static_cast<std::size_t>(column_limit)) {
+            ++per_length[length + 1];
+        }
+    }
+    for (int length = 1; length <= column_limit; ++length) {
+        per_length[length] += per_length[length - 1];
     }
+    // per_length[L] is now where segments of length L start in by_length
+    std::copy(per_length, per_length + lengths, next);
 
-    int original_size = 0;
-    int padded_size = 0;
-    bool is_power_of_two = (arr.size() > 0) && ((arr.size() & (arr.size() - 1)) == 0);
+    // A batch is up to width equal-length segments sorted across lanes, or one segment
+    // sorted on its own (count == 0; begin is then the segment index). Every batch holds
+    // a segment, so there are at most num_segments.
+    struct SegmentBatch {
+        std::size_t begin;
+        int count;
+        int length;
+    };
+    SegmentBatch* batches = workspace.get<SegmentBatch>(1, num_segments);
+    int batch_count = 0;
+    for (std::size_t s = 0; s < num_segments; ++s) {
+        std::size_t length = offsets[s + 1] - offsets[s];
+        if (length <= 1) {
+            continue;
+        }
+        if (length < static_cast<std::size_t>(column_limit)) {
+            by_length[next[length]++] = s;
+        } else if (length <= static_cast<std::size_t>(thresholds_.sequential)) {
+            batches[batch_count++] = {s, 0, static_cast<int>(length)};
+        } else {
+            long_segments[long_count++] = s; // Parallel within the segment instead
+        }
+    }
+    for (int length = 2; length < column_limit; ++length) {
+        std::size_t end = per_length[length + 1];
+        for (std::size_t begin = per_length[length]; begin < end; begin += width) {
+            int count = static_cast<int>(std::min<std::size_t>(width, end - begin));
+            if (2 * count >= width) {
+                batches[batch_count++] = {begin, count, length};
+            } else {
+                // Too few left to pay for the transposes
+                for (int i = 0; i < count; ++i) {
+                    batches[batch_count++] = {by_length[begin + i], 0, length};
+                }
+            }
+        }
+    }
 
-    if (!is_power_of_two) { // Pad if not power of two
-        padData(arr, original_size, padded_size, order);
-    } else {
-        original_size = arr.size();
-        padded_size = arr.size();
+    // Pool tasks of whole SEGMENT_BATCH_GRAIN multiples, a few per thread as parallelFor
+    // would cut them, so that each task's lane columns fit in slot 2
+    int tasks = 1;
+    if (pool_ && pool_->getWorkerCount() > 0) {
+        const int threads = static_cast<int>(pool_->getWorkerCount()) + 1;
+        tasks = std::max(1, std::min((batch_count + SEGMENT_BATCH_GRAIN - 1) / SEGMENT_BATCH_GRAIN,
+                                     threads * WorkStealingThreadPool::CHUNKS_PER_THREAD));
     }
+    int per_task = (batch_count + tasks - 1) / tasks;
+    per_task = (per_task + SEGMENT_BATCH_GRAIN - 1) / SEGMENT_BATCH_GRAIN * SEGMENT_BATCH_GRAIN;
+    const std::size_t column_keys = static_cast<std::size_t>(column_limit) * width;
+    T* all_columns = workspace.get<T>(2, tasks * column_keys);
 
-    // Ensure padded size is appropriate for SIMD operations if it's very small
-    // This check might be refined. The main concern is if padded_size < SIMD_WIDTH.
-    if (padded_size > 0 && padded_size < SIMD_WIDTH && padded_size < original_size) {
-         // If original was small, padding might make it SIMD_WIDTH, then unpadding is fine.
-         // If original was tiny (e.g. 1) and padded_size became, say, 4, it's handled.
-         // This logic is mainly for the recursive calls.
+    auto run_batches = [&](int task) {
+        SortStatsTimer timer(&this->stats_, SortPhase::Sort);
+        T* columns = all_columns + task * column_keys;
+        const int last = std::min(batch_count, (task + 1) * per_task);
+        for (int b = task * per_task; b < last; ++b) {
+            const SegmentBatch& batch = batches[b];
+            if (batch.count == 0) {
+                bitonicSortRecursiveSIMD(data + offsets[batch.begin], batch.length, order);
+                continue;
+            }
+            // Segment l goes to lane l; lanes past count keep stale keys and are ignored
+            for (int l = 0; l < batch.count; ++l) {
+                const T* segment = data + offsets[by_length[batch.begin + l]];
+                for (int i = 0; i < batch.length; ++i) {
+                    columns[i * width + l] = segment[i];
+                }
+            }
+            kernels_->sortColumns(columns, batch.length, order);
+            countKernelCompareExchanges(*kernels_, batch.count * bitonicSortComparators(batch.length));
+            for (int l = 0; l < batch.count; ++l) {
+                T* segment = data + offsets[by_length[batch.begin + l]];
+                for (int i = 0; i < batch.length; ++i) {
+                    segment[i] = columns[i * width + l];
+                }
+            }
+        }
+    };
+    if (tasks > 1) {
+        pool_->parallelFor(0, tasks, 1, [&](int first, int last) {
+            for (int task = first; task < last; ++task) {
+                run_batches(task);
+            }
+        });
+    } else {
+        run_batches(0);
     }
 
+    for (std::size_t i = 0; i < long_count; ++i) {
+        const std::size_t s = long_segments[i];
+        bitonicSortRecursiveSIMD(data + offsets[s], static_cast<int>(offsets[s + 1] - offsets[s]), order);
+    }
+}
 
-    if (padded_size > 0) {
-       bitonicSortRecursiveSIMD(arr, 0, padded_size, order);
+template <typename T>
+std::size_t BasicSIMDBitonicSorter<T>::topK(const T* data, std::size_t count, std::size_t k, T* out,
+                                            SortOrder order) {
+    const std::size_t n = std::min(k, count);
+    if (n == 0) {
+        return 0;
+    }
+    const int best_count = this->checkedCount(n);
+    SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+    std::size_t slices = 1;
+    if (pool_ && pool_->getWorkerCount() > 0) {
+        // Every slice needs n keys to start its buffer with
+        std::size_t threads = pool_->getWorkerCount() + 1;
+        slices = std::max<std::size_t>(1, std::min({threads, count / TOPK_PARALLEL_GRAIN, count / n}));
+    }
+    // Slice s keeps its candidate chunk in chunks[s * n, (s + 1) * n)
+    SortWorkspace::Lease workspace(this->workspace_);
+    T* chunks = workspace.get<T>(1, slices * n);
+    if (slices == 1) {
+        topKSlice(data, count, out, best_count, order, chunks);
+        return n;
     }
 
-    if (!is_power_of_two && padded_size > 0) {
-        unpadData(arr, original_size, padded_size);
+    const std::size_t slice_length = count / slices;
+    // Slice s > 0 keeps its best keys in bests[(s - 1) * n, s * n)
+    T* bests = workspace.get<T>(0, (slices - 1) * n);
+    pool_->parallelFor(0, static_cast<int>(slices), 1, [&](int first, int last) {
+        SortStatsTimer timer(&this->stats_, SortPhase::Sort);
+        for (int s = first; s < last; ++s) {
+            const std::size_t begin = s * slice_length;
+            const std::size_t end = (s + 1 == static_cast<int>(slices)) ? count : begin + slice_length;
+            topKSlice(data + begin, end - begin, s == 0 ? out : bests + (s - 1) * n, best_count, order,
+                      chunks + s * n);
+        }
+    });
+    for (std::size_t s = 1; s < slices; ++s) {
+        topKSlice(bests + (s - 1) * n, n, out, best_count, order, chunks, true);
     }
+    return n;
 }
 
-std::string SIMDBitonicSorter::getName() const {
-    return "SIMDBitonicSorter (SSE)"; // Or detect AVX/AVX2 later
+template <typename T>
+void BasicSIMDBitonicSorter<T>::merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out,
+                                      SortOrder order) {
+    const int count = this->checkedCount(na + nb);
+    SortStatsCall call(&this->stats_, SortPhase::Merge, count);
+    const bool parallel = pool_ && pool_->getWorkerCount() > 0;
+    mergeSortedPieces(*kernels_, a, na, b, nb, out, order, parallel ? MERGE_PIECE_KEYS : std::max(count, 1),
+                      [&](int pieces, auto&& fn) {
+                          if (parallel) {
+                              pool_->parallelFor(0, pieces, 1, [&](int first, int last) {
+                                  SortStatsTimer timer(&this->stats_, SortPhase::Merge);
+                                  fn(first, last);
+                              });
+                          } else {
+                              fn(0, pieces);
+                          }
+                      });
+    countKernelCompareExchanges(*kernels_, mergeSortedComparators(*kernels_, count));
 }
 
-// This is the core SIMD part for compare & swap of two blocks of SIMD_WIDTH elements
-void SIMDBitonicSorter::compareAndSwapBlockSIMD(std::vector<int>& arr, int L_idx, int R_idx, SortOrder order) {
-    // Ensure indices are valid and there's enough data for a full SIMD block from each index
-    // This function assumes L_idx and R_idx are starting points of SIMD_WIDTH blocks
-    // And that arr has enough elements: arr[L_idx+SIMD_WIDTH-1] and arr[R_idx+SIMD_WIDTH-1] are valid
-
-    // Load data from memory (unaligned loads for now for simplicity, can impact performance)
-    __m128i block_L = _mm_loadu_si128((__m128i*)&arr[L_idx]);
-    __m128i block_R = _mm_loadu_si128((__m128i*)&arr[R_idx]);
-
-    __m128i min_vals, max_vals;
-
-    if (order == SortOrder::Ascending) {
-        min_vals = _mm_min_epi32(block_L, block_R); // SSE4.1
-        max_vals = _mm_max_epi32(block_L, block_R); // SSE4.1
-        _mm_storeu_si128((__m128i*)&arr[L_idx], min_vals);
-        _mm_storeu_si128((__m128i*)&arr[R_idx], max_vals);
-    } else { // Descending
-        min_vals = _mm_min_epi32(block_L, block_R); // SSE4.1
-        max_vals = _mm_max_epi32(block_L, block_R); // SSE4.1
-        _mm_storeu_si128((__m128i*)&arr[L_idx], max_vals);
-        _mm_storeu_si128((__m128i*)&arr[R_idx], min_vals);
-    }
-    // Note: This simple min/max swap works if block_L elements are compared against block_R elements
-    // in a bitonic context where L items should be smaller (or larger) than R items.
-    // This is NOT a full sort of 2*SIMD_WIDTH items. It's a direct parallel of:
-    // for i=0 to SIMD_WIDTH-1: compareAndSwap(arr, L_idx+i, R_idx+i, order)
+// Fills best with data's first n keys, sorted, then streams the rest through it, collecting
+// candidates in chunk[0, n); with merge_into, best already holds n sorted keys and all of
+// data is streamed
+template <typename T>
+void BasicSIMDBitonicSorter<T>::topKSlice(const T* data, std::size_t count, T* best, int n, SortOrder order,
+                                          T* chunk, bool merge_into) {
+    if (!merge_into) {
+        std::copy(data, data + n, best);
+        bitonicSortRecursiveSIMD(best, n, order);
+        data += n;
+        count -= n;
+    }
+    this->topKStream(
+        data, count, best, n, order, chunk, [&](T* chunk, int m, SortOrder o) { bitonicSortRecursiveSIMD(chunk, m, o); },
+        [&](T* winners, T* chunk, int m, SortOrder o) {
+            kernels_->compareAndSwapBlocks(winners, chunk, m, o);
+            countKernelCompareExchanges(*kernels_, m);
+        },
+        [&](T* arr, int m, SortOrder o) {
+            kernels_->bitonicMerge(arr, m, o);
+            countKernelCompareExchanges(*kernels_, bitonicMergeComparators(m));
+        });
 }
 
+template <typename T>
+std::string BasicSIMDBitonicSorter<T>::getName() const {
+    std::string threads = pool_ ? ", " + std::to_string(pool_->getWorkerCount() + 1) + " threads" : "";
+    return "SIMDBitonicSorter" + keyTypeSuffix<T>() + " (" + simdIsaName(kernels_->isa) + threads + ")";
+}
 
-void SIMDBitonicSorter::bitonicSortRecursiveSIMD(std::vector<int>& arr, int low, int count, SortOrder order) {
+template <typename T>
+void BasicSIMDBitonicSorter<T>::bitonicSortRecursiveSIMD(T* arr, int count, SortOrder order) {
     if (count <= 1) {
         return;
     }
 
-    if (count < SEQUENTIAL_THRESHOLD_SIMD) { // Use scalar version for small subproblems
-        BitonicSort::bitonicSortRecursive(arr, low, count, order);
+    if (count <= kernels_->blockSize) { // Small subproblems are sorted entirely in registers
+        kernels_->sortBlock(arr, count, order);
+        countKernelCompareExchanges(*kernels_, bitonicSortComparators(count));
         return;
     }
 
-    int k = count / 2;
-    // Sort first half in ascending order
-    bitonicSortRecursiveSIMD(arr, low, k, SortOrder::Ascending);
-    // Sort second half in descending order
-    bitonicSortRecursiveSIMD(arr, low + k, k, SortOrder::Descending);
+    // Power-of-two first part sorted against the final order, the rest along it (see
+    // BasicBitonicSort::bitonicMerge); the first part stays block-aligned at every level
+    int k = this->splitPoint(count);
+    SortOrder first_order = this->oppositeOrder(order);
+    if (runsParallel(count)) {
+        WorkStealingThreadPool::TaskGroup group;
+        pool_->submit(group, [&] {
+            SortStatsTimer timer(&this->stats_, SortPhase::Sort);
+            bitonicSortRecursiveSIMD(arr, k, first_order);
+        });
+        bitonicSortRecursiveSIMD(arr + k, count - k, order);
+        pool_->wait(group);
+    } else {
+        bitonicSortRecursiveSIMD(arr, k, first_order);
+        bitonicSortRecursiveSIMD(arr + k, count - k, order);
+    }
 
     // Merge the whole sequence
-    bitonicMergeSIMD(arr, low, count, order);
+    SortStatsTimer timer(count > SortStats::MIN_TIMED_KEYS ? &this->stats_ : nullptr, SortPhase::Merge);
+    bitonicMergeSIMD(arr, count, order);
 }
 
-void SIMDBitonicSorter::bitonicMergeSIMD(std::vector<int>& arr, int low, int count, SortOrder order) {
-    if (count <= 1) {
+template <typename T>
+void BasicSIMDBitonicSorter<T>::bitonicMergeSIMD(T* arr, int count, SortOrder order) {
+    if (!runsParallel(count)) {
+        // The ISA-specific kernel runs the whole merge recursion; once a subproblem fits in a
+        // register block the remaining strides are done with in-register permutes.
+        kernels_->bitonicMerge(arr, count, order);
+        countKernelCompareExchanges(*kernels_, bitonicMergeComparators(count));
         return;
     }
 
-    // Adjusted threshold for SIMD merge: ensure enough elements for at least one SIMD block comparison.
-    if (count < 2 * SIMD_WIDTH || count < SEQUENTIAL_THRESHOLD_SIMD ) {
-        BitonicSort::bitonicMerge(arr, low, count, order);
+    // Large levels: the compare-exchange loop is split into chunks across the pool, then the
+    // two half merges run in parallel
+    int k = this->splitPoint(count);
+    // Passes much larger than the last-level cache bypass it with non-temporal stores
+    const auto compare_and_swap = count * sizeof(T) > streamingStoreThresholdBytes()
+                                      ? kernels_->compareAndSwapBlocksStreaming
+                                      : kernels_->compareAndSwapBlocks;
+    {
+        SortStatsStride stride(&this->stats_, k, count - k);
+        pool_->parallelFor(0, count - k, thresholds_.compare_grain, [&](int begin, int end) {
+            SortStatsTimer timer(&this->stats_, SortPhase::Merge);
+            compare_and_swap(arr + begin, arr + k + begin, end - begin, order);
+            countKernelCompareExchanges(*kernels_, end - begin);
+        });
+    }
+    WorkStealingThreadPool::TaskGroup group;
+    pool_->submit(group, [&] {
+        SortStatsTimer timer(&this->stats_, SortPhase::Merge);
+        bitonicMergeSIMD(arr, k, order);
+    });
+    bitonicMergeSIMD(arr + k, count - k, order);
+    pool_->wait(group);
+}
+
+template <typename T>
+void BasicSIMDBitonicSorter<T>::bitonicSortRecursivePairsSIMD(T* keys, payload_type* values, int count, SortOrder order) {
+    if (count <= 1) {
         return;
     }
 
-    int k = count / 2; // k is the distance for comparison
+    if (count <= kernels_->pairBlockSize) {
+        kernels_->sortBlockPairs(keys, values, count, order);
+        countKernelCompareExchanges(*kernels_, bitonicSortComparators(count));
+        return;
+    }
 
-    // Process full SIMD blocks
-    // The loop iterates for (i from low to low + k - 1)
-    // We process elements in chunks of SIMD_WIDTH.
-    // The number of actual compareAndSwap operations is k.
-    // So, we iterate k/SIMD_WIDTH times for SIMD blocks.
-    int num_simd_ops = k / SIMD_WIDTH;
-    for (int i = 0; i < num_simd_ops; ++i) {
-        compareAndSwapBlockSIMD(arr, low + i * SIMD_WIDTH, low + i * SIMD_WIDTH + k, order);
+    int k = this->splitPoint(count);
+    SortOrder first_order = this->oppositeOrder(order);
+    if (runsParallel(count)) {
+        WorkStealingThreadPool::TaskGroup group;
+        pool_->submit(group, [&] {
+            SortStatsTimer timer(&this->stats_, SortPhase::Sort);
+            bitonicSortRecursivePairsSIMD(keys, values, k, first_order);
+        });
+        bitonicSortRecursivePairsSIMD(keys + k, values + k, count - k, order);
+        pool_->wait(group);
+    } else {
+        bitonicSortRecursivePairsSIMD(keys, values, k, first_order);
+        bitonicSortRecursivePairsSIMD(keys + k, values + k, count - k, order);
     }
+    SortStatsTimer timer(count > SortStats::MIN_TIMED_KEYS ? &this->stats_ : nullptr, SortPhase::Merge);
+    bitonicMergePairsSIMD(keys, values, count, order);
+}
 
-    // Handle remaining elements (if k is not a multiple of SIMD_WIDTH) with scalar operations
-    int processed_elements = num_simd_ops * SIMD_WIDTH;
-    for (int i = processed_elements; i < k; ++i) {
-        BitonicSort::compareAndSwap(arr, low + i, low + i + k, order);
+template <typename T>
+void BasicSIMDBitonicSorter<T>::bitonicMergePairsSIMD(T* keys, payload_type* values, int count, SortOrder order) {
+    if (!runsParallel(count)) {
+        kernels_->bitonicMergePairs(keys, values, count, order);
+        countKernelCompareExchanges(*kernels_, bitonicMergeComparators(count));
+        return;
     }
 
-    // Recursively call merge on two halves
-    bitonicMergeSIMD(arr, low, k, order);
-    bitonicMergeSIMD(arr, low + k, k, order);
+    int k = this->splitPoint(count);
+    {
+        SortStatsStride stride(&this->stats_, k, count - k);
+        pool_->parallelFor(0, count - k, thresholds_.compare_grain, [&](int begin, int end) {
+            SortStatsTimer timer(&this->stats_, SortPhase::Merge);
+            kernels_->compareAndSwapBlocksPairs(keys + begin, values + begin, k, end - begin, order);
+            countKernelCompareExchanges(*kernels_, end - begin);
+        });
+    }
+    WorkStealingThreadPool::TaskGroup group;
+    pool_->submit(group, [&] {
+        SortStatsTimer timer(&this->stats_, SortPhase::Merge);
+        bitonicMergePairsSIMD(keys, values, k, order);
+    });
+    bitonicMergePairsSIMD(keys + k, values + k, count - k, order);
+    pool_->wait(group);
 }
+
+#define INSTANTIATE_SIMD_SORTER(T) template class BasicSIMDBitonicSorter<T>;
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_SIMD_SORTER)
+#undef INSTANTIATE_SIMD_SORTER
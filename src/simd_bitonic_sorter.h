@@ -6,35 +6,91 @@
 #include <string>
 #include <algorithm> // For std::min, std::is_sorted
 #include <stdexcept> // For std::invalid_argument
+#include <memory>    // For std::shared_ptr
+#include "simd_kernels.h"
+#include "work_stealing_thread_pool.h"
 
-// Include header for x86 intrinsics
-#include <immintrin.h>
-
-class SIMDBitonicSorter : public BitonicSort {
+template <typename T>
+class BasicSIMDBitonicSorter : public BasicBitonicSort<T> {
 public:
-    SIMDBitonicSorter();
-    ~SIMDBitonicSorter() override = default;
+    // Kernels are chosen at runtime via CPUID. Requesting an ISA the CPU lacks falls back
+    // to the widest supported one, so getName() always reports what actually runs.
+    explicit BasicSIMDBitonicSorter(SIMDIsa isa = SIMDIsa::Auto);
+    // Additionally runs large levels on pool: both halves of the sort recursion, both halves
+    // of each merge, and the chunks of each merge level's compare-exchange loop
+    BasicSIMDBitonicSorter(SIMDIsa isa, std::shared_ptr<WorkStealingThreadPool> pool);
+    ~BasicSIMDBitonicSorter() override = default;
+
+    using payload_type = typename BasicBitonicSort<T>::payload_type;
 
-    void sort(std::vector<int>& arr, SortOrder order) override;
+    using BasicBitonicSort<T>::sort;
+    using BasicBitonicSort<T>::sortPairs;
+    void sort(T* data, std::size_t count, SortOrder order) override;
+    // 32- and 64-bit keys move their payloads with the key compare masks; 16-bit keys are
+    // packed with their payload into 64-bit keys and sorted with the int64 kernels.
+    void sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) override;
+    // Segments shorter than half a register block are grouped by length; each group of
+    // getSIMDWidth() equal-length segments is transposed into lanes and sorted by one
+    // lane-parallel network. Longer segments, and groups too small to fill half the lanes,
+    // go straight to the kernels one by one, without a virtual call per segment. With a
+    // pool, the batches are spread across its threads.
+    using BasicBitonicSort<T>::sortSegments;
+    void sortSegments(T* data, const std::size_t* offsets, std::size_t num_segments, SortOrder order) override;
+    // With a pool, each thread streams a slice of the input into its own best-k buffer and
+    // the buffers are then streamed into the first one
+    using BasicBitonicSort<T>::topK;
+    std::size_t topK(const T* data, std::size_t count, std::size_t k, T* out, SortOrder order) override;
+    // Merge path splits the output into MERGE_PIECE_KEYS pieces across the pool (one piece
+    // without it), each merged with the mergeSorted kernel
+    using BasicBitonicSort<T>::merge;
+    void merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, SortOrder order) override;
     std::string getName() const override;
 
-    // Threshold for switching to sequential sort for small subproblems
-    // or for parts not large enough for effective SIMD.
-    static const int SEQUENTIAL_THRESHOLD_SIMD = 64; // Must be at least 2*SIMD_WIDTH for some operations
+    SIMDIsa getIsa() const { return kernels_->isa; }
+    int getSIMDWidth() const { return kernels_->width; }
+    int getBlockSize() const { return kernels_->blockSize; }
 
-private:
-    // SSE processes 4 integers at a time (128 bits / 32 bits per int)
-    static const int SIMD_WIDTH = 4;
-    // AVX2 would be 8, AVX512 would be 16
+    // With a pool: subproblems larger than thresholds.sequential are split across threads, in
+    // slices of at least thresholds.compare_grain elements for the compare-exchange loops.
+    // Zero fields restore the defaults below. Throws std::invalid_argument for negative
+    // ones. Not safe while a sort is running.
+    void setThresholds(ParallelThresholds thresholds);
+    ParallelThresholds getThresholds() const { return thresholds_; }
 
-    void bitonicSortRecursiveSIMD(std::vector<int>& arr, int low, int count, SortOrder order);
-    void bitonicMergeSIMD(std::vector<int>& arr, int low, int count, SortOrder order);
+    // Subproblems of up to getBlockSize() elements (never fewer than this) are sorted
+    // entirely in registers; nothing on the SIMD path falls back to scalar compareAndSwap.
+    // The block is a compile-time size of each ISA's register network, so this one
+    // threshold is not a runtime parameter.
+    static const int SEQUENTIAL_THRESHOLD_SIMD = SIMD_SEQUENTIAL_THRESHOLD;
+    // Default thresholds: subproblems from PARALLEL_THRESHOLD_SIMD keys on are split, in
+    // slices of PARALLEL_COMPARE_GRAIN_SIMD
+    static const int PARALLEL_THRESHOLD_SIMD = 1 << 16;
+    static const int PARALLEL_COMPARE_GRAIN_SIMD = 1 << 13;
+    // Batches per pool task in sortSegments
+    static const int SEGMENT_BATCH_GRAIN = 16;
+    // Output keys per pool task in merge
+    static const int MERGE_PIECE_KEYS = 1 << 15;
+    // Inputs per thread in topK before the stream is split across the pool
+    static const int TOPK_PARALLEL_GRAIN = 1 << 16;
 
-    // SIMD specific compare and swap for a block of elements
-    void compareAndSwapBlockSIMD(std::vector<int>& arr, int L_idx, int R_idx, SortOrder order);
+private:
+    // SSE processes 16 bytes of keys at a time, AVX2 32 and AVX-512 64
+    const SIMDKernels<T>* kernels_;
+    std::shared_ptr<WorkStealingThreadPool> pool_; // Null when single-threaded
+    ParallelThresholds thresholds_{PARALLEL_THRESHOLD_SIMD - 1, PARALLEL_COMPARE_GRAIN_SIMD};
+
+    bool runsParallel(std::size_t count) const {
+        return pool_ && pool_->getWorkerCount() > 0 && count > static_cast<std::size_t>(thresholds_.sequential);
+    }
 
-    void padData(std::vector<int>& arr, int& original_size, int& padded_size, SortOrder order);
-    void unpadData(std::vector<int>& arr, int original_size, int padded_size);
+    void bitonicSortRecursiveSIMD(T* arr, int count, SortOrder order);
+    void bitonicMergeSIMD(T* arr, int count, SortOrder order);
+    void topKSlice(const T* data, std::size_t count, T* best, int n, SortOrder order, T* chunk,
+                   bool merge_into = false);
+    void bitonicSortRecursivePairsSIMD(T* keys, payload_type* values, int count, SortOrder order);
+    void bitonicMergePairsSIMD(T* keys, payload_type* values, int count, SortOrder order);
 };
 
+using SIMDBitonicSorter = BasicSIMDBitonicSorter<int>;
+
 #endif // SIMD_BITONIC_SORTER_H
@@ -0,0 +1,62 @@
+#include "simd_kernels.h"
+#include "simd_kernels_impl.h"
+#include <cstring> // For std::memcmp
+
+namespace {
+
+// One "lane" per register; used when the CPU has no SSE4.1. With WIDTH == 1 the
+// network never needs permuteXor/blendLaneBit/selectLaneBit.
+template <typename T>
+struct ScalarOps {
+    using Key = T;
+    using Vec = T;
+    using Payload = PayloadOf<T>;
+    using PVec = Payload;
+    using Mask = bool;
+    static constexpr int WIDTH = 1;
+    static Vec load(const T* p) { return *p; }
+    static void store(T* p, Vec v) { *p = v; }
+    static Vec loadAligned(const T* p) { return *p; }
+    static void storeAligned(T* p, Vec v) { *p = v; }
+    static void storeStream(T* p, Vec v) { *p = v; }
+    static void streamFence() {}
+    static PVec loadPayload(const Payload* p) { return *p; }
+    static void storePayload(Payload* p, PVec v) { *p = v; }
+    static Vec min(Vec a, Vec b) { return SortKeyTraits<T>::less(b, a) ? b : a; }
+    static Vec max(Vec a, Vec b) { return SortKeyTraits<T>::less(b, a) ? a : b; }
+    static bool equal(Vec a, Vec b) { return std::memcmp(&a, &b, sizeof(Vec)) == 0; }
+    static Mask greater(Vec a, Vec b) { return SortKeyTraits<T>::less(b, a); }
+    template <typename V> static V select(V a, V b, Mask m) { return m ? b : a; }
+};
+
+} // namespace
+
+std::size_t streamingStoreThresholdBytes() {
+    static const std::size_t bytes = lastLevelCacheBytes() ? 2 * lastLevelCacheBytes() : std::size_t(64) << 20;
+    return bytes;
+}
+
+template <typename T>
+const SIMDKernels<T>& getScalarKernels() {
+    static const SIMDKernels<T> kernels = simd_kernels_impl::makeKernels<ScalarOps<T>>(SIMDIsa::Scalar);
+    return kernels;
+}
+
+template <typename T>
+const SIMDKernels<T>& selectSIMDKernels(SIMDIsa requested) {
+    if (requested == SIMDIsa::Auto || !cpuSupports(requested)) {
+        requested = detectBestSIMDIsa();
+    }
+    switch (requested) {
+        case SIMDIsa::AVX512: return getAVX512Kernels<T>();
+        case SIMDIsa::AVX2:   return getAVX2Kernels<T>();
+        case SIMDIsa::SSE41:  return getSSE41Kernels<T>();
+        default:              return getScalarKernels<T>();
+    }
+}
+
+#define INSTANTIATE_SIMD_KERNEL_SELECTION(T)                \
+    template const SIMDKernels<T>& getScalarKernels<T>();   \
+    template const SIMDKernels<T>& selectSIMDKernels<T>(SIMDIsa);
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_SIMD_KERNEL_SELECTION)
+#undef INSTANTIATE_SIMD_KERNEL_SELECTION
@@ -0,0 +1,91 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include "bitonic_sort.h" // For SortOrder
+#include "cpu_features.h"
+
+// Smallest in-register block any ISA uses. Subproblems up to the kernel's blockSize
+// (at least this many elements) are sorted or merged without leaving registers.
+constexpr int SIMD_SEQUENTIAL_THRESHOLD = 64;
+
+// Table of kernels for one instruction set and key type. Each ISA lives in its own
+// translation unit compiled with the matching -m flags, so only the table for a
+// supported ISA is ever called. Tables exist for every BITONIC_SORT_FOR_EACH_KEY_TYPE.
+template <typename T>
+struct SIMDKernels {
+    SIMDIsa isa;
+    int width;     // T lanes per vector register
+    int blockSize; // elements sorted entirely in registers by sortBlock
+
+    // for i in [0, count): compareAndSwap(lo[i], hi[i]) with lo/hi treated as the left/right element.
+    // Any count; a partial last vector is staged through registers like a partial block.
+    // When lo and hi are equally misaligned (any power-of-two distance of a vector or more),
+    // a staged head aligns both and the main loop uses aligned loads and stores.
+    void (*compareAndSwapBlocks)(T* lo, T* hi, int count, SortOrder order);
+
+    // compareAndSwapBlocks with non-temporal stores in the aligned main loop, for passes over
+    // more than streamingStoreThresholdBytes(): their results are evicted before they are
+    // read again, so caching the stores only costs the line fills. Fenced before returning.
+    void (*compareAndSwapBlocksStreaming)(T* lo, T* hi, int count, SortOrder order);
+
+    // Sorts arr[0, count) in registers, count <= blockSize (any count, not just powers of two)
+    void (*sortBlock)(T* arr, int count, SortOrder order);
+
+    // Bitonic merge of arr[0, count) for any count, with the same input requirement as
+    // BasicBitonicSort::bitonicMerge. Levels whose span fits in a block, including the
+    // intra-register strides, run in registers.
+    void (*bitonicMerge)(T* arr, int count, SortOrder order);
+
+    // Sorts width independent sequences of length elements stored interleaved: element i
+    // of sequence l is columns[i * width + l]. Every comparator works on whole vectors, one
+    // sequence per lane, which is how sortSegments vectorizes across segments.
+    void (*sortColumns)(T* columns, int length, SortOrder order);
+
+    // Merges a[0, na) and b[0, nb), both sorted in order, into out[0, na + nb), which must
+    // not overlap them. Each step merges the carried width keys with the next width keys of
+    // the input whose head comes first, in a 2-register bitonic merge network.
+    void (*mergeSorted)(const T* a, int na, const T* b, int nb, T* out, SortOrder order);
+
+    // Length of the longest prefix of data[0, count) sorted in order (equal neighbours
+    // allowed), found a vector at a time by comparing each vector with itself shifted by one
+    int (*sortedPrefix)(const T* data, int count, SortOrder order);
+
+    // Key/value versions of the above, moving values[i] with keys[i]. Only 32- and 64-bit
+    // keys have them (payloads as wide as the key share its lanes); they are null for
+    // 16-bit keys. compareAndSwapBlocksPairs pairs element i with i + distance for i in
+    // [0, count), any count.
+    int pairBlockSize;
+    void (*compareAndSwapBlocksPairs)(T* keys, PayloadOf<T>* values, int distance, int count, SortOrder order);
+    void (*sortBlockPairs)(T* keys, PayloadOf<T>* values, int count, SortOrder order);
+    void (*bitonicMergePairs)(T* keys, PayloadOf<T>* values, int count, SortOrder order);
+};
+
+template <typename T> const SIMDKernels<T>& getScalarKernels();
+template <typename T> const SIMDKernels<T>& getSSE41Kernels();
+template <typename T> const SIMDKernels<T>& getAVX2Kernels();
+template <typename T> const SIMDKernels<T>& getAVX512Kernels();
+
+// Merge passes spanning more bytes than this use compareAndSwapBlocksStreaming: twice the
+// last-level cache, or 64 MiB when its size is unknown
+std::size_t streamingStoreThresholdBytes();
+
+// Adds count compare-exchanges run by kernels to the thread's SortStats counts; the Scalar
+// kernels' count as scalar
+template <typename T>
+inline void countKernelCompareExchanges(const SIMDKernels<T>& kernels, std::uint64_t count) {
+    countKernelCompareExchanges(count, kernels.isa != SIMDIsa::Scalar);
+}
+
+// mergeSorted's compare-exchanges for count output keys: one merge network on two registers
+// per register of output
+template <typename T>
+inline std::uint64_t mergeSortedComparators(const SIMDKernels<T>& kernels, std::uint64_t count) {
+    return count / kernels.width * bitonicMergeComparators(2 * static_cast<std::uint64_t>(kernels.width));
+}
+
+// Returns the kernels for the requested ISA, or for the widest supported one when the
+// request is Auto or not supported by the running CPU.
+template <typename T>
+const SIMDKernels<T>& selectSIMDKernels(SIMDIsa requested = SIMDIsa::Auto);
+
+#endif // SIMD_KERNELS_H
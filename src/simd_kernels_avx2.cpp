@@ -0,0 +1,137 @@
+// Compiled with -mavx2 (see src/CMakeLists.txt); only called after a CPUID check.
+#include "simd_kernels.h"
+#include "simd_kernels_impl.h"
+#include <immintrin.h>
+
+namespace {
+
+using simd_kernels_impl::laneBitMask;
+using simd_kernels_impl::xorShuffleImm4;
+
+// pshufb pattern that moves lane l to lane l ^ M within a 128-bit half, LB-byte lanes
+template <int LB, int M, int... I>
+inline __m128i xorBytePattern(std::integer_sequence<int, I...>) {
+    return _mm_setr_epi8(static_cast<char>(((I / LB) ^ M) * LB + I % LB)...);
+}
+
+// Lane movement for LB-byte lanes, shared by every key type of that width
+template <int LB>
+struct AVX2Lanes {
+    using Vec = __m256i;
+    static constexpr int WIDTH = 32 / LB;
+    static constexpr int LANES_PER_128 = 16 / LB;
+    template <int M> static Vec permuteXor(Vec v) {
+        constexpr int M_LOW = M % LANES_PER_128;
+        if constexpr (M >= LANES_PER_128) {
+            v = _mm256_permute4x64_epi64(v, 0x4E); // Swap the 128-bit halves
+        }
+        if constexpr (M_LOW == 0) {
+            return v;
+        } else if constexpr (LB >= 4) {
+            return _mm256_shuffle_epi32(v, xorShuffleImm4(M_LOW * LB / 4));
+        } else {
+            const __m128i pattern = xorBytePattern<LB, M_LOW>(std::make_integer_sequence<int, 16>{});
+            return _mm256_shuffle_epi8(v, _mm256_broadcastsi128_si256(pattern));
+        }
+    }
+    template <int B> static Vec blendLaneBit(Vec a, Vec b) {
+        if constexpr (B * LB >= 4) {
+            return _mm256_blend_epi32(a, b, static_cast<int>(laneBitMask(8, 4, LB, B)));
+        } else {
+            // 16-bit lanes, B == 1: the same word pattern in both halves
+            return _mm256_blend_epi16(a, b, static_cast<int>(laneBitMask(8, 2, LB, B)));
+        }
+    }
+    // Compare results are all-ones/all-zero lanes, blended like data
+    using Mask = Vec;
+    template <int B> static Mask selectLaneBit(Mask a, Mask b) { return blendLaneBit<B>(a, b); }
+    static Vec select(Vec a, Vec b, Mask m) { return _mm256_blendv_epi8(a, b, m); }
+    static bool equal(Vec a, Vec b) { return _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)) == -1; }
+};
+
+template <typename T>
+struct AVX2IntLoadStore : AVX2Lanes<sizeof(T)> {
+    using Key = T;
+    using Vec = __m256i;
+    static Vec load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(T* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static Vec loadAligned(const T* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void storeAligned(T* p, Vec v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+    static void storeStream(T* p, Vec v) { _mm256_stream_si256(reinterpret_cast<__m256i*>(p), v); }
+    static void streamFence() { _mm_sfence(); }
+    using Payload = PayloadOf<T>;
+    using PVec = Vec;
+    static PVec loadPayload(const Payload* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void storePayload(Payload* p, PVec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+};
+
+template <typename T> struct AVX2Ops;
+
+template <> struct AVX2Ops<std::int16_t> : AVX2IntLoadStore<std::int16_t> {
+    static Vec min(Vec a, Vec b) { return _mm256_min_epi16(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm256_max_epi16(a, b); }
+};
+
+template <> struct AVX2Ops<std::uint16_t> : AVX2IntLoadStore<std::uint16_t> {
+    static Vec min(Vec a, Vec b) { return _mm256_min_epu16(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm256_max_epu16(a, b); }
+};
+
+template <> struct AVX2Ops<std::int32_t> : AVX2IntLoadStore<std::int32_t> {
+    static Vec min(Vec a, Vec b) { return _mm256_min_epi32(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm256_max_epi32(a, b); }
+    static Mask greater(Vec a, Vec b) { return _mm256_cmpgt_epi32(a, b); }
+};
+
+template <> struct AVX2Ops<std::uint32_t> : AVX2IntLoadStore<std::uint32_t> {
+    static Vec min(Vec a, Vec b) { return _mm256_min_epu32(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm256_max_epu32(a, b); }
+    static Mask greater(Vec a, Vec b) {
+        const __m256i sign = _mm256_set1_epi32(INT32_MIN);
+        return _mm256_cmpgt_epi32(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+    }
+};
+
+template <> struct AVX2Ops<std::int64_t> : AVX2IntLoadStore<std::int64_t> {
+    // No vpminsq before AVX-512: select with the 64-bit signed compare
+    static Vec min(Vec a, Vec b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+    static Vec max(Vec a, Vec b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+    static Mask greater(Vec a, Vec b) { return _mm256_cmpgt_epi64(a, b); }
+};
+
+// Floating-point keys are compared as totalOrder-mapped integers (see SortKeyTraits);
+// the mapping is its own inverse, so store applies it again.
+template <> struct AVX2Ops<float> : AVX2Ops<std::int32_t> {
+    using Key = float;
+    static Vec toOrdered(Vec v) { return _mm256_xor_si256(v, _mm256_srli_epi32(_mm256_srai_epi32(v, 31), 1)); }
+    static Vec load(const float* p) { return toOrdered(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))); }
+    static void store(float* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), toOrdered(v)); }
+    static Vec loadAligned(const float* p) { return toOrdered(_mm256_load_si256(reinterpret_cast<const __m256i*>(p))); }
+    static void storeAligned(float* p, Vec v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), toOrdered(v)); }
+    static void storeStream(float* p, Vec v) { _mm256_stream_si256(reinterpret_cast<__m256i*>(p), toOrdered(v)); }
+};
+
+template <> struct AVX2Ops<double> : AVX2Ops<std::int64_t> {
+    using Key = double;
+    static Vec toOrdered(Vec v) {
+        __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), v);
+        return _mm256_xor_si256(v, _mm256_srli_epi64(sign, 1));
+    }
+    static Vec load(const double* p) { return toOrdered(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))); }
+    static void store(double* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), toOrdered(v)); }
+    static Vec loadAligned(const double* p) { return toOrdered(_mm256_load_si256(reinterpret_cast<const __m256i*>(p))); }
+    static void storeAligned(double* p, Vec v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), toOrdered(v)); }
+    static void storeStream(double* p, Vec v) { _mm256_stream_si256(reinterpret_cast<__m256i*>(p), toOrdered(v)); }
+};
+
+} // namespace
+
+template <typename T>
+const SIMDKernels<T>& getAVX2Kernels() {
+    static const SIMDKernels<T> kernels = simd_kernels_impl::makeKernels<AVX2Ops<T>>(SIMDIsa::AVX2);
+    return kernels;
+}
+
+#define INSTANTIATE_AVX2_KERNELS(T) template const SIMDKernels<T>& getAVX2Kernels<T>();
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_AVX2_KERNELS)
+#undef INSTANTIATE_AVX2_KERNELS
@@ -0,0 +1,136 @@
+// Compiled with -mavx512f -mavx512bw (see src/CMakeLists.txt); only called after a CPUID check.
+#include "simd_kernels.h"
+#include "simd_kernels_impl.h"
+#include <immintrin.h>
+
+namespace {
+
+using simd_kernels_impl::laneBitMask;
+using simd_kernels_impl::xorShuffleImm4;
+
+// pshufb pattern that moves lane l to lane l ^ M within a 128-bit chunk, LB-byte lanes
+template <int LB, int M, int... I>
+inline __m128i xorBytePattern(std::integer_sequence<int, I...>) {
+    return _mm_setr_epi8(static_cast<char>(((I / LB) ^ M) * LB + I % LB)...);
+}
+
+// Lane movement for LB-byte lanes, shared by every key type of that width
+template <int LB>
+struct AVX512Lanes {
+    using Vec = __m512i;
+    static constexpr int WIDTH = 64 / LB;
+    static constexpr int LANES_PER_128 = 16 / LB;
+    template <int M> static Vec permuteXor(Vec v) {
+        constexpr int M_LOW = M % LANES_PER_128;
+        constexpr int M_CHUNK = M / LANES_PER_128;
+        if constexpr (M_CHUNK != 0) {
+            // 128-bit chunk c <- chunk c ^ M_CHUNK
+            v = _mm512_shuffle_i64x2(v, v, xorShuffleImm4(M_CHUNK));
+        }
+        if constexpr (M_LOW == 0) {
+            return v;
+        } else if constexpr (LB >= 4) {
+            return _mm512_shuffle_epi32(v, static_cast<_MM_PERM_ENUM>(xorShuffleImm4(M_LOW * LB / 4)));
+        } else {
+            const __m128i pattern = xorBytePattern<LB, M_LOW>(std::make_integer_sequence<int, 16>{});
+            return _mm512_shuffle_epi8(v, _mm512_broadcast_i32x4(pattern));
+        }
+    }
+    template <int B> static Vec blendLaneBit(Vec a, Vec b) {
+        return _mm512_mask_blend_epi8(static_cast<__mmask64>(laneBitMask(64, 1, LB, B)), a, b);
+    }
+    // Compares produce one opmask bit per lane (key/value kernels only use 32/64-bit lanes)
+    using Mask = typename std::conditional<LB == 8, __mmask8, __mmask16>::type;
+    template <int B> static Mask selectLaneBit(Mask a, Mask b) {
+        constexpr Mask upper = static_cast<Mask>(laneBitMask(WIDTH, 1, 1, B));
+        return static_cast<Mask>((a & ~upper) | (b & upper));
+    }
+    static Vec select(Vec a, Vec b, Mask m) {
+        if constexpr (LB == 8) {
+            return _mm512_mask_blend_epi64(m, a, b);
+        } else {
+            return _mm512_mask_blend_epi32(m, a, b);
+        }
+    }
+    static bool equal(Vec a, Vec b) { return _mm512_cmpneq_epi64_mask(a, b) == 0; }
+};
+
+template <typename T>
+struct AVX512IntLoadStore : AVX512Lanes<sizeof(T)> {
+    using Key = T;
+    using Vec = __m512i;
+    static Vec load(const T* p) { return _mm512_loadu_si512(p); }
+    static void store(T* p, Vec v) { _mm512_storeu_si512(p, v); }
+    static Vec loadAligned(const T* p) { return _mm512_load_si512(p); }
+    static void storeAligned(T* p, Vec v) { _mm512_store_si512(p, v); }
+    static void storeStream(T* p, Vec v) { _mm512_stream_si512(reinterpret_cast<__m512i*>(p), v); }
+    static void streamFence() { _mm_sfence(); }
+    using Payload = PayloadOf<T>;
+    using PVec = Vec;
+    static PVec loadPayload(const Payload* p) { return _mm512_loadu_si512(p); }
+    static void storePayload(Payload* p, PVec v) { _mm512_storeu_si512(p, v); }
+};
+
+template <typename T> struct AVX512Ops;
+
+template <> struct AVX512Ops<std::int16_t> : AVX512IntLoadStore<std::int16_t> {
+    static Vec min(Vec a, Vec b) { return _mm512_min_epi16(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm512_max_epi16(a, b); }
+};
+
+template <> struct AVX512Ops<std::uint16_t> : AVX512IntLoadStore<std::uint16_t> {
+    static Vec min(Vec a, Vec b) { return _mm512_min_epu16(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm512_max_epu16(a, b); }
+};
+
+template <> struct AVX512Ops<std::int32_t> : AVX512IntLoadStore<std::int32_t> {
+    static Vec min(Vec a, Vec b) { return _mm512_min_epi32(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm512_max_epi32(a, b); }
+    static Mask greater(Vec a, Vec b) { return _mm512_cmpgt_epi32_mask(a, b); }
+};
+
+template <> struct AVX512Ops<std::uint32_t> : AVX512IntLoadStore<std::uint32_t> {
+    static Vec min(Vec a, Vec b) { return _mm512_min_epu32(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm512_max_epu32(a, b); }
+    static Mask greater(Vec a, Vec b) { return _mm512_cmpgt_epu32_mask(a, b); }
+};
+
+template <> struct AVX512Ops<std::int64_t> : AVX512IntLoadStore<std::int64_t> {
+    static Vec min(Vec a, Vec b) { return _mm512_min_epi64(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm512_max_epi64(a, b); }
+    static Mask greater(Vec a, Vec b) { return _mm512_cmpgt_epi64_mask(a, b); }
+};
+
+// Floating-point keys are compared as totalOrder-mapped integers (see SortKeyTraits);
+// the mapping is its own inverse, so store applies it again.
+template <> struct AVX512Ops<float> : AVX512Ops<std::int32_t> {
+    using Key = float;
+    static Vec toOrdered(Vec v) { return _mm512_xor_si512(v, _mm512_srli_epi32(_mm512_srai_epi32(v, 31), 1)); }
+    static Vec load(const float* p) { return toOrdered(_mm512_loadu_si512(p)); }
+    static void store(float* p, Vec v) { _mm512_storeu_si512(p, toOrdered(v)); }
+    static Vec loadAligned(const float* p) { return toOrdered(_mm512_load_si512(p)); }
+    static void storeAligned(float* p, Vec v) { _mm512_store_si512(p, toOrdered(v)); }
+    static void storeStream(float* p, Vec v) { _mm512_stream_si512(reinterpret_cast<__m512i*>(p), toOrdered(v)); }
+};
+
+template <> struct AVX512Ops<double> : AVX512Ops<std::int64_t> {
+    using Key = double;
+    static Vec toOrdered(Vec v) { return _mm512_xor_si512(v, _mm512_srli_epi64(_mm512_srai_epi64(v, 63), 1)); }
+    static Vec load(const double* p) { return toOrdered(_mm512_loadu_si512(p)); }
+    static void store(double* p, Vec v) { _mm512_storeu_si512(p, toOrdered(v)); }
+    static Vec loadAligned(const double* p) { return toOrdered(_mm512_load_si512(p)); }
+    static void storeAligned(double* p, Vec v) { _mm512_store_si512(p, toOrdered(v)); }
+    static void storeStream(double* p, Vec v) { _mm512_stream_si512(reinterpret_cast<__m512i*>(p), toOrdered(v)); }
+};
+
+} // namespace
+
+template <typename T>
+const SIMDKernels<T>& getAVX512Kernels() {
+    static const SIMDKernels<T> kernels = simd_kernels_impl::makeKernels<AVX512Ops<T>>(SIMDIsa::AVX512);
+    return kernels;
+}
+
+#define INSTANTIATE_AVX512_KERNELS(T) template const SIMDKernels<T>& getAVX512Kernels<T>();
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_AVX512_KERNELS)
+#undef INSTANTIATE_AVX512_KERNELS
@@ -0,0 +1,850 @@
+#ifndef SIMD_KERNELS_IMPL_H
+#define SIMD_KERNELS_IMPL_H
+
+// Shared kernel bodies, included only by the per-ISA simd_kernels_*.cpp files.
+// Everything here is a template on the ISA's Ops struct so that each translation unit
+// gets its own instantiations; a non-template inline function compiled with -mavx512f
+// could otherwise be picked by the linker for callers running on older CPUs.
+//
+// An Ops struct provides:
+//   using Key;  using Vec;  static constexpr int WIDTH;
+//   static Vec load(const Key*);  static void store(Key*, Vec);
+//   static Vec loadAligned(const Key*);  static void storeAligned(Key*, Vec);  // sizeof(Vec)-aligned
+//   static void storeStream(Key*, Vec);  // aligned, non-temporal
+//   static void streamFence();           // orders earlier storeStream calls before later stores
+//   static Vec min(Vec, Vec);     static Vec max(Vec, Vec);
+//   static bool equal(Vec, Vec);  // every lane bitwise equal
+// min/max must be an exact compare-exchange (each output lane is one of the inputs), and
+// follow SortKeyTraits<Key>::less; floating-point Ops therefore work on totalOrder-mapped
+// bit patterns between load and store rather than using min_ps/max_ps, which collapse
+// -0.0/+0.0 and duplicate NaNs.
+//   template <int M> static Vec permuteXor(Vec);         // lane l <- lane (l ^ M), M < WIDTH
+//   template <int B> static Vec blendLaneBit(Vec, Vec);  // lane l <- (l & B) ? second : first
+// permuteXor/blendLaneBit are only instantiated when WIDTH > 1.
+//
+// Key types of 32 or 64 bits also get key/value kernels, which need:
+//   using Payload;  using PVec;  using Mask;
+//   static PVec loadPayload(const Payload*);  static void storePayload(Payload*, PVec);
+//   static Mask greater(Vec a, Vec b);                  // a sorts after b, per lane
+//   static V select(V a, V b, Mask);                   // lane l <- mask[l] ? b : a, for Vec and PVec
+//   template <int B> static Mask selectLaneBit(Mask, Mask);  // as blendLaneBit, on masks
+// Payload lanes line up with key lanes (PVec == Vec when WIDTH > 1), so the payloads
+// follow the keys through the same permutes and selects.
+
+#include "simd_kernels.h"
+#include <cstdint>     // For std::uintptr_t
+#include <cstring>     // For std::memcpy
+#include <limits>      // For std::numeric_limits
+#include <type_traits> // For std::integral_constant, std::is_floating_point
+#include <utility>     // For std::integer_sequence
+
+namespace simd_kernels_impl {
+
+// Blend-immediate/mask for `units` units of unitBytes each (bytes, words or dwords):
+// bit u is set when the laneBytes-wide lane containing unit u has bit B set in its index.
+// A unit wider than a lane is only valid when B * laneBytes >= unitBytes.
+constexpr unsigned long long laneBitMask(int units, int unitBytes, int laneBytes, int B) {
+    unsigned long long mask = 0;
+    for (int u = 0; u < units; ++u) {
+        if (((u * unitBytes) / laneBytes) & B) mask |= 1ULL << u;
+    }
+    return mask;
+}
+
+// _mm_shuffle_epi32-style immediate for the 4-dword permutation d -> d ^ M.
+constexpr int xorShuffleImm4(int M) {
+    int imm = 0;
+    for (int l = 0; l < 4; ++l) {
+        imm |= ((l ^ M) & 3) << (2 * l);
+    }
+    return imm;
+}
+
+// Calls f(std::integral_constant<int, I>{}) for I in [0, N), fully unrolled, so that the
+// register array indices below are compile-time constants and stay in registers.
+template <typename F, int... I>
+inline void staticForImpl(F&& f, std::integer_sequence<int, I...>) {
+    (f(std::integral_constant<int, I>{}), ...);
+}
+
+template <int N, typename F>
+inline void staticFor(F&& f) {
+    staticForImpl(f, std::make_integer_sequence<int, N>{});
+}
+
+// Bitonic network over NV registers (NV * WIDTH elements) held entirely in registers.
+// Sorting uses the "flip" formulation: every comparator puts the smaller (Desc: larger)
+// value at the lower index, so no per-lane direction masks are needed. Strides below
+// WIDTH are done inside a register with a permute, a min/max pair and a blend.
+template <typename Ops, int NV, bool Desc>
+struct RegisterNetwork {
+    using Vec = typename Ops::Vec;
+    static constexpr int W = Ops::WIDTH;
+    static constexpr int N = NV * W;
+
+    static inline void compareExchange(Vec& a, Vec& b) {
+        Vec lo = Desc ? Ops::max(a, b) : Ops::min(a, b);
+        Vec hi = Desc ? Ops::min(a, b) : Ops::max(a, b);
+        a = lo;
+        b = hi;
+    }
+
+    static inline Vec reverseLanes(Vec v) {
+        if constexpr (W == 1) {
+            return v;
+        } else {
+            return Ops::template permuteXor<W - 1>(v);
+        }
+    }
+
+    // Element e against e ^ S
+    template <int S>
+    static inline void halfClean(Vec* v) {
+        if constexpr (S >= W) {
+            constexpr int SV = S / W;
+            staticFor<NV>([&](auto i) {
+                constexpr int I = decltype(i)::value;
+                if constexpr ((I & SV) == 0) {
+                    compareExchange(v[I], v[I + SV]);
+                }
+            });
+        } else {
+            staticFor<NV>([&](auto i) {
+                constexpr int I = decltype(i)::value;
+                Vec partner = Ops::template permuteXor<S>(v[I]);
+                Vec lo = v[I];
+                Vec hi = partner;
+                compareExchange(lo, hi);
+                v[I] = Ops::template blendLaneBit<S>(lo, hi);
+            });
+        }
+    }
+
+    // Element e against e ^ (Size - 1), turning two sorted runs of Size/2 into a bitonic one
+    template <int Size>
+    static inline void flip(Vec* v) {
+        if constexpr (Size > W) {
+            constexpr int GV = Size / W;
+            staticFor<NV>([&](auto i) {
+                constexpr int I = decltype(i)::value;
+                constexpr int J = I ^ (GV - 1);
+                if constexpr (I < J) {
+                    Vec lo = v[I];
+                    Vec hi = reverseLanes(v[J]);
+                    compareExchange(lo, hi);
+                    v[I] = lo;
+                    v[J] = reverseLanes(hi);
+                }
+            });
+        } else {
+            staticFor<NV>([&](auto i) {
+                constexpr int I = decltype(i)::value;
+                Vec partner = Ops::template permuteXor<Size - 1>(v[I]);
+                Vec lo = v[I];
+                Vec hi = partner;
+                compareExchange(lo, hi);
+                v[I] = Ops::template blendLaneBit<Size / 2>(lo, hi);
+            });
+        }
+    }
+
+    template <int S>
+    static inline void halfCleanersFrom(Vec* v) {
+        if constexpr (S >= 1) {
+            halfClean<S>(v);
+            halfCleanersFrom<S / 2>(v);
+        }
+    }
+
+    template <int Size>
+    static inline void sortFrom(Vec* v) {
+        if constexpr (Size <= N) {
+            flip<Size>(v);
+            halfCleanersFrom<Size / 4>(v);
+            sortFrom<Size * 2>(v);
+        }
+    }
+
+    static inline void sort(Vec* v) { sortFrom<2>(v); }
+
+    // v must hold a bitonic sequence
+    static inline void merge(Vec* v) { halfCleanersFrom<N / 2>(v); }
+};
+
+// RegisterNetwork for keys with a payload register alongside every key register.
+// min/max cannot say which input each lane came from, so every comparator computes an
+// "out of order" mask and selects keys and payloads with it.
+template <typename Ops, int NV, bool Desc>
+struct PairRegisterNetwork {
+    using Vec = typename Ops::Vec;
+    using PVec = typename Ops::PVec;
+    using Mask = typename Ops::Mask;
+    static constexpr int W = Ops::WIDTH;
+    static constexpr int N = NV * W;
+
+    // Lanes where a must swap with a partner b at a higher index
+    static inline Mask outOfOrder(Vec a, Vec b) { return Desc ? Ops::greater(b, a) : Ops::greater(a, b); }
+
+    static inline void compareExchange(Vec& ka, PVec& pa, Vec& kb, PVec& pb) {
+        Mask swap = outOfOrder(ka, kb);
+        Vec k_lo = Ops::select(ka, kb, swap);
+        Vec k_hi = Ops::select(kb, ka, swap);
+        PVec p_lo = Ops::select(pa, pb, swap);
+        PVec p_hi = Ops::select(pb, pa, swap);
+        ka = k_lo;
+        kb = k_hi;
+        pa = p_lo;
+        pb = p_hi;
+    }
+
+    template <typename V>
+    static inline V reverseLanes(V v) {
+        if constexpr (W == 1) {
+            return v;
+        } else {
+            return Ops::template permuteXor<W - 1>(v);
+        }
+    }
+
+    // Lane l against lane l ^ M of the same register, where bit B = M's highest bit tells
+    // the lower (keeps the smaller key) from the upper element of each pair
+    template <int M, int B>
+    static inline void exchangeInRegister(Vec& k, PVec& p) {
+        Vec k_partner = Ops::template permuteXor<M>(k);
+        PVec p_partner = Ops::template permuteXor<M>(p);
+        Mask swap = Ops::template selectLaneBit<B>(outOfOrder(k, k_partner), outOfOrder(k_partner, k));
+        k = Ops::select(k, k_partner, swap);
+        p = Ops::select(p, p_partner, swap);
+    }
+
+    template <int S>
+    static inline void halfClean(Vec* k, PVec* p) {
+        if constexpr (S >= W) {
+            constexpr int SV = S / W;
+            staticFor<NV>([&](auto i) {
+                constexpr int I = decltype(i)::value;
+                if constexpr ((I & SV) == 0) {
+                    compareExchange(k[I], p[I], k[I + SV], p[I + SV]);
+                }
+            });
+        } else {
+            staticFor<NV>([&](auto i) {
+                constexpr int I = decltype(i)::value;
+                exchangeInRegister<S, S>(k[I], p[I]);
+            });
+        }
+    }
+
+    template <int Size>
+    static inline void flip(Vec* k, PVec* p) {
+        if constexpr (Size > W) {
+            constexpr int GV = Size / W;
+            staticFor<NV>([&](auto i) {
+                constexpr int I = decltype(i)::value;
+                constexpr int J = I ^ (GV - 1);
+                if constexpr (I < J) {
+                    Vec k_hi = reverseLanes(k[J]);
+                    PVec p_hi = reverseLanes(p[J]);
+                    compareExchange(k[I], p[I], k_hi, p_hi);
+                    k[J] = reverseLanes(k_hi);
+                    p[J] = reverseLanes(p_hi);
+                }
+            });
+        } else {
+            staticFor<NV>([&](auto i) {
+                constexpr int I = decltype(i)::value;
+                exchangeInRegister<Size - 1, Size / 2>(k[I], p[I]);
+            });
+        }
+    }
+
+    template <int S>
+    static inline void halfCleanersFrom(Vec* k, PVec* p) {
+        if constexpr (S >= 1) {
+            halfClean<S>(k, p);
+            halfCleanersFrom<S / 2>(k, p);
+        }
+    }
+
+    template <int Size>
+    static inline void sortFrom(Vec* k, PVec* p) {
+        if constexpr (Size <= N) {
+            flip<Size>(k, p);
+            halfCleanersFrom<Size / 4>(k, p);
+            sortFrom<Size * 2>(k, p);
+        }
+    }
+
+    static inline void sort(Vec* k, PVec* p) { sortFrom<2>(k, p); }
+
+    static inline void merge(Vec* k, PVec* p) { halfCleanersFrom<N / 2>(k, p); }
+};
+
+// Registers per in-register block: at least 64 elements, and at least 8 registers
+// so that wide ISAs still amortise the load/store over several network levels.
+template <typename Ops>
+constexpr int blockVectors() {
+    return (64 / Ops::WIDTH > 8) ? 64 / Ops::WIDTH : 8;
+}
+
+template <typename Ops>
+constexpr int blockSize() {
+    return blockVectors<Ops>() * Ops::WIDTH;
+}
+
+// Key/value blocks hold twice the registers, so they use half as many key registers
+template <typename Ops>
+constexpr int pairBlockVectors() {
+    return blockVectors<Ops>() / 2;
+}
+
+template <typename Ops>
+constexpr int pairBlockSize() {
+    return pairBlockVectors<Ops>() * Ops::WIDTH;
+}
+
+// Fills dst[0, n) with the value that ends up last in the given order. The patterns match
+// SortKeyTraits<Key>::highest()/lowest() but are built from constants here so that no
+// shared inline function gets compiled with this translation unit's ISA flags.
+template <typename Ops>
+inline void fillTrailingSentinel(typename Ops::Key* dst, int n, SortOrder order) {
+    using Key = typename Ops::Key;
+    if constexpr (std::is_floating_point<Key>::value) {
+        using Bits = typename std::conditional<sizeof(Key) == 4, std::int32_t, std::int64_t>::type;
+        constexpr Bits highest = std::numeric_limits<Bits>::max(); // +NaN
+        constexpr Bits lowest = -1;                                 // -NaN
+        const Bits bits = (order == SortOrder::Ascending) ? highest : lowest;
+        for (int i = 0; i < n; ++i) {
+            std::memcpy(dst + i, &bits, sizeof(Key));
+        }
+    } else {
+        constexpr Key highest = std::numeric_limits<Key>::max();
+        constexpr Key lowest = std::numeric_limits<Key>::min();
+        const Key value = (order == SortOrder::Ascending) ? highest : lowest;
+        for (int i = 0; i < n; ++i) {
+            dst[i] = value;
+        }
+    }
+}
+
+template <typename Ops, int NV, bool Merge, bool Desc>
+inline void runBlock(typename Ops::Key* arr) {
+    typename Ops::Vec v[NV];
+    staticFor<NV>([&](auto i) {
+        constexpr int I = decltype(i)::value;
+        v[I] = Ops::load(arr + I * Ops::WIDTH);
+    });
+    if constexpr (Merge) {
+        RegisterNetwork<Ops, NV, Desc>::merge(v);
+    } else {
+        RegisterNetwork<Ops, NV, Desc>::sort(v);
+    }
+    staticFor<NV>([&](auto i) {
+        constexpr int I = decltype(i)::value;
+        Ops::store(arr + I * Ops::WIDTH, v[I]);
+    });
+}
+
+// The network on NV registers, the fewest (a power of two) that hold count elements, so that
+// 8 or 16 keys do not pay for a full block. A count that does not fill them is staged through
+// a stack buffer whose tail holds sentinels that sort after every real element, so only the
+// first count results are copied back.
+template <typename Ops, bool Merge, int NV>
+void blockKernelOn(typename Ops::Key* arr, int count, SortOrder order) {
+    using Key = typename Ops::Key;
+    constexpr int N = NV * Ops::WIDTH;
+    if constexpr (NV < blockVectors<Ops>()) {
+        if (count > N) {
+            blockKernelOn<Ops, Merge, NV * 2>(arr, count, order);
+            return;
+        }
+    }
+    if (count == N) {
+        if (order == SortOrder::Ascending) runBlock<Ops, NV, Merge, false>(arr);
+        else runBlock<Ops, NV, Merge, true>(arr);
+        return;
+    }
+    alignas(64) Key buffer[N];
+    fillTrailingSentinel<Ops>(buffer + count, N - count, order);
+    std::memcpy(buffer, arr, sizeof(Key) * count);
+    if (order == SortOrder::Ascending) runBlock<Ops, NV, Merge, false>(buffer);
+    else runBlock<Ops, NV, Merge, true>(buffer);
+    std::memcpy(arr, buffer, sizeof(Key) * count);
+}
+
+// Runs the in-register sort or merge on count <= blockSize() elements
+template <typename Ops, bool Merge>
+void blockKernel(typename Ops::Key* arr, int count, SortOrder order) {
+    blockKernelOn<Ops, Merge, 1>(arr, count, order);
+}
+
+// Largest power of two below count (count >= 2), as BasicBitonicSort::splitPoint
+template <typename Ops>
+inline int splitPoint(int count) {
+    int k = 1;
+    while (k < count - k) {
+        k *= 2;
+    }
+    return k;
+}
+
+template <typename Ops>
+inline void compareExchangeVectors(typename Ops::Key* lo, typename Ops::Key* hi, SortOrder order) {
+    typename Ops::Vec block_L = Ops::load(lo);
+    typename Ops::Vec block_R = Ops::load(hi);
+    if (order == SortOrder::Ascending) {
+        Ops::store(lo, Ops::min(block_L, block_R));
+        Ops::store(hi, Ops::max(block_L, block_R));
+    } else {
+        Ops::store(lo, Ops::max(block_L, block_R));
+        Ops::store(hi, Ops::min(block_L, block_R));
+    }
+}
+
+// How compareAndSwapBlocks touches memory in its main loop
+enum class BlockAccess { Unaligned, Aligned, Streaming };
+
+// Elements before lo reaches a vector boundary, or -1 when lo and hi sit at different
+// offsets within a vector and so can never both be aligned
+template <typename Ops>
+inline int alignmentHead(const typename Ops::Key* lo, const typename Ops::Key* hi) {
+    using Key = typename Ops::Key;
+    constexpr std::uintptr_t VB = sizeof(typename Ops::Vec);
+    const std::uintptr_t a = reinterpret_cast<std::uintptr_t>(lo);
+    const std::uintptr_t b = reinterpret_cast<std::uintptr_t>(hi);
+    if ((a - b) % VB != 0 || a % sizeof(Key) != 0) {
+        return -1;
+    }
+    return static_cast<int>((VB - a % VB) % VB / sizeof(Key));
+}
+
+// Vectors a pass must span before peeling a head is worth the extra staged compare-exchange
+constexpr int ALIGNED_MIN_VECTORS = 4;
+
+// compareExchangeVectors on lo[i] against hi[i], i in [0, count), count < WIDTH: both sides
+// are staged, with sentinel lanes past count
+template <typename Ops>
+inline void compareExchangePartial(typename Ops::Key* lo, typename Ops::Key* hi, int count, SortOrder order) {
+    using Key = typename Ops::Key;
+    constexpr int W = Ops::WIDTH;
+    alignas(64) Key lo_buffer[W];
+    alignas(64) Key hi_buffer[W];
+    fillTrailingSentinel<Ops>(lo_buffer + count, W - count, order);
+    fillTrailingSentinel<Ops>(hi_buffer + count, W - count, order);
+    std::memcpy(lo_buffer, lo, sizeof(Key) * count);
+    std::memcpy(hi_buffer, hi, sizeof(Key) * count);
+    compareExchangeVectors<Ops>(lo_buffer, hi_buffer, order);
+    std::memcpy(lo, lo_buffer, sizeof(Key) * count);
+    std::memcpy(hi, hi_buffer, sizeof(Key) * count);
+}
+
+template <typename Ops, BlockAccess A>
+inline typename Ops::Vec loadBlock(const typename Ops::Key* p) {
+    if constexpr (A == BlockAccess::Unaligned) {
+        return Ops::load(p);
+    } else {
+        return Ops::loadAligned(p);
+    }
+}
+
+template <typename Ops, BlockAccess A>
+inline void storeBlock(typename Ops::Key* p, typename Ops::Vec v) {
+    if constexpr (A == BlockAccess::Unaligned) {
+        Ops::store(p, v);
+    } else if constexpr (A == BlockAccess::Aligned) {
+        Ops::storeAligned(p, v);
+    } else {
+        Ops::storeStream(p, v);
+    }
+}
+
+// Whole vectors of lo/hi from i on; returns the index of the first element not done
+template <typename Ops, BlockAccess A>
+inline int compareExchangeRun(typename Ops::Key* lo, typename Ops::Key* hi, int i, int count, SortOrder order) {
+    constexpr int W = Ops::WIDTH;
+    if (order == SortOrder::Ascending) {
+        for (; i + W <= count; i += W) {
+            typename Ops::Vec block_L = loadBlock<Ops, A>(lo + i);
+            typename Ops::Vec block_R = loadBlock<Ops, A>(hi + i);
+            storeBlock<Ops, A>(lo + i, Ops::min(block_L, block_R));
+            storeBlock<Ops, A>(hi + i, Ops::max(block_L, block_R));
+        }
+    } else {
+        for (; i + W <= count; i += W) {
+            typename Ops::Vec block_L = loadBlock<Ops, A>(lo + i);
+            typename Ops::Vec block_R = loadBlock<Ops, A>(hi + i);
+            storeBlock<Ops, A>(lo + i, Ops::max(block_L, block_R));
+            storeBlock<Ops, A>(hi + i, Ops::min(block_L, block_R));
+        }
+    }
+    return i;
+}
+
+// When lo and hi are equally misaligned, which every bitonic pass with a power-of-two
+// distance of a vector or more is, a staged head brings both to a vector boundary so that
+// no load or store in the main loop splits a cache line. Streaming stores need that
+// alignment too; a pass that cannot get it falls back to ordinary unaligned stores.
+template <typename Ops, bool Stream>
+void compareAndSwapBlocksIn(typename Ops::Key* lo, typename Ops::Key* hi, int count, SortOrder order) {
+    constexpr int W = Ops::WIDTH;
+    const int head = alignmentHead<Ops>(lo, hi);
+    int i = 0;
+    if (head < 0 || count < head + ALIGNED_MIN_VECTORS * W) {
+        i = compareExchangeRun<Ops, BlockAccess::Unaligned>(lo, hi, 0, count, order);
+    } else {
+        if (head > 0) {
+            compareExchangePartial<Ops>(lo, hi, head, order);
+        }
+        if constexpr (Stream) {
+            i = compareExchangeRun<Ops, BlockAccess::Streaming>(lo, hi, head, count, order);
+            Ops::streamFence();
+        } else {
+            i = compareExchangeRun<Ops, BlockAccess::Aligned>(lo, hi, head, count, order);
+        }
+    }
+    if (i < count) {
+        compareExchangePartial<Ops>(lo + i, hi + i, count - i, order);
+    }
+}
+
+template <typename Ops>
+void compareAndSwapBlocks(typename Ops::Key* lo, typename Ops::Key* hi, int count, SortOrder order) {
+    compareAndSwapBlocksIn<Ops, false>(lo, hi, count, order);
+}
+
+template <typename Ops>
+void compareAndSwapBlocksStreaming(typename Ops::Key* lo, typename Ops::Key* hi, int count, SortOrder order) {
+    compareAndSwapBlocksIn<Ops, true>(lo, hi, count, order);
+}
+
+template <typename Ops>
+void sortBlock(typename Ops::Key* arr, int count, SortOrder order) {
+    if (count > 1) {
+        blockKernel<Ops, false>(arr, count, order);
+    }
+}
+
+template <typename Ops>
+void bitonicMerge(typename Ops::Key* arr, int count, SortOrder order) {
+    if (count <= 1) {
+        return;
+    }
+    if (count <= blockSize<Ops>()) {
+        // Remaining strides, down to the intra-register ones, run without touching memory
+        blockKernel<Ops, true>(arr, count, order);
+        return;
+    }
+
+    // As BasicBitonicSort::bitonicMerge: only the first count - k elements have a partner
+    int k = splitPoint<Ops>(count);
+    if (count * sizeof(typename Ops::Key) > streamingStoreThresholdBytes()) {
+        compareAndSwapBlocksStreaming<Ops>(arr, arr + k, count - k, order);
+    } else {
+        compareAndSwapBlocks<Ops>(arr, arr + k, count - k, order);
+    }
+    bitonicMerge<Ops>(arr, k, order);
+    bitonicMerge<Ops>(arr + k, count - k, order);
+}
+
+// Lane-parallel network for sortColumns: vector i holds element i of WIDTH independent
+// sequences, so every comparator is a plain min/max of two vectors and no lanes move.
+// Same arbitrary-length recursion as BasicBitonicSort::bitonicSortRecursive.
+template <typename Ops, bool Desc>
+void mergeColumns(typename Ops::Key* columns, int length) {
+    if (length <= 1) {
+        return;
+    }
+    constexpr int W = Ops::WIDTH;
+    int k = splitPoint<Ops>(length);
+    for (int i = 0; i < length - k; ++i) {
+        typename Ops::Vec a = Ops::load(columns + i * W);
+        typename Ops::Vec b = Ops::load(columns + (i + k) * W);
+        RegisterNetwork<Ops, 1, Desc>::compareExchange(a, b);
+        Ops::store(columns + i * W, a);
+        Ops::store(columns + (i + k) * W, b);
+    }
+    mergeColumns<Ops, Desc>(columns, k);
+    mergeColumns<Ops, Desc>(columns + k * W, length - k);
+}
+
+template <typename Ops, bool Desc>
+void sortColumnsIn(typename Ops::Key* columns, int length) {
+    if (length <= 1) {
+        return;
+    }
+    constexpr int W = Ops::WIDTH;
+    int k = splitPoint<Ops>(length);
+    sortColumnsIn<Ops, !Desc>(columns, k);
+    sortColumnsIn<Ops, Desc>(columns + k * W, length - k);
+    mergeColumns<Ops, Desc>(columns, length);
+}
+
+template <typename Ops>
+void sortColumns(typename Ops::Key* columns, int length, SortOrder order) {
+    if (order == SortOrder::Ascending) sortColumnsIn<Ops, false>(columns, length);
+    else sortColumnsIn<Ops, true>(columns, length);
+}
+
+// SortKeyTraits<Key>::less for the scalar parts of mergeSorted, rebuilt here for the same
+// reason as fillTrailingSentinel
+template <typename Ops, bool Desc>
+inline bool keyBefore(typename Ops::Key a, typename Ops::Key b) {
+    using Key = typename Ops::Key;
+    if constexpr (std::is_floating_point<Key>::value) {
+        using Bits = typename std::conditional<sizeof(Key) == 4, std::int32_t, std::int64_t>::type;
+        using UBits = typename std::make_unsigned<Bits>::type;
+        Bits x, y;
+        std::memcpy(&x, &a, sizeof(Key));
+        std::memcpy(&y, &b, sizeof(Key));
+        x ^= static_cast<Bits>(static_cast<UBits>(x >> (8 * sizeof(Key) - 1)) >> 1);
+        y ^= static_cast<Bits>(static_cast<UBits>(y >> (8 * sizeof(Key) - 1)) >> 1);
+        return Desc ? y < x : x < y;
+    } else {
+        return Desc ? b < a : a < b;
+    }
+}
+
+// Merges the short run s into l. Each key of s is placed by a binary search in l and the
+// stretches of l in between are copied, so a long l costs ns * log(nl) compares, not nl.
+template <typename Ops, bool Desc>
+void mergeShortRun(const typename Ops::Key* s, int ns, const typename Ops::Key* l, int nl,
+                   typename Ops::Key* out) {
+    using Key = typename Ops::Key;
+    int pos = 0;
+    for (int i = 0; i < ns; ++i) {
+        int lo = pos;
+        int hi = nl;
+        while (lo < hi) { // First key of l[pos, nl) that comes after s[i]
+            int mid = lo + (hi - lo) / 2;
+            if (keyBefore<Ops, Desc>(s[i], l[mid])) hi = mid;
+            else lo = mid + 1;
+        }
+        std::memcpy(out, l + pos, sizeof(Key) * (lo - pos));
+        out += lo - pos;
+        pos = lo;
+        *out++ = s[i];
+    }
+    std::memcpy(out, l + pos, sizeof(Key) * (nl - pos));
+}
+
+// Every key stored is no later than any key not yet loaded: only the vector just loaded
+// can hold keys past the other input's head, and it is at most the W keys kept as carry.
+// Once an input has fewer than W keys left they are folded into the carry, and the result
+// into the rest of the other input.
+template <typename Ops, bool Desc>
+void mergeSortedIn(const typename Ops::Key* a, int na, const typename Ops::Key* b, int nb, typename Ops::Key* out) {
+    using Key = typename Ops::Key;
+    using Net = RegisterNetwork<Ops, 2, Desc>;
+    constexpr int W = Ops::WIDTH;
+    if (na < W || nb < W) {
+        if (na < nb) mergeShortRun<Ops, Desc>(a, na, b, nb, out);
+        else mergeShortRun<Ops, Desc>(b, nb, a, na, out);
+        return;
+    }
+    int ia = 0;
+    int ib = 0;
+    typename Ops::Vec v[2];
+    if (keyBefore<Ops, Desc>(b[0], a[0])) {
+        v[1] = Ops::load(b);
+        ib = W;
+    } else {
+        v[1] = Ops::load(a);
+        ia = W;
+    }
+    while (ia + W <= na && ib + W <= nb) {
+        typename Ops::Vec next;
+        if (keyBefore<Ops, Desc>(b[ib], a[ia])) {
+            next = Ops::load(b + ib);
+            ib += W;
+        } else {
+            next = Ops::load(a + ia);
+            ia += W;
+        }
+        v[0] = Net::reverseLanes(v[1]); // Carry against the order, next along it: bitonic
+        v[1] = next;
+        Net::merge(v);
+        Ops::store(out, v[0]);
+        out += W;
+    }
+    alignas(64) Key carry[W];
+    alignas(64) Key folded[2 * W];
+    Ops::store(carry, v[1]);
+    const bool a_short = ia + W > na;
+    const Key* tail = a_short ? a + ia : b + ib;
+    const int tail_count = a_short ? na - ia : nb - ib;
+    mergeShortRun<Ops, Desc>(tail, tail_count, carry, W, folded);
+    if (a_short) mergeShortRun<Ops, Desc>(folded, W + tail_count, b + ib, nb - ib, out);
+    else mergeShortRun<Ops, Desc>(folded, W + tail_count, a + ia, na - ia, out);
+}
+
+template <typename Ops>
+void mergeSorted(const typename Ops::Key* a, int na, const typename Ops::Key* b, int nb, typename Ops::Key* out,
+                 SortOrder order) {
+    if (order == SortOrder::Ascending) mergeSortedIn<Ops, false>(a, na, b, nb, out);
+    else mergeSortedIn<Ops, true>(a, na, b, nb, out);
+}
+
+// A vector is sorted up to its key after the last lane exactly when taking the min (Desc:
+// max) with that vector shifted by one key leaves it unchanged. The first vector that
+// fails is rescanned key by key.
+template <typename Ops, bool Desc>
+int sortedPrefixIn(const typename Ops::Key* data, int count) {
+    constexpr int W = Ops::WIDTH;
+    int i = 0;
+    for (; i + W < count; i += W) {
+        typename Ops::Vec v = Ops::load(data + i);
+        typename Ops::Vec next = Ops::load(data + i + 1);
+        if (!Ops::equal(Desc ? Ops::max(v, next) : Ops::min(v, next), v)) {
+            break;
+        }
+    }
+    for (; i + 1 < count; ++i) {
+        if (keyBefore<Ops, Desc>(data[i + 1], data[i])) {
+            return i + 1;
+        }
+    }
+    return count;
+}
+
+template <typename Ops>
+int sortedPrefix(const typename Ops::Key* data, int count, SortOrder order) {
+    return order == SortOrder::Ascending ? sortedPrefixIn<Ops, false>(data, count)
+                                         : sortedPrefixIn<Ops, true>(data, count);
+}
+
+template <typename Ops, bool Merge, bool Desc>
+inline void runPairBlock(typename Ops::Key* keys, typename Ops::Payload* values) {
+    constexpr int NV = pairBlockVectors<Ops>();
+    typename Ops::Vec k[NV];
+    typename Ops::PVec p[NV];
+    staticFor<NV>([&](auto i) {
+        constexpr int I = decltype(i)::value;
+        k[I] = Ops::load(keys + I * Ops::WIDTH);
+        p[I] = Ops::loadPayload(values + I * Ops::WIDTH);
+    });
+    if constexpr (Merge) {
+        PairRegisterNetwork<Ops, NV, Desc>::merge(k, p);
+    } else {
+        PairRegisterNetwork<Ops, NV, Desc>::sort(k, p);
+    }
+    staticFor<NV>([&](auto i) {
+        constexpr int I = decltype(i)::value;
+        Ops::store(keys + I * Ops::WIDTH, k[I]);
+        Ops::storePayload(values + I * Ops::WIDTH, p[I]);
+    });
+}
+
+// As blockKernel. Comparators only swap keys that are strictly out of order, so the sentinels
+// never move out of the buffer's tail, even past real keys equal to them, and the zero
+// payloads staged with them are never copied back.
+template <typename Ops, bool Merge>
+void pairBlockKernel(typename Ops::Key* keys, typename Ops::Payload* values, int count, SortOrder order) {
+    using Key = typename Ops::Key;
+    using Payload = typename Ops::Payload;
+    constexpr int B = pairBlockSize<Ops>();
+    if (count == B) {
+        if (order == SortOrder::Ascending) runPairBlock<Ops, Merge, false>(keys, values);
+        else runPairBlock<Ops, Merge, true>(keys, values);
+        return;
+    }
+    alignas(64) Key key_buffer[B];
+    alignas(64) Payload value_buffer[B] = {};
+    fillTrailingSentinel<Ops>(key_buffer + count, B - count, order);
+    std::memcpy(key_buffer, keys, sizeof(Key) * count);
+    std::memcpy(value_buffer, values, sizeof(Payload) * count);
+    if (order == SortOrder::Ascending) runPairBlock<Ops, Merge, false>(key_buffer, value_buffer);
+    else runPairBlock<Ops, Merge, true>(key_buffer, value_buffer);
+    std::memcpy(keys, key_buffer, sizeof(Key) * count);
+    std::memcpy(values, value_buffer, sizeof(Payload) * count);
+}
+
+template <typename Ops>
+inline void compareExchangePairVectors(typename Ops::Key* keys, typename Ops::Payload* values, int distance,
+                                       SortOrder order) {
+    typename Ops::Vec k_lo = Ops::load(keys);
+    typename Ops::Vec k_hi = Ops::load(keys + distance);
+    typename Ops::PVec p_lo = Ops::loadPayload(values);
+    typename Ops::PVec p_hi = Ops::loadPayload(values + distance);
+    if (order == SortOrder::Ascending) {
+        PairRegisterNetwork<Ops, 1, false>::compareExchange(k_lo, p_lo, k_hi, p_hi);
+    } else {
+        PairRegisterNetwork<Ops, 1, true>::compareExchange(k_lo, p_lo, k_hi, p_hi);
+    }
+    Ops::store(keys, k_lo);
+    Ops::store(keys + distance, k_hi);
+    Ops::storePayload(values, p_lo);
+    Ops::storePayload(values + distance, p_hi);
+}
+
+template <typename Ops>
+void compareAndSwapBlocksPairs(typename Ops::Key* keys, typename Ops::Payload* values, int distance, int count,
+                               SortOrder order) {
+    using Key = typename Ops::Key;
+    using Payload = typename Ops::Payload;
+    constexpr int W = Ops::WIDTH;
+    int i = 0;
+    for (; i + W <= count; i += W) {
+        compareExchangePairVectors<Ops>(keys + i, values + i, distance, order);
+    }
+    if (i < count) {
+        // Partial last vector, staged as in compareAndSwapBlocks; the lower half of each
+        // buffer holds the lo side and the upper half the hi side
+        const int rest = count - i;
+        alignas(64) Key key_buffer[2 * W];
+        alignas(64) Payload value_buffer[2 * W] = {};
+        fillTrailingSentinel<Ops>(key_buffer + rest, W - rest, order);
+        fillTrailingSentinel<Ops>(key_buffer + W + rest, W - rest, order);
+        std::memcpy(key_buffer, keys + i, sizeof(Key) * rest);
+        std::memcpy(key_buffer + W, keys + distance + i, sizeof(Key) * rest);
+        std::memcpy(value_buffer, values + i, sizeof(Payload) * rest);
+        std::memcpy(value_buffer + W, values + distance + i, sizeof(Payload) * rest);
+        compareExchangePairVectors<Ops>(key_buffer, value_buffer, W, order);
+        std::memcpy(keys + i, key_buffer, sizeof(Key) * rest);
+        std::memcpy(keys + distance + i, key_buffer + W, sizeof(Key) * rest);
+        std::memcpy(values + i, value_buffer, sizeof(Payload) * rest);
+        std::memcpy(values + distance + i, value_buffer + W, sizeof(Payload) * rest);
+    }
+}
+
+template <typename Ops>
+void sortBlockPairs(typename Ops::Key* keys, typename Ops::Payload* values, int count, SortOrder order) {
+    if (count > 1) {
+        pairBlockKernel<Ops, false>(keys, values, count, order);
+    }
+}
+
+template <typename Ops>
+void bitonicMergePairs(typename Ops::Key* keys, typename Ops::Payload* values, int count, SortOrder order) {
+    if (count <= 1) {
+        return;
+    }
+    if (count <= pairBlockSize<Ops>()) {
+        pairBlockKernel<Ops, true>(keys, values, count, order);
+        return;
+    }
+
+    int k = splitPoint<Ops>(count);
+    compareAndSwapBlocksPairs<Ops>(keys, values, k, count - k, order);
+    bitonicMergePairs<Ops>(keys, values, k, order);
+    bitonicMergePairs<Ops>(keys + k, values + k, count - k, order);
+}
+
+template <typename Ops>
+SIMDKernels<typename Ops::Key> makeKernels(SIMDIsa isa) {
+    SIMDKernels<typename Ops::Key> kernels{isa, Ops::WIDTH, blockSize<Ops>(),
+                                           &compareAndSwapBlocks<Ops>, &compareAndSwapBlocksStreaming<Ops>,
+                                           &sortBlock<Ops>, &bitonicMerge<Ops>,
+                                           &sortColumns<Ops>, &mergeSorted<Ops>, &sortedPrefix<Ops>,
+                                           0, nullptr, nullptr, nullptr};
+    if constexpr (sizeof(typename Ops::Key) >= 4) {
+        kernels.pairBlockSize = pairBlockSize<Ops>();
+        kernels.compareAndSwapBlocksPairs = &compareAndSwapBlocksPairs<Ops>;
+        kernels.sortBlockPairs = &sortBlockPairs<Ops>;
+        kernels.bitonicMergePairs = &bitonicMergePairs<Ops>;
+    }
+    return kernels;
+}
+
+} // namespace simd_kernels_impl
+
+#endif // SIMD_KERNELS_IMPL_H
@@ -0,0 +1,135 @@
+// Compiled with -msse4.1 (see src/CMakeLists.txt); only called after a CPUID check.
+#include "simd_kernels.h"
+#include "simd_kernels_impl.h"
+#include <immintrin.h>
+
+namespace {
+
+using simd_kernels_impl::laneBitMask;
+using simd_kernels_impl::xorShuffleImm4;
+
+// pshufb pattern that moves lane l to lane l ^ M for LB-byte lanes
+template <int LB, int M, int... I>
+inline __m128i xorBytePattern(std::integer_sequence<int, I...>) {
+    return _mm_setr_epi8(static_cast<char>(((I / LB) ^ M) * LB + I % LB)...);
+}
+
+// Lane movement for LB-byte lanes, shared by every key type of that width
+template <int LB>
+struct SSE41Lanes {
+    using Vec = __m128i;
+    static constexpr int WIDTH = 16 / LB;
+    template <int M> static Vec permuteXor(Vec v) {
+        if constexpr (LB >= 4) {
+            return _mm_shuffle_epi32(v, xorShuffleImm4(M * LB / 4));
+        } else {
+            return _mm_shuffle_epi8(v, xorBytePattern<LB, M>(std::make_integer_sequence<int, 16>{}));
+        }
+    }
+    template <int B> static Vec blendLaneBit(Vec a, Vec b) {
+        return _mm_blend_epi16(a, b, static_cast<int>(laneBitMask(8, 2, LB, B)));
+    }
+    // Compare results are all-ones/all-zero lanes, blended like data
+    using Mask = Vec;
+    template <int B> static Mask selectLaneBit(Mask a, Mask b) { return blendLaneBit<B>(a, b); }
+    static Vec select(Vec a, Vec b, Mask m) { return _mm_blendv_epi8(a, b, m); }
+    static bool equal(Vec a, Vec b) { return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) == 0xFFFF; }
+};
+
+template <typename T>
+struct SSE41IntLoadStore : SSE41Lanes<sizeof(T)> {
+    using Key = T;
+    using Vec = __m128i;
+    static Vec load(const T* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(T* p, Vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static Vec loadAligned(const T* p) { return _mm_load_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void storeAligned(T* p, Vec v) { _mm_store_si128(reinterpret_cast<__m128i*>(p), v); }
+    static void storeStream(T* p, Vec v) { _mm_stream_si128(reinterpret_cast<__m128i*>(p), v); }
+    static void streamFence() { _mm_sfence(); }
+    using Payload = PayloadOf<T>;
+    using PVec = Vec;
+    static PVec loadPayload(const Payload* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void storePayload(Payload* p, PVec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+};
+
+template <typename T> struct SSE41Ops;
+
+template <> struct SSE41Ops<std::int16_t> : SSE41IntLoadStore<std::int16_t> {
+    static Vec min(Vec a, Vec b) { return _mm_min_epi16(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm_max_epi16(a, b); }
+};
+
+template <> struct SSE41Ops<std::uint16_t> : SSE41IntLoadStore<std::uint16_t> {
+    static Vec min(Vec a, Vec b) { return _mm_min_epu16(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm_max_epu16(a, b); }
+};
+
+template <> struct SSE41Ops<std::int32_t> : SSE41IntLoadStore<std::int32_t> {
+    static Vec min(Vec a, Vec b) { return _mm_min_epi32(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm_max_epi32(a, b); }
+    static Mask greater(Vec a, Vec b) { return _mm_cmpgt_epi32(a, b); }
+};
+
+template <> struct SSE41Ops<std::uint32_t> : SSE41IntLoadStore<std::uint32_t> {
+    static Vec min(Vec a, Vec b) { return _mm_min_epu32(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm_max_epu32(a, b); }
+    static Mask greater(Vec a, Vec b) {
+        const __m128i sign = _mm_set1_epi32(INT32_MIN);
+        return _mm_cmpgt_epi32(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+    }
+};
+
+template <> struct SSE41Ops<std::int64_t> : SSE41IntLoadStore<std::int64_t> {
+    // SSE4.1 has no 64-bit compare: compare the high dwords signed and the low dwords
+    // unsigned (by flipping their sign bit), then combine as hi_gt | (hi_eq & lo_gt).
+    static Vec greater(Vec a, Vec b) {
+        const __m128i flip_low = _mm_set_epi32(0, INT32_MIN, 0, INT32_MIN);
+        __m128i ax = _mm_xor_si128(a, flip_low);
+        __m128i bx = _mm_xor_si128(b, flip_low);
+        __m128i gt = _mm_cmpgt_epi32(ax, bx);
+        __m128i eq = _mm_cmpeq_epi32(ax, bx);
+        __m128i gt_hi = _mm_shuffle_epi32(gt, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128i eq_hi = _mm_shuffle_epi32(eq, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128i gt_lo = _mm_shuffle_epi32(gt, _MM_SHUFFLE(2, 2, 0, 0));
+        return _mm_or_si128(gt_hi, _mm_and_si128(eq_hi, gt_lo));
+    }
+    static Vec min(Vec a, Vec b) { return _mm_blendv_epi8(a, b, greater(a, b)); }
+    static Vec max(Vec a, Vec b) { return _mm_blendv_epi8(b, a, greater(a, b)); }
+};
+
+// Floating-point keys are compared as totalOrder-mapped integers (see SortKeyTraits);
+// the mapping is its own inverse, so store applies it again.
+template <> struct SSE41Ops<float> : SSE41Ops<std::int32_t> {
+    using Key = float;
+    static Vec toOrdered(Vec v) { return _mm_xor_si128(v, _mm_srli_epi32(_mm_srai_epi32(v, 31), 1)); }
+    static Vec load(const float* p) { return toOrdered(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); }
+    static void store(float* p, Vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), toOrdered(v)); }
+    static Vec loadAligned(const float* p) { return toOrdered(_mm_load_si128(reinterpret_cast<const __m128i*>(p))); }
+    static void storeAligned(float* p, Vec v) { _mm_store_si128(reinterpret_cast<__m128i*>(p), toOrdered(v)); }
+    static void storeStream(float* p, Vec v) { _mm_stream_si128(reinterpret_cast<__m128i*>(p), toOrdered(v)); }
+};
+
+template <> struct SSE41Ops<double> : SSE41Ops<std::int64_t> {
+    using Key = double;
+    static Vec toOrdered(Vec v) {
+        __m128i sign = _mm_shuffle_epi32(_mm_srai_epi32(v, 31), _MM_SHUFFLE(3, 3, 1, 1));
+        return _mm_xor_si128(v, _mm_srli_epi64(sign, 1));
+    }
+    static Vec load(const double* p) { return toOrdered(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); }
+    static void store(double* p, Vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), toOrdered(v)); }
+    static Vec loadAligned(const double* p) { return toOrdered(_mm_load_si128(reinterpret_cast<const __m128i*>(p))); }
+    static void storeAligned(double* p, Vec v) { _mm_store_si128(reinterpret_cast<__m128i*>(p), toOrdered(v)); }
+    static void storeStream(double* p, Vec v) { _mm_stream_si128(reinterpret_cast<__m128i*>(p), toOrdered(v)); }
+};
+
+} // namespace
+
+template <typename T>
+const SIMDKernels<T>& getSSE41Kernels() {
+    static const SIMDKernels<T> kernels = simd_kernels_impl::makeKernels<SSE41Ops<T>>(SIMDIsa::SSE41);
+    return kernels;
+}
+
+#define INSTANTIATE_SSE41_KERNELS(T) template const SIMDKernels<T>& getSSE41Kernels<T>();
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_SSE41_KERNELS)
+#undef INSTANTIATE_SSE41_KERNELS
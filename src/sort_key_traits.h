@@ -0,0 +1,84 @@
+#ifndef SORT_KEY_TRAITS_H
+#define SORT_KEY_TRAITS_H
+
+#include <cstdint>
+#include <cstring> // For std::memcpy
+#include <limits>  // For std::numeric_limits
+#include <string>
+#include <type_traits>
+
+// Key types every sorter is instantiated for. Use with a macro taking one type argument,
+// e.g. BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_PLAIN_SORTER).
+#define BITONIC_SORT_FOR_EACH_KEY_TYPE(X) \
+    X(std::int16_t)                       \
+    X(std::uint16_t)                      \
+    X(std::int32_t)                       \
+    X(std::uint32_t)                      \
+    X(std::int64_t)                       \
+    X(float)                              \
+    X(double)
+
+// Ordering and padding sentinels for a key type.
+//   less(a, b)   strict weak ordering used by every scalar compare-and-swap
+//   highest()    a value no key sorts after; pads ascending sorts
+//   lowest()     a value no key sorts before; pads descending sorts
+template <typename T>
+struct SortKeyTraits;
+
+template <typename T>
+struct IntegerSortKeyTraits {
+    static bool less(T a, T b) { return a < b; }
+    static T highest() { return std::numeric_limits<T>::max(); }
+    static T lowest() { return std::numeric_limits<T>::min(); }
+};
+
+// Floating-point keys follow IEEE 754 totalOrder: -NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < +NaN.
+// Mapping the sign-magnitude bit pattern to two's complement makes that an integer compare,
+// which is also what the SIMD kernels do, so scalar and vector paths agree on NaN placement
+// and every compare-exchange is an exact permutation of the input bits.
+template <typename T, typename Bits>
+struct FloatSortKeyTraits {
+    static Bits toOrderedBits(T v) {
+        Bits bits;
+        std::memcpy(&bits, &v, sizeof(T));
+        return bits ^ static_cast<Bits>(static_cast<typename std::make_unsigned<Bits>::type>(bits >> (8 * sizeof(T) - 1)) >> 1);
+    }
+    static T fromBits(Bits bits) {
+        T v;
+        std::memcpy(&v, &bits, sizeof(T));
+        return v;
+    }
+    static bool less(T a, T b) { return toOrderedBits(a) < toOrderedBits(b); }
+    static T highest() { return fromBits(std::numeric_limits<Bits>::max()); } // +NaN, all payload bits set
+    static T lowest() { return fromBits(static_cast<Bits>(-1)); }            // -NaN, all payload bits set
+};
+
+template <> struct SortKeyTraits<std::int16_t> : IntegerSortKeyTraits<std::int16_t> {
+    static std::string name() { return "int16"; }
+};
+template <> struct SortKeyTraits<std::uint16_t> : IntegerSortKeyTraits<std::uint16_t> {
+    static std::string name() { return "uint16"; }
+};
+template <> struct SortKeyTraits<std::int32_t> : IntegerSortKeyTraits<std::int32_t> {
+    static std::string name() { return "int32"; }
+};
+template <> struct SortKeyTraits<std::uint32_t> : IntegerSortKeyTraits<std::uint32_t> {
+    static std::string name() { return "uint32"; }
+};
+template <> struct SortKeyTraits<std::int64_t> : IntegerSortKeyTraits<std::int64_t> {
+    static std::string name() { return "int64"; }
+};
+template <> struct SortKeyTraits<float> : FloatSortKeyTraits<float, std::int32_t> {
+    static std::string name() { return "float"; }
+};
+template <> struct SortKeyTraits<double> : FloatSortKeyTraits<double, std::int64_t> {
+    static std::string name() { return "double"; }
+};
+
+// Suffix appended to sorter names; int keeps the historical unsuffixed names.
+template <typename T>
+std::string keyTypeSuffix() {
+    return std::is_same<T, int>::value ? "" : "<" + SortKeyTraits<T>::name() + ">";
+}
+
+#endif // SORT_KEY_TRAITS_H
@@ -0,0 +1,172 @@
+#include "sort_profile.h"
+#include <cstdlib>   // For std::getenv
+#include <fstream>
+#include <limits>    // For std::numeric_limits
+#include <sstream>
+#include <stdexcept> // For std::invalid_argument, std::logic_error, std::runtime_error
+
+namespace {
+
+const SortBackend ALL_BACKENDS[] = {SortBackend::Plain,   SortBackend::StdThread, SortBackend::OpenMP,
+                                    SortBackend::SIMD,    SortBackend::Blocked,   SortBackend::Hybrid};
+const SIMDIsa ALL_ISAS[] = {SIMDIsa::Auto, SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512};
+
+std::runtime_error parseError(const std::string& path, int line, const std::string& what) {
+    return std::runtime_error("SortProfile: " + path + ":" + std::to_string(line) + ": " + what);
+}
+
+// "name=value" with a non-negative value that fits in Value
+template <typename Value>
+Value parseField(const std::string& token, const std::string& name) {
+    const std::string prefix = name + "=";
+    if (token.compare(0, prefix.size(), prefix) != 0) {
+        throw std::invalid_argument("expected " + prefix + "<n>, got '" + token + "'");
+    }
+    const std::string digits = token.substr(prefix.size());
+    std::size_t used = 0;
+    unsigned long long value = 0;
+    try {
+        value = std::stoull(digits, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (digits.empty() || used != digits.size() || digits[0] == '-' ||
+        value > static_cast<unsigned long long>(std::numeric_limits<Value>::max())) {
+        throw std::invalid_argument("bad value in '" + token + "'");
+    }
+    return static_cast<Value>(value);
+}
+
+} // namespace
+
+const char* sortBackendName(SortBackend backend) {
+    switch (backend) {
+        case SortBackend::Plain:     return "Plain";
+        case SortBackend::StdThread: return "StdThread";
+        case SortBackend::OpenMP:    return "OpenMP";
+        case SortBackend::SIMD:      return "SIMD";
+        case SortBackend::Blocked:   return "Blocked";
+        case SortBackend::Hybrid:    return "Hybrid";
+    }
+    return "Unknown";
+}
+
+SortBackend parseSortBackend(const std::string& name) {
+    for (SortBackend backend : ALL_BACKENDS) {
+        if (name == sortBackendName(backend)) {
+            return backend;
+        }
+    }
+    throw std::invalid_argument("unknown sort backend '" + name + "'");
+}
+
+const SortProfileEntry& SortProfile::find(std::size_t count) const {
+    if (entries.empty()) {
+        throw std::logic_error("SortProfile: the profile has no entries");
+    }
+    for (const SortProfileEntry& entry : entries) {
+        if (count <= entry.max_count) {
+            return entry;
+        }
+    }
+    return entries.back();
+}
+
+void SortProfile::save(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("SortProfile: cannot write " + path);
+    }
+    out << "# bitonic_sort profile: sorter and thresholds by input size, written by autotune\n";
+    out << "isa " << simdIsaName(isa) << "\n";
+    out << "threads " << threads << "\n";
+    for (const SortProfileEntry& entry : entries) {
+        out << "entry ";
+        if (entry.max_count == std::numeric_limits<std::size_t>::max()) {
+            out << "max";
+        } else {
+            out << entry.max_count;
+        }
+        out << " " << sortBackendName(entry.backend) << " sequential=" << entry.thresholds.sequential
+            << " grain=" << entry.thresholds.compare_grain << " block_bytes=" << entry.block_bytes << "\n";
+    }
+    if (!out.flush()) {
+        throw std::runtime_error("SortProfile: cannot write " + path);
+    }
+}
+
+SortProfile SortProfile::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("SortProfile: cannot read " + path);
+    }
+    SortProfile profile;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string keyword;
+        if (!(fields >> keyword)) {
+            continue;
+        }
+        std::vector<std::string> args;
+        for (std::string arg; fields >> arg;) {
+            args.push_back(arg);
+        }
+        try {
+            if (keyword == "isa" && args.size() == 1) {
+                bool known = false;
+                for (SIMDIsa isa : ALL_ISAS) {
+                    if (args[0] == simdIsaName(isa)) {
+                        profile.isa = isa;
+                        known = true;
+                    }
+                }
+                if (!known) {
+                    throw std::invalid_argument("unknown ISA '" + args[0] + "'");
+                }
+            } else if (keyword == "threads" && args.size() == 1) {
+                profile.threads = parseField<unsigned int>("threads=" + args[0], "threads");
+            } else if (keyword == "entry" && args.size() == 5) {
+                SortProfileEntry entry;
+                entry.max_count = args[0] == "max" ? std::numeric_limits<std::size_t>::max()
+                                                   : parseField<std::size_t>("max_count=" + args[0], "max_count");
+                entry.backend = parseSortBackend(args[1]);
+                entry.thresholds.sequential = parseField<int>(args[2], "sequential");
+                entry.thresholds.compare_grain = parseField<int>(args[3], "grain");
+                entry.block_bytes = parseField<std::size_t>(args[4], "block_bytes");
+                if (!profile.entries.empty() && entry.max_count <= profile.entries.back().max_count) {
+                    throw std::invalid_argument("entries must be in increasing order of size");
+                }
+                profile.entries.push_back(entry);
+            } else {
+                throw std::invalid_argument("unexpected line");
+            }
+        } catch (const std::invalid_argument& e) {
+            throw parseError(path, line_number, e.what());
+        }
+    }
+    if (profile.entries.empty()) {
+        throw parseError(path, line_number, "no entries");
+    }
+    return profile;
+}
+
+SortProfile SortProfile::defaults() {
+    SortProfile profile;
+    SortProfileEntry simd;
+    simd.max_count = DEFAULT_SIMD_MAX_COUNT;
+    simd.backend = SortBackend::SIMD;
+    SortProfileEntry hybrid;
+    hybrid.max_count = std::numeric_limits<std::size_t>::max();
+    hybrid.backend = SortBackend::Hybrid;
+    profile.entries = {simd, hybrid};
+    return profile;
+}
+
+std::string SortProfile::defaultPath() {
+    const char* path = std::getenv("BITONIC_SORT_PROFILE");
+    return (path && *path) ? path : "bitonic_sort_profile.txt";
+}
@@ -0,0 +1,58 @@
+#ifndef SORT_PROFILE_H
+#define SORT_PROFILE_H
+
+#include "bitonic_sort.h" // For ParallelThresholds
+#include <cstddef>        // For std::size_t
+#include <string>
+#include <vector>
+#include "cpu_features.h"
+
+// The sorters a profile can route to
+enum class SortBackend {
+    Plain,
+    StdThread,
+    OpenMP,
+    SIMD,    // SIMDBitonicSorter on the shared pool
+    Blocked,
+    Hybrid   // HybridBitonicSorter on the shared pool
+};
+
+const char* sortBackendName(SortBackend backend);
+// Throws std::invalid_argument for an unknown name
+SortBackend parseSortBackend(const std::string& name);
+
+// One tuned configuration, used for inputs of up to max_count keys
+struct SortProfileEntry {
+    std::size_t max_count = 0;
+    SortBackend backend = SortBackend::SIMD;
+    ParallelThresholds thresholds; // StdThread, OpenMP and SIMD; zero fields keep the defaults
+    std::size_t block_bytes = 0;   // Blocked's tile or Hybrid's block; 0 keeps the default
+};
+
+// What the autotuner found to be fastest on one host, by input size. Saved as text, one
+// setting or entry per line ('#' starts a comment):
+//   isa AVX2
+//   threads 8
+//   entry 4096 SIMD sequential=0 grain=0 block_bytes=0
+//   entry max Hybrid sequential=0 grain=0 block_bytes=524288
+struct SortProfile {
+    SIMDIsa isa = SIMDIsa::Auto;      // ISA the profile was tuned with
+    unsigned int threads = 0;         // Hardware threads of the tuning host
+    std::vector<SortProfileEntry> entries; // By increasing max_count
+
+    // The first entry whose max_count is at least count, else the last one. Throws
+    // std::logic_error for an empty profile.
+    const SortProfileEntry& find(std::size_t count) const;
+
+    // Throw std::runtime_error when the file cannot be written or read, or does not parse
+    void save(const std::string& path) const;
+    static SortProfile load(const std::string& path);
+
+    // Used without a profile file: SIMD up to DEFAULT_SIMD_MAX_COUNT keys, Hybrid above
+    static const std::size_t DEFAULT_SIMD_MAX_COUNT = 1 << 16;
+    static SortProfile defaults();
+    // $BITONIC_SORT_PROFILE if set, else "bitonic_sort_profile.txt" in the working directory
+    static std::string defaultPath();
+};
+
+#endif // SORT_PROFILE_H
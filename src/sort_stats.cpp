@@ -0,0 +1,255 @@
+#include "sort_stats.h"
+#include <algorithm> // For std::find_if, std::max, std::min
+#include <atomic>
+
+const char* sortPhaseName(SortPhase phase) {
+    switch (phase) {
+    case SortPhase::Sort: return "sort";
+    case SortPhase::Merge: return "merge";
+    case SortPhase::Copy: return "copy";
+    case SortPhase::Wait: return "wait";
+    default: return "unknown";
+    }
+}
+
+double SortStats::simdFraction() const {
+    const std::uint64_t total = compareExchanges();
+    return total > 0 ? static_cast<double>(simd_compare_exchanges) / total : 0.0;
+}
+
+double SortStats::idleSeconds() const {
+    double busy = 0.0;
+    for (const SortThreadStats& thread : threads) {
+        busy += thread.busy_seconds;
+    }
+    return std::max(0.0, wall_seconds * thread_count - busy);
+}
+
+double SortStats::utilization() const {
+    const double available = wall_seconds * thread_count;
+    return available > 0.0 ? std::min(1.0, (available - idleSeconds()) / available) : 0.0;
+}
+
+void SortStats::add(const SortStats& other, bool work_only) {
+    if (!work_only) {
+        calls += other.calls;
+        keys += other.keys;
+        wall_seconds += other.wall_seconds;
+    }
+    for (int p = 0; p < static_cast<int>(SortPhase::Count); ++p) {
+        phase_seconds[p] += other.phase_seconds[p];
+    }
+    scalar_compare_exchanges += other.scalar_compare_exchanges;
+    simd_compare_exchanges += other.simd_compare_exchanges;
+    swaps += other.swaps;
+    if (merge_strides.size() < other.merge_strides.size()) {
+        merge_strides.resize(other.merge_strides.size());
+    }
+    for (std::size_t s = 0; s < other.merge_strides.size(); ++s) {
+        merge_strides[s].passes += other.merge_strides[s].passes;
+        merge_strides[s].compare_exchanges += other.merge_strides[s].compare_exchanges;
+        merge_strides[s].seconds += other.merge_strides[s].seconds;
+    }
+    for (const SortThreadStats& thread : other.threads) {
+        auto same = std::find_if(threads.begin(), threads.end(),
+                                 [&](const SortThreadStats& t) { return t.thread == thread.thread; });
+        if (same == threads.end()) {
+            threads.push_back(thread);
+        } else {
+            same->busy_seconds += thread.busy_seconds;
+            same->wait_seconds += thread.wait_seconds;
+        }
+    }
+    thread_count = std::max(thread_count, other.thread_count);
+}
+
+std::uint64_t bitonicMergeComparators(std::uint64_t count) {
+    // A power of two p takes p / 2 * log2(p); otherwise the count - k pairs of the first
+    // level, the power-of-two half and the rest
+    std::uint64_t total = 0;
+    while (count > 1) {
+        std::uint64_t k = 1;
+        while (k < count - k) {
+            k *= 2;
+        }
+        if (k == count - k) {
+            int levels = 0;
+            while ((std::uint64_t(1) << levels) < count) {
+                ++levels;
+            }
+            return total + count / 2 * levels;
+        }
+        total += count - k;
+        total += bitonicMergeComparators(k);
+        count -= k;
+    }
+    return total;
+}
+
+std::uint64_t bitonicSortComparators(std::uint64_t count) {
+    std::uint64_t total = 0;
+    while (count > 1) {
+        std::uint64_t k = 1;
+        while (k < count - k) {
+            k *= 2;
+        }
+        total += bitonicMergeComparators(count);
+        if (k == count - k) {
+            // Both halves are powers of two: 2^(p-1) * p * (p + 1) / 2 for a sort of 2^p
+            int levels = 0;
+            while ((std::uint64_t(1) << levels) < k) {
+                ++levels;
+            }
+            return total + 2 * (k / 2 * levels * (levels + 1) / 2);
+        }
+        total += bitonicSortComparators(k);
+        count -= k;
+    }
+    return total;
+}
+
+#ifdef BITONIC_SORT_STATS
+
+namespace sort_stats_detail {
+thread_local ThreadCounters thread_counters;
+} // namespace sort_stats_detail
+
+namespace {
+
+thread_local SortStatsTimer* current_timer = nullptr;
+
+// Small dense number of the running thread, for SortStatsRecorder::thread_slots_
+int threadNumber() {
+    static std::atomic<int> next{0};
+    thread_local const int number = next.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+} // namespace
+
+SortStats SortStatsRecorder::get() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void SortStatsRecorder::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const unsigned int thread_count = stats_.thread_count;
+    stats_ = SortStats();
+    stats_.thread_count = thread_count;
+    thread_slots_.clear();
+}
+
+void SortStatsRecorder::setThreadCount(unsigned int threads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.thread_count = std::max(1u, threads);
+}
+
+void SortStatsRecorder::add(const SortStats& other, bool work_only) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const unsigned int thread_count = stats_.thread_count;
+    stats_.add(other, work_only);
+    stats_.thread_count = thread_count;
+    for (std::size_t t = 0; t < stats_.threads.size(); ++t) {
+        const int number = stats_.threads[t].thread;
+        if (thread_slots_.size() <= static_cast<std::size_t>(number)) {
+            thread_slots_.resize(number + 1, -1);
+        }
+        thread_slots_[number] = static_cast<int>(t);
+    }
+}
+
+void SortStatsRecorder::addStride(int stride, std::uint64_t compare_exchanges, double seconds) {
+    int log2 = 0;
+    while ((1 << (log2 + 1)) <= stride) {
+        ++log2;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.merge_strides.size() <= static_cast<std::size_t>(log2)) {
+        stats_.merge_strides.resize(log2 + 1);
+    }
+    MergeStrideStats& level = stats_.merge_strides[log2];
+    ++level.passes;
+    level.compare_exchanges += compare_exchanges;
+    level.seconds += seconds;
+}
+
+void SortStatsRecorder::addCall(std::size_t keys, double seconds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.calls;
+    stats_.keys += keys;
+    stats_.wall_seconds += seconds;
+}
+
+void SortStatsRecorder::addWork(SortPhase phase, double seconds, const sort_stats_detail::ThreadCounters& counts) {
+    const int number = threadNumber();
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.phase_seconds[static_cast<int>(phase)] += seconds;
+    stats_.scalar_compare_exchanges += counts.scalar_compare_exchanges;
+    stats_.simd_compare_exchanges += counts.simd_compare_exchanges;
+    stats_.swaps += counts.swaps;
+    if (thread_slots_.size() <= static_cast<std::size_t>(number)) {
+        thread_slots_.resize(number + 1, -1);
+    }
+    if (thread_slots_[number] < 0) {
+        thread_slots_[number] = static_cast<int>(stats_.threads.size());
+        stats_.threads.emplace_back();
+        stats_.threads.back().thread = number;
+    }
+    SortThreadStats& thread = stats_.threads[thread_slots_[number]];
+    (phase == SortPhase::Wait ? thread.wait_seconds : thread.busy_seconds) += seconds;
+}
+
+SortStatsTimer::SortStatsTimer(SortStatsRecorder* recorder, SortPhase phase)
+    : recorder_(recorder), phase_(phase), parent_(current_timer) {
+    if (!recorder_) {
+        return;
+    }
+    start_ = resumed_ = Clock::now();
+    if (parent_) {
+        parent_->charge(start_);
+    } else {
+        // Counts left over from code that ran outside any timer belong to no sorter
+        sort_stats_detail::thread_counters = sort_stats_detail::ThreadCounters();
+    }
+    current_timer = this;
+}
+
+SortStatsTimer::SortStatsTimer(SortPhase phase)
+    : SortStatsTimer(current_timer ? current_timer->recorder_ : nullptr, phase) {
+}
+
+SortStatsTimer::~SortStatsTimer() {
+    if (!recorder_) {
+        return;
+    }
+    const Clock::time_point now = Clock::now();
+    charge(now);
+    current_timer = parent_;
+    if (parent_) {
+        parent_->resumed_ = now;
+    }
+}
+
+void SortStatsTimer::charge(Clock::time_point now) {
+    const std::chrono::duration<double> elapsed = now - resumed_;
+    recorder_->addWork(phase_, elapsed.count(), sort_stats_detail::thread_counters);
+    sort_stats_detail::thread_counters = sort_stats_detail::ThreadCounters();
+    resumed_ = now;
+}
+
+SortStatsCall::SortStatsCall(SortStatsRecorder* recorder, SortPhase phase, std::size_t keys)
+    : SortStatsTimer(recorder, phase), keys_(keys), outermost_(recorder != nullptr) {
+    for (SortStatsTimer* outer = parent_; outer && outermost_; outer = outer->parent_) {
+        outermost_ = outer->recorder_ != recorder;
+    }
+}
+
+SortStatsCall::~SortStatsCall() {
+    if (outermost_) {
+        const std::chrono::duration<double> elapsed = Clock::now() - start_;
+        recorder_->addCall(keys_, elapsed.count());
+    }
+}
+
+#endif // BITONIC_SORT_STATS
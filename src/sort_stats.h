@@ -0,0 +1,232 @@
+#ifndef SORT_STATS_H
+#define SORT_STATS_H
+
+#include <cstddef>   // For std::size_t
+#include <cstdint>   // For std::uint64_t
+#include <vector>
+#ifdef BITONIC_SORT_STATS
+#include <chrono>
+#include <mutex>
+#endif
+
+// Built-in instrumentation of the sorters, compiled in only with -DBITONIC_SORT_STATS (the
+// BITONIC_SORT_STATS CMake option). Without it every recording call below is an empty
+// inline function and getStats() returns zeros.
+#ifdef BITONIC_SORT_STATS
+constexpr bool SORT_STATS_ENABLED = true;
+#else
+constexpr bool SORT_STATS_ENABLED = false;
+#endif
+
+// Where a sorter's thread time goes. Each interval is charged to the innermost phase open
+// on its thread, so nested phases never count twice.
+enum class SortPhase {
+    Sort,  // Producing sorted runs of up to SortStats::MIN_TIMED_KEYS keys
+    Merge, // Merges of larger runs
+    Copy,  // Laying out inputs and copying results: merge()'s bitonic copy, scratch copies
+    Wait,  // Joining forked work with nothing left to run
+    Count
+};
+
+const char* sortPhaseName(SortPhase phase);
+
+// One merge level run as its own pass over the data
+struct MergeStrideStats {
+    std::uint64_t passes = 0;
+    std::uint64_t compare_exchanges = 0;
+    double seconds = 0.0; // Wall time of the passes
+};
+
+// Time one thread spent on a sorter's calls
+struct SortThreadStats {
+    int thread = 0;            // Process-wide number of the thread, by first use
+    double busy_seconds = 0.0; // In the Sort, Merge and Copy phases
+    double wait_seconds = 0.0; // In the Wait phase
+};
+
+// Totals since the sorter was created or last reset. Phase and thread times add up the
+// threads, so with several threads they exceed wall_seconds.
+struct SortStats {
+    std::uint64_t calls = 0; // sort, sortPairs, sortSegments, merge and topK calls
+    std::uint64_t keys = 0;
+    double wall_seconds = 0.0;
+    double phase_seconds[static_cast<int>(SortPhase::Count)] = {};
+
+    // Comparators of the network. Scalar ones are counted as they run; SIMD kernel calls
+    // add the comparators of the network they evaluate, lanes holding padding excluded.
+    std::uint64_t scalar_compare_exchanges = 0;
+    std::uint64_t simd_compare_exchanges = 0;
+    // Scalar compare-exchanges that swapped. SIMD compare-exchanges are branchless min/max
+    // and have no swap count.
+    std::uint64_t swaps = 0;
+
+    // Indexed by log2 of the stride. Only levels with a stride of at least
+    // MIN_TIMED_STRIDE that run as a separate pass are listed; smaller strides, and all of
+    // those inside a single kernel call, are part of the phase times only.
+    std::vector<MergeStrideStats> merge_strides;
+
+    // Threads that worked on the sorter, in the order they first did
+    std::vector<SortThreadStats> threads;
+    // Threads the sorter can run on, for idle time: workers plus the caller
+    unsigned int thread_count = 1;
+
+    double phaseSeconds(SortPhase phase) const { return phase_seconds[static_cast<int>(phase)]; }
+    std::uint64_t compareExchanges() const { return scalar_compare_exchanges + simd_compare_exchanges; }
+    // Share of the compare-exchanges done by SIMD kernels, 0 without any
+    double simdFraction() const;
+    // Wall time of the calls times thread_count, less the busy time of every thread
+    double idleSeconds() const;
+    // Busy time over wall time times thread_count
+    double utilization() const;
+
+    // Adds other's counts and times. With work_only, other's calls, keys and wall time are
+    // left out, for the inner sorter of a sorter that times the calls itself.
+    void add(const SortStats& other, bool work_only = false);
+
+    static const int MIN_TIMED_KEYS = 2048;
+    static const int MIN_TIMED_STRIDE = 1024;
+};
+
+// Comparators in the bitonic networks on count elements (see BasicBitonicSort)
+std::uint64_t bitonicMergeComparators(std::uint64_t count);
+std::uint64_t bitonicSortComparators(std::uint64_t count);
+
+#ifdef BITONIC_SORT_STATS
+
+namespace sort_stats_detail {
+// The running thread's counts, moved to a recorder by its innermost timer
+struct ThreadCounters {
+    std::uint64_t scalar_compare_exchanges = 0;
+    std::uint64_t simd_compare_exchanges = 0;
+    std::uint64_t swaps = 0;
+};
+extern thread_local ThreadCounters thread_counters;
+} // namespace sort_stats_detail
+
+// A sorter's SortStats, updated by the timers below from any thread. Copies start empty.
+class SortStatsRecorder {
+public:
+    SortStatsRecorder() = default;
+    SortStatsRecorder(const SortStatsRecorder&) {}
+    SortStatsRecorder& operator=(const SortStatsRecorder&) { return *this; }
+
+    SortStats get() const;
+    void reset();
+    void setThreadCount(unsigned int threads);
+    void add(const SortStats& other, bool work_only);
+
+    void addStride(int stride, std::uint64_t compare_exchanges, double seconds);
+    // The rest are called by the timers
+    void addCall(std::size_t keys, double seconds);
+    void addWork(SortPhase phase, double seconds, const sort_stats_detail::ThreadCounters& counts);
+
+private:
+    mutable std::mutex mutex_;
+    SortStats stats_;
+    std::vector<int> thread_slots_; // Index in stats_.threads by thread number, -1 if none
+};
+
+// Charges the time until it is destroyed to phase on recorder, less the time of timers
+// opened inside it on the same thread, and moves the thread's compare-exchange counts to
+// recorder. A timer without a recorder takes the one of the timer it is opened in, and
+// does nothing outside of one.
+class SortStatsTimer {
+public:
+    SortStatsTimer(SortStatsRecorder* recorder, SortPhase phase);
+    explicit SortStatsTimer(SortPhase phase);
+    ~SortStatsTimer();
+    SortStatsTimer(const SortStatsTimer&) = delete;
+    SortStatsTimer& operator=(const SortStatsTimer&) = delete;
+
+protected:
+    friend class SortStatsCall;
+    using Clock = std::chrono::steady_clock;
+    SortStatsRecorder* recorder_;
+    SortPhase phase_;
+    SortStatsTimer* parent_;
+    Clock::time_point start_;
+    Clock::time_point resumed_;
+
+    // Charges the time since resumed_ and the thread's counts to recorder_
+    void charge(Clock::time_point now);
+};
+
+// The timer of a public entry point: also counts the call and its wall time, unless it is
+// opened inside another call on the same recorder
+class SortStatsCall : public SortStatsTimer {
+public:
+    SortStatsCall(SortStatsRecorder* recorder, SortPhase phase, std::size_t keys);
+    ~SortStatsCall();
+
+private:
+    std::size_t keys_;
+    bool outermost_;
+};
+
+// Wall time of one merge level run as a pass with stride stride over pairs compare-exchanges
+class SortStatsStride {
+public:
+    SortStatsStride(SortStatsRecorder* recorder, int stride, int pairs)
+        : recorder_(stride >= SortStats::MIN_TIMED_STRIDE ? recorder : nullptr), stride_(stride), pairs_(pairs) {
+        if (recorder_) start_ = std::chrono::steady_clock::now();
+    }
+    ~SortStatsStride() {
+        if (recorder_) {
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+            recorder_->addStride(stride_, static_cast<std::uint64_t>(pairs_), elapsed.count());
+        }
+    }
+    SortStatsStride(const SortStatsStride&) = delete;
+    SortStatsStride& operator=(const SortStatsStride&) = delete;
+
+private:
+    SortStatsRecorder* recorder_;
+    int stride_;
+    int pairs_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+inline void countScalarCompareExchange(bool swapped) {
+    ++sort_stats_detail::thread_counters.scalar_compare_exchanges;
+    sort_stats_detail::thread_counters.swaps += swapped;
+}
+
+// simd is false for the Scalar kernels, whose compare-exchanges count as scalar
+inline void countKernelCompareExchanges(std::uint64_t count, bool simd) {
+    if (simd) sort_stats_detail::thread_counters.simd_compare_exchanges += count;
+    else sort_stats_detail::thread_counters.scalar_compare_exchanges += count;
+}
+
+#else // !BITONIC_SORT_STATS
+
+class SortStatsRecorder {
+public:
+    SortStats get() const { return SortStats(); }
+    void reset() {}
+    void setThreadCount(unsigned int) {}
+    void add(const SortStats&, bool) {}
+    void addStride(int, std::uint64_t, double) {}
+};
+
+class SortStatsTimer {
+public:
+    SortStatsTimer(SortStatsRecorder*, SortPhase) {}
+    explicit SortStatsTimer(SortPhase) {}
+};
+
+class SortStatsCall {
+public:
+    SortStatsCall(SortStatsRecorder*, SortPhase, std::size_t) {}
+};
+
+class SortStatsStride {
+public:
+    SortStatsStride(SortStatsRecorder*, int, int) {}
+};
+
+inline void countScalarCompareExchange(bool) {}
+inline void countKernelCompareExchanges(std::uint64_t, bool) {}
+
+#endif // BITONIC_SORT_STATS
+
+#endif // SORT_STATS_H
@@ -0,0 +1,43 @@
+#include "sort_workspace.h"
+#include <new> // For std::align_val_t
+
+SortWorkspace::Lease::Lease(SortWorkspace& workspace) : workspace_(&workspace), lock_(workspace.mutex_, std::try_to_lock) {
+    if (!lock_.owns_lock()) {
+        own_ = std::make_unique<SortWorkspace>();
+        workspace_ = own_.get();
+    }
+}
+
+std::size_t SortWorkspace::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t total = 0;
+    for (std::size_t bytes : bytes_) {
+        total += bytes;
+    }
+    return total;
+}
+
+void SortWorkspace::release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int s = 0; s < SLOTS; ++s) {
+        blocks_[s].reset();
+        bytes_[s] = 0;
+    }
+}
+
+void SortWorkspace::AlignedDelete::operator()(unsigned char* block) const {
+    ::operator delete(block, std::align_val_t(ALIGNMENT));
+}
+
+void* SortWorkspace::reserve(int slot, std::size_t bytes) {
+    if (bytes > bytes_[slot]) {
+        // Drop the old block first: its contents are not kept, and both at once would
+        // raise the peak
+        blocks_[slot].reset();
+        bytes_[slot] = 0;
+        const std::size_t rounded = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        blocks_[slot].reset(static_cast<unsigned char*>(::operator new(rounded, std::align_val_t(ALIGNMENT))));
+        bytes_[slot] = rounded;
+    }
+    return blocks_[slot].get();
+}
@@ -0,0 +1,62 @@
+#ifndef SORT_WORKSPACE_H
+#define SORT_WORKSPACE_H
+
+#include <cstddef> // For std::size_t
+#include <memory>  // For std::unique_ptr
+#include <mutex>
+#include <type_traits>
+
+// A sorter's scratch memory, kept between calls: each slot is one 64-byte-aligned block
+// that grows when a call needs more than it holds and is otherwise reused, so repeated
+// sorts of same-sized inputs allocate nothing after the first. Copies start empty.
+class SortWorkspace {
+public:
+    static const std::size_t ALIGNMENT = 64;
+    static const int SLOTS = 4;
+
+    SortWorkspace() = default;
+    SortWorkspace(const SortWorkspace&) {}
+    SortWorkspace& operator=(const SortWorkspace&) { return *this; }
+
+    // Exclusive use of a workspace for one call. A call that finds the workspace in use by
+    // another thread gets a private one for its duration instead, so concurrent calls on
+    // one sorter stay correct and only they allocate.
+    class Lease {
+    public:
+        explicit Lease(SortWorkspace& workspace);
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        // Uninitialized room for count objects of U in slot, valid until the lease ends or
+        // slot is requested again. Distinct slots never overlap.
+        template <typename U>
+        U* get(int slot, std::size_t count) {
+            static_assert(std::is_trivially_copyable<U>::value && alignof(U) <= ALIGNMENT,
+                          "workspace buffers hold trivially copyable keys and payloads");
+            return static_cast<U*>(workspace_->reserve(slot, count * sizeof(U)));
+        }
+
+    private:
+        std::unique_ptr<SortWorkspace> own_;
+        SortWorkspace* workspace_;
+        std::unique_lock<std::mutex> lock_;
+    };
+
+    // Bytes held across all slots
+    std::size_t capacity() const;
+    // Frees every slot; the next call that needs scratch allocates again
+    void release();
+
+private:
+    struct AlignedDelete {
+        void operator()(unsigned char* block) const;
+    };
+
+    void* reserve(int slot, std::size_t bytes);
+
+    std::unique_ptr<unsigned char[], AlignedDelete> blocks_[SLOTS];
+    std::size_t bytes_[SLOTS] = {};
+    mutable std::mutex mutex_;
+};
+
+#endif // SORT_WORKSPACE_H
@@ -0,0 +1,110 @@
+#ifndef STATIC_BITONIC_SORTER_H
+#define STATIC_BITONIC_SORTER_H
+
+#include "bitonic_sort.h" // For SortOrder
+#include "sort_key_traits.h"
+#include <array>
+#include <cstddef> // For std::size_t
+
+// Bitonic network on exactly N keys, N a power of two, fixed at compile time: every level is
+// instantiated with its stride as a constant, so the loops have constant bounds and indices
+// and compile to straight-line branchless compare-exchanges on a local copy of the keys
+// (small N fully unrolled, larger N vectorized along the contiguous runs of each level).
+// There is no recursion, virtual call or runtime order to pay for, which dominates at the
+// small sizes that get sorted over and over. The SIMD kernels' sortBlock is the vector
+// counterpart: an in-register network sized to the input.
+//
+// BasicPlainBitonicSorter uses it, through sortWithStaticNetwork, for inputs of 8 to 256
+// keys whose count is a power of two.
+template <typename T, std::size_t N, SortOrder Order = SortOrder::Ascending>
+class BasicStaticBitonicSorter {
+public:
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "BasicStaticBitonicSorter: N must be a power of two");
+
+    static constexpr std::size_t LOG2_N = [] {
+        std::size_t log = 0;
+        while ((std::size_t(1) << log) < N) ++log;
+        return log;
+    }();
+    static constexpr std::size_t COMPARATORS = N / 2 * LOG2_N * (LOG2_N + 1) / 2;
+
+    static void sort(T* data) {
+        std::array<T, N> keys;
+        for (std::size_t i = 0; i < N; ++i) keys[i] = data[i];
+        sortFrom<2>(keys);
+        for (std::size_t i = 0; i < N; ++i) data[i] = keys[i];
+    }
+
+    static void sort(std::array<T, N>& data) { sort(data.data()); }
+
+private:
+    // Puts the key that comes first in Order at lo
+    static inline void compareExchange(std::array<T, N>& keys, std::size_t lo, std::size_t hi) {
+        const T a = keys[lo];
+        const T b = keys[hi];
+        const bool swap = (Order == SortOrder::Ascending) ? SortKeyTraits<T>::less(b, a) : SortKeyTraits<T>::less(a, b);
+        keys[lo] = swap ? b : a;
+        keys[hi] = swap ? a : b;
+    }
+
+    // The "flip" formulation, as the SIMD RegisterNetwork: merging runs of Size / 2 starts by
+    // pairing e with e ^ (Size - 1), so every comparator puts the first key at the lower index
+    // and no level needs a per-block direction
+    template <std::size_t Size>
+    static inline void flip(std::array<T, N>& keys) {
+        for (std::size_t block = 0; block < N; block += Size) {
+            for (std::size_t i = 0; i < Size / 2; ++i) {
+                compareExchange(keys, block + i, block + Size - 1 - i);
+            }
+        }
+    }
+
+    template <std::size_t Stride>
+    static inline void halfCleanersFrom(std::array<T, N>& keys) {
+        if constexpr (Stride >= 1) {
+            for (std::size_t block = 0; block < N; block += 2 * Stride) {
+                for (std::size_t i = 0; i < Stride; ++i) {
+                    compareExchange(keys, block + i, block + Stride + i);
+                }
+            }
+            halfCleanersFrom<Stride / 2>(keys);
+        }
+    }
+
+    template <std::size_t Size>
+    static inline void sortFrom(std::array<T, N>& keys) {
+        if constexpr (Size <= N) {
+            flip<Size>(keys);
+            halfCleanersFrom<Size / 4>(keys);
+            sortFrom<Size * 2>(keys);
+        }
+    }
+};
+
+template <std::size_t N, SortOrder Order = SortOrder::Ascending>
+using StaticBitonicSorter = BasicStaticBitonicSorter<int, N, Order>;
+
+// Sorts data[0, count) with the static network for count and returns true when count is
+// 8, 16, 32, 64, 128 or 256; returns false and leaves data alone otherwise
+template <typename T>
+bool sortWithStaticNetwork(T* data, std::size_t count, SortOrder order) {
+    const bool ascending = order == SortOrder::Ascending;
+    switch (count) {
+#define STATIC_NETWORK_CASE(N)                                                        \
+    case N:                                                                           \
+        if (ascending) BasicStaticBitonicSorter<T, N, SortOrder::Ascending>::sort(data);  \
+        else BasicStaticBitonicSorter<T, N, SortOrder::Descending>::sort(data);           \
+        return true;
+        STATIC_NETWORK_CASE(8)
+        STATIC_NETWORK_CASE(16)
+        STATIC_NETWORK_CASE(32)
+        STATIC_NETWORK_CASE(64)
+        STATIC_NETWORK_CASE(128)
+        STATIC_NETWORK_CASE(256)
+#undef STATIC_NETWORK_CASE
+        default:
+            return false;
+    }
+}
+
+#endif // STATIC_BITONIC_SORTER_H
@@ -1,125 +1,140 @@
 #include "std_thread_bitonic_sorter.h"
-#include <cmath>    // For std::pow, std::log2, std::ceil
-#include <limits>   // For std::numeric_limits
 #include <iostream> // For debugging
-#include <functional> // for std::ref needed for threads
 
-StdThreadBitonicSorter::StdThreadBitonicSorter(unsigned int max_threads)
+template <typename T>
+BasicStdThreadBitonicSorter<T>::BasicStdThreadBitonicSorter(unsigned int max_threads)
     : max_threads_(max_threads > 0 ? max_threads : std::thread::hardware_concurrency()) {
     if (max_threads_ == 0) max_threads_ = 1; // Ensure at least one thread
+    pool_ = std::make_shared<WorkStealingThreadPool>(max_threads_ - 1);
+    this->stats_.setThreadCount(max_threads_);
 }
 
-void StdThreadBitonicSorter::padData(std::vector<int>& arr, int& original_size, int& padded_size, SortOrder order) {
-    original_size = arr.size();
-    if (original_size == 0) {
-        padded_size = 0;
-        return;
-    }
-    padded_size = std::pow(2, std::ceil(std::log2(original_size)));
-    if (padded_size > original_size) {
-        // Use min for ascending if padding with smaller numbers helps, max for descending
-        // Standard bitonic sort requires power-of-2. Padding ensures this.
-        // The values used for padding should not affect the sorted order of original elements.
-        // Using INT_MAX for ascending and INT_MIN for descending should generally work
-        // if they are not part of the actual dataset extremes.
-        arr.resize(padded_size, (order == SortOrder::Ascending) ? std::numeric_limits<int>::max() : std::numeric_limits<int>::min());
+template <typename T>
+BasicStdThreadBitonicSorter<T>::BasicStdThreadBitonicSorter(std::shared_ptr<WorkStealingThreadPool> pool)
+    : max_threads_(pool ? pool->getWorkerCount() + 1 : 1), pool_(std::move(pool)) {
+    if (!pool_) {
+        throw std::invalid_argument("StdThreadBitonicSorter: pool must not be null");
     }
+    this->stats_.setThreadCount(max_threads_);
 }
 
-void StdThreadBitonicSorter::unpadData(std::vector<int>& arr, int original_size, int padded_size) {
-    if (padded_size > original_size) {
-        arr.resize(original_size);
-    }
+template <typename T>
+void BasicStdThreadBitonicSorter<T>::setThresholds(ParallelThresholds thresholds) {
+    thresholds_ = resolveThresholds(thresholds, {SEQUENTIAL_THRESHOLD, PARALLEL_COMPARE_GRAIN});
 }
 
-void StdThreadBitonicSorter::sort(std::vector<int>& arr, SortOrder order) {
-    if (arr.empty()) {
-        return;
-    }
-
-    int original_size = 0;
-    int padded_size = 0;
-    bool is_power_of_two = (arr.size() > 0) && ((arr.size() & (arr.size() - 1)) == 0);
-
-    if (!is_power_of_two) {
-        padData(arr, original_size, padded_size, order);
-    } else {
-        original_size = arr.size();
-        padded_size = arr.size();
+template <typename T>
+void BasicStdThreadBitonicSorter<T>::sort(T* data, std::size_t count, SortOrder order) {
+    if (count > 1) {
+        SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+        bitonicSortRecursiveParallel(data, 0, this->checkedCount(count), order);
     }
+}
 
-    current_threads_ = 1; // Main thread counts as one
-    if (padded_size > 0) {
-       bitonicSortRecursiveParallel(arr, 0, padded_size, order, 0);
+template <typename T>
+void BasicStdThreadBitonicSorter<T>::sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) {
+    if (count > 1) {
+        SortStatsCall call(&this->stats_, SortPhase::Sort, count);
+        typename BasicBitonicSort<T>::KeyValueArrays kv{keys, values};
+        bitonicSortRecursiveParallel(kv, 0, this->checkedCount(count), order);
     }
+}
 
-    if (!is_power_of_two && padded_size > 0) {
-        unpadData(arr, original_size, padded_size);
-         // After unpadding, if the original order was descending, the padding values (INT_MIN)
-         // might be at the end. Re-sort the original range if necessary, or ensure padding
-         // logic is robust. For now, assume unpadData is sufficient.
-         // A more robust padding would use values guaranteed to be outside the actual data range
-         // or handle them carefully.
-    }
+template <typename T>
+void BasicStdThreadBitonicSorter<T>::merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out,
+                                           SortOrder order) {
+    const int count = this->checkedCount(na + nb);
+    SortStatsCall call(&this->stats_, SortPhase::Merge, na + nb);
+    this->copyBitonic(a, na, b, nb, out);
+    bitonicMergeParallel(out, 0, count, order);
 }
 
-std::string StdThreadBitonicSorter::getName() const {
-    return "StdThreadBitonicSorter(max_threads=" + std::to_string(max_threads_) + ")";
+template <typename T>
+std::string BasicStdThreadBitonicSorter<T>::getName() const {
+    return "StdThreadBitonicSorter" + keyTypeSuffix<T>() + "(max_threads=" + std::to_string(max_threads_) + ")";
 }
 
-void StdThreadBitonicSorter::bitonicSortRecursiveParallel(std::vector<int>& arr, int low, int count, SortOrder order, unsigned int depth) {
+template <typename T>
+template <typename Arr>
+void BasicStdThreadBitonicSorter<T>::bitonicSortRecursiveParallel(Arr& arr, int low, int count, SortOrder order) {
     if (count <= 1) {
         return;
     }
 
-    int k = count / 2;
-
-    // Determine if we can spawn more threads
-    // current_threads_ is a rough estimate of active threads for depth control.
-    // A more sophisticated approach might use a thread pool or std::async with futures.
-    bool can_spawn_thread = (current_threads_ * 2 <= max_threads_) && (count > SEQUENTIAL_THRESHOLD);
-
-    if (can_spawn_thread) {
-        current_threads_ += 2; // Tentatively increment for the two potential new threads
-
-        std::thread t1(&StdThreadBitonicSorter::bitonicSortRecursiveParallel, this, std::ref(arr), low, k, SortOrder::Ascending, depth + 1);
-        // Sort second half in descending order (this is standard bitonic step)
-        bitonicSortRecursiveParallel(arr, low + k, k, SortOrder::Descending, depth + 1);
-        t1.join();
-
-        current_threads_ -= 2; // Decrement after threads are done
+    // Power-of-two first part sorted against the final order, the rest along it (see
+    // BasicBitonicSort::bitonicMerge)
+    int k = this->splitPoint(count);
+    SortOrder first_order = this->oppositeOrder(order);
+
+    // Fork the first part into the pool and sort the rest on this thread. An idle
+    // worker steals the fork; if none is idle, wait() runs it here.
+    bool can_fork = (pool_->getWorkerCount() > 0) && (count > thresholds_.sequential);
+
+    if (can_fork) {
+        WorkStealingThreadPool::TaskGroup group;
+        pool_->submit(group, [&] {
+            SortStatsTimer timer(&this->stats_, SortPhase::Sort);
+            bitonicSortRecursiveParallel(arr, low, k, first_order);
+        });
+        bitonicSortRecursiveParallel(arr, low + k, count - k, order);
+        pool_->wait(group);
     } else {
         // Sequential execution for this level
-        bitonicSortRecursive(arr, low, k, SortOrder::Ascending); // Uses base class sequential version
-        bitonicSortRecursive(arr, low + k, k, SortOrder::Descending); // Uses base class sequential version
+        this->bitonicSortRecursive(arr, low, k, first_order); // Uses base class sequential version
+        this->bitonicSortRecursive(arr, low + k, count - k, order); // Uses base class sequential version
     }
 
     // Merge the whole sequence (parallel or sequential)
-    bitonicMergeParallel(arr, low, count, order, depth);
+    bitonicMergeParallel(arr, low, count, order);
 }
 
-void StdThreadBitonicSorter::bitonicMergeParallel(std::vector<int>& arr, int low, int count, SortOrder order, unsigned int depth) {
+template <typename T>
+template <typename Arr>
+void BasicStdThreadBitonicSorter<T>::bitonicMergeParallel(Arr& arr, int low, int count, SortOrder order) {
     if (count <= 1) {
         return;
     }
 
-    int k = count / 2;
-    for (int i = low; i < low + k; ++i) {
-        compareAndSwap(arr, i, i + k, order);
+    // Only the first count - k elements have a partner; the rest would meet virtual padding
+    int k = this->splitPoint(count);
+    int pairs = count - k;
+    // Merges of up to MIN_TIMED_KEYS stay in the phase of the sort they finish
+    SortStatsTimer timer(count > SortStats::MIN_TIMED_KEYS ? &this->stats_ : nullptr, SortPhase::Merge);
+    bool can_fork = (pool_->getWorkerCount() > 0) && (count > thresholds_.sequential);
+
+    const int grain = thresholds_.compare_grain;
+    {
+        SortStatsStride stride(&this->stats_, k, pairs);
+        if (can_fork && pairs >= 2 * grain) {
+            // This level's compare-exchanges are independent; spread them over the pool so
+            // the top levels of the merge do not run on a single thread
+            pool_->parallelFor(low, low + pairs, grain, [&](int begin, int end) {
+                SortStatsTimer chunk_timer(&this->stats_, SortPhase::Merge);
+                for (int i = begin; i < end; ++i) {
+                    this->compareAndSwap(arr, i, i + k, order);
+                }
+            });
+        } else {
+            for (int i = low; i < low + pairs; ++i) {
+                this->compareAndSwap(arr, i, i + k, order);
+            }
+        }
     }
 
-    bool can_spawn_thread = (current_threads_ * 2 <= max_threads_) && (count > SEQUENTIAL_THRESHOLD);
-
-    if (can_spawn_thread) {
-        current_threads_ += 2;
-
-        std::thread t1(&StdThreadBitonicSorter::bitonicMergeParallel, this, std::ref(arr), low, k, order, depth + 1);
-        bitonicMergeParallel(arr, low + k, k, order, depth + 1);
-        t1.join();
-
-        current_threads_ -= 2;
+    if (can_fork) {
+        WorkStealingThreadPool::TaskGroup group;
+        pool_->submit(group, [&] {
+            SortStatsTimer task_timer(&this->stats_, SortPhase::Merge);
+            bitonicMergeParallel(arr, low, k, order);
+        });
+        bitonicMergeParallel(arr, low + k, pairs, order);
+        pool_->wait(group);
     } else {
-        bitonicMerge(arr, low, k, order); // Uses base class sequential version
-        bitonicMerge(arr, low + k, k, order); // Uses base class sequential version
+        this->bitonicMerge(arr, low, k, order); // Uses base class sequential version
+        this->bitonicMerge(arr, low + k, pairs, order); // Uses base class sequential version
     }
 }
+
+#define INSTANTIATE_STD_THREAD_SORTER(T) template class BasicStdThreadBitonicSorter<T>;
+BITONIC_SORT_FOR_EACH_KEY_TYPE(INSTANTIATE_STD_THREAD_SORTER)
+#undef INSTANTIATE_STD_THREAD_SORTER
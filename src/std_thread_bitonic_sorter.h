@@ -7,28 +7,56 @@
 #include <thread>
 #include <algorithm> // For std::min
 #include <stdexcept> // For std::invalid_argument
+#include <memory>    // For std::shared_ptr
+#include "work_stealing_thread_pool.h"
 
-class StdThreadBitonicSorter : public BitonicSort {
+template <typename T>
+class BasicStdThreadBitonicSorter : public BasicBitonicSort<T> {
 public:
-    // Constructor allows specifying max threads, defaults to hardware concurrency
-    StdThreadBitonicSorter(unsigned int max_threads = std::thread::hardware_concurrency());
-    ~StdThreadBitonicSorter() override = default;
-
-    void sort(std::vector<int>& arr, SortOrder order) override;
+    // Constructor allows specifying max threads, defaults to hardware concurrency. The sorter
+    // owns a persistent pool of max_threads - 1 workers; the thread calling sort() is the last.
+    BasicStdThreadBitonicSorter(unsigned int max_threads = std::thread::hardware_concurrency());
+    // Runs on a pool shared with other sorters, e.g. WorkStealingThreadPool::shared(). The
+    // thread budget is the pool's workers plus the caller, however many sorters share it.
+    // Throws std::invalid_argument for a null pool; for one thread, pass a pool of zero workers.
+    explicit BasicStdThreadBitonicSorter(std::shared_ptr<WorkStealingThreadPool> pool);
+    ~BasicStdThreadBitonicSorter() override = default;
+
+    using payload_type = typename BasicBitonicSort<T>::payload_type;
+
+    using BasicBitonicSort<T>::sort;
+    using BasicBitonicSort<T>::sortPairs;
+    void sort(T* data, std::size_t count, SortOrder order) override;
+    void sortPairs(T* keys, payload_type* values, std::size_t count, SortOrder order) override;
+    // The single bitonic merge of the default, forked across the pool
+    using BasicBitonicSort<T>::merge;
+    void merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, SortOrder order) override;
     std::string getName() const override;
 
-private:
-    unsigned int max_threads_;
-    unsigned int current_threads_ = 0; // To keep track of active threads for simple depth control
-
-    // Threshold for switching to sequential sort for small subproblems
-    static const int SEQUENTIAL_THRESHOLD = 1024; // Potentially tune this
+    // Zero fields restore SEQUENTIAL_THRESHOLD and PARALLEL_COMPARE_GRAIN. Throws
+    // std::invalid_argument for negative ones. Not safe while a sort is running.
+    void setThresholds(ParallelThresholds thresholds);
+    ParallelThresholds getThresholds() const { return thresholds_; }
 
-    void bitonicSortRecursiveParallel(std::vector<int>& arr, int low, int count, SortOrder order, unsigned int depth);
-    void bitonicMergeParallel(std::vector<int>& arr, int low, int count, SortOrder order, unsigned int depth);
+    // Defaults: subproblems up to SEQUENTIAL_THRESHOLD keys run without forking, and a
+    // merge level's compare-exchange loop is split into slices of PARALLEL_COMPARE_GRAIN
+    static const int SEQUENTIAL_THRESHOLD = 1024;
+    static const int PARALLEL_COMPARE_GRAIN = 4096;
 
-    void padData(std::vector<int>& arr, int& original_size, int& padded_size, SortOrder order);
-    void unpadData(std::vector<int>& arr, int original_size, int padded_size);
+private:
+    unsigned int max_threads_;
+    // Fork-join tasks from both recursions go through the pool; its fixed worker count is
+    // what bounds the threads, so no spawn counter is needed
+    std::shared_ptr<WorkStealingThreadPool> pool_;
+    ParallelThresholds thresholds_{SEQUENTIAL_THRESHOLD, PARALLEL_COMPARE_GRAIN};
+
+    // Arr is T* for sort() and KeyValueArrays for sortPairs()
+    template <typename Arr>
+    void bitonicSortRecursiveParallel(Arr& arr, int low, int count, SortOrder order);
+    template <typename Arr>
+    void bitonicMergeParallel(Arr& arr, int low, int count, SortOrder order);
 };
 
+using StdThreadBitonicSorter = BasicStdThreadBitonicSorter<int>;
+
 #endif // STD_THREAD_BITONIC_SORTER_H
@@ -0,0 +1,131 @@
+#include "work_stealing_thread_pool.h"
+#include "sort_stats.h"
+#include <chrono>
+
+namespace {
+
+// Which pool, if any, the current thread works for, and its deque in that pool
+thread_local const WorkStealingThreadPool* current_pool = nullptr;
+thread_local std::size_t current_index = 0;
+
+} // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(unsigned int num_workers) {
+    for (unsigned int i = 0; i <= num_workers; ++i) {
+        deques_.push_back(std::make_unique<TaskDeque>());
+    }
+    workers_.reserve(num_workers);
+    for (unsigned int i = 0; i < num_workers; ++i) {
+        workers_.emplace_back(&WorkStealingThreadPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+const std::shared_ptr<WorkStealingThreadPool>& WorkStealingThreadPool::shared() {
+    static const std::shared_ptr<WorkStealingThreadPool> pool = std::make_shared<WorkStealingThreadPool>(
+        std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+    return pool;
+}
+
+std::size_t WorkStealingThreadPool::ownDeque() const {
+    return current_pool == this ? current_index : deques_.size() - 1;
+}
+
+void WorkStealingThreadPool::submit(TaskGroup& group, std::function<void()> task) {
+    group.pending_.fetch_add(1, std::memory_order_relaxed);
+    TaskDeque& deque = *deques_[ownDeque()];
+    {
+        std::lock_guard<std::mutex> lock(deque.mutex);
+        deque.tasks.push_back(Task{std::move(task), &group});
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+    {
+        // Taking the lock orders this notify after a worker's check of queued_, so the
+        // wakeup cannot be lost between its check and its wait
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    wake_.notify_one();
+}
+
+void WorkStealingThreadPool::execute(Task& task) {
+    try {
+        task.run();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(task.group->error_mutex_);
+        if (!task.group->error_) {
+            task.group->error_ = std::current_exception();
+        }
+    }
+    task.group->pending_.fetch_sub(1, std::memory_order_release);
+}
+
+bool WorkStealingThreadPool::tryRunOne(std::size_t self) {
+    if (queued_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    // Own deque from the back, then every other deque from the front
+    for (std::size_t n = 0; n < deques_.size(); ++n) {
+        std::size_t victim = (self + n) % deques_.size();
+        TaskDeque& deque = *deques_[victim];
+        std::unique_lock<std::mutex> lock(deque.mutex);
+        if (deque.tasks.empty()) {
+            continue;
+        }
+        Task task;
+        if (n == 0) {
+            task = std::move(deque.tasks.back());
+            deque.tasks.pop_back();
+        } else {
+            task = std::move(deque.tasks.front());
+            deque.tasks.pop_front();
+        }
+        lock.unlock();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        execute(task);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::wait(TaskGroup& group) {
+    // Charged to the sorter waiting, if any; tasks run meanwhile charge their own phases
+    SortStatsTimer timer(SortPhase::Wait);
+    const std::size_t self = ownDeque();
+    while (group.pending_.load(std::memory_order_acquire) > 0) {
+        if (!tryRunOne(self)) {
+            // The remaining tasks of the group are running on other threads
+            std::this_thread::yield();
+        }
+    }
+    if (group.error_) {
+        std::rethrow_exception(group.error_);
+    }
+}
+
+void WorkStealingThreadPool::workerLoop(std::size_t index) {
+    current_pool = this;
+    current_index = index;
+    while (true) {
+        if (tryRunOne(index)) {
+            continue;
+        }
+        // Notifications wake sleepers; the bounded sleep is only a backstop so that an idle
+        // worker never relies on a single notify to find queued work
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait_for(lock, std::chrono::milliseconds(50),
+                       [this] { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+        if (stopping_ && queued_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
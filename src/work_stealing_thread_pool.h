@@ -0,0 +1,122 @@
+#ifndef WORK_STEALING_THREAD_POOL_H
+#define WORK_STEALING_THREAD_POOL_H
+
+#include <algorithm> // For std::min, std::max
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept> // For std::invalid_argument
+#include <thread>
+#include <vector>
+
+// Persistent pool for fork-join parallelism. Each worker owns a deque: it pushes and pops
+// its own tasks at the back (LIFO, so the most recently forked and cache-warm subproblem
+// runs first) and steals from the front of the others (FIFO, taking the largest pending
+// subproblems). Threads outside the pool submit into a shared injection deque.
+//
+// A thread that waits for a TaskGroup keeps running pending tasks instead of blocking, so
+// nested fork-join never deadlocks and the number of threads doing work is fixed: the
+// workers plus whichever callers are waiting.
+class WorkStealingThreadPool {
+public:
+    // Tasks forked together and waited for together. Not copyable; must outlive wait().
+    class TaskGroup {
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+    private:
+        friend class WorkStealingThreadPool;
+        std::atomic<int> pending_{0};
+        std::mutex error_mutex_;
+        std::exception_ptr error_;
+    };
+
+    explicit WorkStealingThreadPool(unsigned int num_workers);
+    ~WorkStealingThreadPool(); // Runs the remaining tasks, then joins the workers
+
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+    unsigned int getWorkerCount() const { return static_cast<unsigned int>(workers_.size()); }
+
+    // Queues task as part of group; the calling thread's deque if it is a worker
+    void submit(TaskGroup& group, std::function<void()> task);
+
+    // Runs queued tasks until every task of group has finished, then rethrows the first
+    // exception any of them threw
+    void wait(TaskGroup& group);
+
+    // Runs fn(chunk_begin, chunk_end) over [begin, end) on the workers and the calling
+    // thread, then returns. Chunks are multiples of grain elements (except the last) and a
+    // few per thread, so that stealing evens out threads that fall behind. Rethrows the
+    // first exception a chunk threw, once every chunk has finished. Throws
+    // std::invalid_argument for a grain below 1.
+    template <typename F>
+    void parallelFor(int begin, int end, int grain, F&& fn) {
+        if (grain < 1) {
+            throw std::invalid_argument("WorkStealingThreadPool::parallelFor: grain must be at least 1");
+        }
+        const int n = end - begin;
+        const int threads = static_cast<int>(getWorkerCount()) + 1;
+        int chunk = (n + threads * CHUNKS_PER_THREAD - 1) / (threads * CHUNKS_PER_THREAD);
+        chunk = std::max(grain, (chunk + grain - 1) / grain * grain);
+        if (threads == 1 || n <= chunk) {
+            fn(begin, end);
+            return;
+        }
+        TaskGroup group;
+        for (int c = begin + chunk; c < end; c += chunk) {
+            const int c_end = std::min(c + chunk, end);
+            submit(group, [&fn, c, c_end] { fn(c, c_end); });
+        }
+        try {
+            fn(begin, begin + chunk);
+        } catch (...) {
+            // The queued chunks still refer to fn and group, so they must finish first
+            try {
+                wait(group);
+            } catch (...) {
+            }
+            throw;
+        }
+        wait(group);
+    }
+
+    static const int CHUNKS_PER_THREAD = 4;
+
+    // Process-wide pool with hardware_concurrency() - 1 workers (the caller is the last thread)
+    static const std::shared_ptr<WorkStealingThreadPool>& shared();
+
+private:
+    struct Task {
+        std::function<void()> run;
+        TaskGroup* group;
+    };
+
+    struct TaskDeque {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // deques_[i] belongs to worker i; the last one is the injection deque
+    std::vector<std::unique_ptr<TaskDeque>> deques_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<int> queued_{0}; // Tasks sitting in any deque
+    std::atomic<bool> stopping_{false};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+
+    std::size_t ownDeque() const;
+    bool tryRunOne(std::size_t self);
+    void execute(Task& task);
+    void workerLoop(std::size_t index);
+};
+
+#endif // WORK_STEALING_THREAD_POOL_H
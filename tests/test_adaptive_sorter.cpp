@@ -0,0 +1,151 @@
+#include "gtest/gtest.h"
+#include "adaptive_sorter.h"
+#include "plain_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include "simd_kernels.h"
+#include <vector>
+#include <algorithm> // For std::sort, std::is_sorted, std::reverse
+#include <cstdint>
+#include <cstring>   // For std::memcmp
+#include <memory>    // For std::make_shared
+#include <numeric>   // For std::iota
+#include <random>    // For std::mt19937
+
+template <typename T>
+static void expectSortedLike(const std::vector<T>& data, std::vector<T> input, SortOrder order, const char* what) {
+    if (order == SortOrder::Ascending) {
+        std::sort(input.begin(), input.end(), [](T a, T b) { return SortKeyTraits<T>::less(a, b); });
+    } else {
+        std::sort(input.begin(), input.end(), [](T a, T b) { return SortKeyTraits<T>::less(b, a); });
+    }
+    ASSERT_EQ(data.size(), input.size());
+    EXPECT_EQ(0, std::memcmp(data.data(), input.data(), data.size() * sizeof(T))) << what;
+}
+
+static std::vector<int> nearlySorted(std::mt19937& gen, std::size_t size, std::size_t swaps) {
+    std::vector<int> data(size);
+    std::iota(data.begin(), data.end(), 0);
+    for (std::size_t i = 0; i < swaps; ++i) {
+        std::swap(data[gen() % size], data[gen() % size]);
+    }
+    return data;
+}
+
+TEST(SortedPrefixKernelTest, EveryIsa) {
+    std::vector<int> data(1000);
+    std::iota(data.begin(), data.end(), 0);
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        const SIMDKernels<int>& kernels = selectSIMDKernels<int>(isa);
+        EXPECT_EQ(0, kernels.sortedPrefix(data.data(), 0, SortOrder::Ascending));
+        EXPECT_EQ(1, kernels.sortedPrefix(data.data(), 1, SortOrder::Descending));
+        EXPECT_EQ(1000, kernels.sortedPrefix(data.data(), 1000, SortOrder::Ascending));
+        EXPECT_EQ(1, kernels.sortedPrefix(data.data(), 1000, SortOrder::Descending));
+        for (int breakAt : {1, 7, 16, 17, 63, 500, 999}) {
+            std::vector<int> broken = data;
+            broken[breakAt] = -1;
+            EXPECT_EQ(breakAt, kernels.sortedPrefix(broken.data(), 1000, SortOrder::Ascending)) << breakAt;
+        }
+        std::vector<int> equal(100, 5);
+        EXPECT_EQ(100, kernels.sortedPrefix(equal.data(), 100, SortOrder::Ascending));
+        EXPECT_EQ(100, kernels.sortedPrefix(equal.data(), 100, SortOrder::Descending));
+    }
+}
+
+TEST(AdaptiveSorterTest, SortedAndReversedInput) {
+    AdaptiveSorter sorter;
+    for (SortOrder order : {SortOrder::Ascending, SortOrder::Descending}) {
+        std::vector<int> data(100003);
+        std::iota(data.begin(), data.end(), -50000);
+        const std::vector<int> input = data;
+        sorter.sort(data, order);
+        expectSortedLike(data, input, order, "sorted");
+        sorter.sort(data, order);
+        expectSortedLike(data, input, order, "already sorted");
+        std::reverse(data.begin(), data.end());
+        sorter.sort(data, order);
+        expectSortedLike(data, input, order, "reversed");
+    }
+}
+
+TEST(AdaptiveSorterTest, DisorderLevels) {
+    std::mt19937 gen(17);
+    AdaptiveSorter sorter;
+    for (std::size_t size : {2u, 3u, 100u, 4097u, 200003u}) {
+        for (std::size_t swaps : {std::size_t(1), size / 1000, size / 100, size / 10, size}) {
+            std::vector<int> data = nearlySorted(gen, size, swaps);
+            const std::vector<int> input = data;
+            sorter.sort(data, SortOrder::Ascending);
+            expectSortedLike(data, input, SortOrder::Ascending, "ascending");
+            data = input;
+            sorter.sort(data, SortOrder::Descending);
+            expectSortedLike(data, input, SortOrder::Descending, "descending");
+        }
+    }
+}
+
+TEST(AdaptiveSorterTest, RunPatterns) {
+    std::mt19937 gen(23);
+    AdaptiveSorter sorter(std::make_shared<PlainBitonicSorter>());
+    // Sorted data with a random batch appended
+    std::vector<int> appended(60000);
+    std::iota(appended.begin(), appended.end(), 0);
+    for (std::size_t i = 50000; i < appended.size(); ++i) appended[i] = static_cast<int>(gen() % 60000);
+    // Alternating ascending and descending runs
+    std::vector<int> sawtooth(50000);
+    for (std::size_t i = 0; i < sawtooth.size(); ++i) {
+        const int run = static_cast<int>(i / 1000);
+        const int offset = static_cast<int>(i % 1000);
+        sawtooth[i] = run * 1000 + (run % 2 ? 999 - offset : offset);
+    }
+    // A long run of equal keys that all break the prefix
+    std::vector<int> equal_run(30000, 3);
+    for (std::size_t i = 0; i < 100; ++i) equal_run[i] = static_cast<int>(i);
+    // Random keys
+    std::vector<int> random(70001);
+    for (int& x : random) x = static_cast<int>(gen() % 1000);
+    for (const std::vector<int>* input : {&appended, &sawtooth, &equal_run, &random}) {
+        for (SortOrder order : {SortOrder::Ascending, SortOrder::Descending}) {
+            std::vector<int> data = *input;
+            sorter.sort(data, order);
+            expectSortedLike(data, *input, order, sorter.getName().c_str());
+        }
+    }
+}
+
+template <typename T>
+class AdaptiveKeyTypeTest : public ::testing::Test {};
+
+using AdaptiveKeyTypes = ::testing::Types<std::int16_t, std::uint32_t, std::int64_t, float, double>;
+TYPED_TEST_SUITE(AdaptiveKeyTypeTest, AdaptiveKeyTypes);
+
+TYPED_TEST(AdaptiveKeyTypeTest, NearlySortedKeys) {
+    std::mt19937 gen(29);
+    BasicAdaptiveSorter<TypeParam> sorter;
+    std::vector<TypeParam> data(20000);
+    for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<TypeParam>(i % 30000);
+    for (int i = 0; i < 50; ++i) std::swap(data[gen() % data.size()], data[gen() % data.size()]);
+    const std::vector<TypeParam> input = data;
+    sorter.sort(data, SortOrder::Ascending);
+    expectSortedLike(data, input, SortOrder::Ascending, "ascending");
+    sorter.sort(data, SortOrder::Descending);
+    expectSortedLike(data, input, SortOrder::Descending, "descending");
+}
+
+TEST(AdaptiveSorterTest, PairsFollowTheirKeys) {
+    std::mt19937 gen(31);
+    AdaptiveSorter sorter;
+    for (std::size_t swaps : {0u, 10u}) {
+        std::vector<int> keys = nearlySorted(gen, 10000, swaps);
+        std::reverse(keys.begin(), keys.end());
+        std::vector<AdaptiveSorter::payload_type> values(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i) values[i] = keys[i] * 3u;
+        sorter.sortPairs(keys, values, SortOrder::Ascending);
+        EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            ASSERT_EQ(values[i], keys[i] * 3u) << i;
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#include "gtest/gtest.h"
+#include "plain_bitonic_sorter.h"
+#include "std_thread_bitonic_sorter.h"
+#include "openmp_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include "blocked_bitonic_sorter.h"
+#include <vector>
+#include <algorithm> // For std::sort
+#include <functional> // For std::greater
+#include <memory>    // For std::make_shared
+#include <numeric>   // For std::iota
+#include <random>    // For std::mt19937
+
+// Sizes just around powers of two, where padding used to nearly double the work, plus
+// sizes whose remainder is large enough for the threaded compare loops
+static const int kSizes[] = {3, 63, 65, 127, 129, 1000, 1023, 1025, 4097, 65535, 65537, 3 * (1 << 15) + 5,
+                             3 * (1 << 16) + 7};
+
+// The sort must happen in the caller's buffer: same allocation, same capacity
+static void expectSortedInPlace(BitonicSort& sorter, int size, SortOrder order, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::vector<int> data;
+    data.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        data.push_back(static_cast<int>(gen() % 100000) - 50000);
+    }
+    std::vector<int> expected = data;
+    if (order == SortOrder::Ascending) {
+        std::sort(expected.begin(), expected.end());
+    } else {
+        std::sort(expected.begin(), expected.end(), std::greater<int>());
+    }
+    const int* buffer = data.data();
+    const std::size_t capacity = data.capacity();
+
+    sorter.sort(data, order);
+    EXPECT_EQ(data, expected) << sorter.getName() << " size " << size;
+    EXPECT_EQ(data.data(), buffer) << sorter.getName() << " reallocated at size " << size;
+    EXPECT_EQ(data.capacity(), capacity) << sorter.getName();
+
+    std::vector<int> keys(size);
+    for (int& key : keys) {
+        key = static_cast<int>(gen() % 1000); // Many ties
+    }
+    std::vector<std::uint32_t> values(size);
+    std::iota(values.begin(), values.end(), 0u);
+    const std::vector<int> original = keys;
+    const std::uint32_t* value_buffer = values.data();
+    sorter.sortPairs(keys, values, order);
+    EXPECT_EQ(values.data(), value_buffer) << sorter.getName();
+    ASSERT_EQ(values.capacity(), static_cast<std::size_t>(size)) << sorter.getName();
+    for (int i = 0; i < size; ++i) {
+        ASSERT_EQ(keys[i], original[values[i]]) << sorter.getName() << " size " << size << " at " << i;
+        if (i > 0) {
+            ASSERT_TRUE(order == SortOrder::Ascending ? keys[i - 1] <= keys[i] : keys[i - 1] >= keys[i])
+                << sorter.getName() << " size " << size << " at " << i;
+        }
+    }
+}
+
+static void runAllSizes(BitonicSort& sorter) {
+    unsigned seed = 1;
+    for (int size : kSizes) {
+        expectSortedInPlace(sorter, size, SortOrder::Ascending, seed++);
+        expectSortedInPlace(sorter, size, SortOrder::Descending, seed++);
+    }
+}
+
+TEST(ArbitraryLengthTest, Plain) {
+    PlainBitonicSorter sorter;
+    runAllSizes(sorter);
+}
+
+TEST(ArbitraryLengthTest, StdThread) {
+    StdThreadBitonicSorter sorter(4);
+    runAllSizes(sorter);
+}
+
+TEST(ArbitraryLengthTest, OpenMP) {
+    OpenMPBitonicSorter sorter(4);
+    runAllSizes(sorter);
+}
+
+TEST(ArbitraryLengthTest, OpenMPSIMDEveryAvailableIsa) {
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        OpenMPSIMDBitonicSorter sorter(isa, 4);
+        sorter.setThresholds({1000, 100});
+        runAllSizes(sorter);
+    }
+}
+
+TEST(ArbitraryLengthTest, SIMDEveryAvailableIsa) {
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        SIMDBitonicSorter sorter(isa);
+        runAllSizes(sorter);
+    }
+    SIMDBitonicSorter threaded(SIMDIsa::Auto, std::make_shared<WorkStealingThreadPool>(3));
+    runAllSizes(threaded);
+}
+
+TEST(ArbitraryLengthTest, Blocked) {
+    BlockedBitonicSorter small_tiles(1024); // Remainders cross many tiles
+    runAllSizes(small_tiles);
+    BlockedBitonicSorter sorter;
+    runAllSizes(sorter);
+}
@@ -0,0 +1,151 @@
+#include "gtest/gtest.h"
+#include "async_sorter.h"
+#include <vector>
+#include <algorithm> // For std::sort, std::is_permutation
+#include <chrono>
+#include <functional> // For std::greater
+#include <future>
+#include <random>    // For std::mt19937
+
+static std::vector<int> randomKeys(std::size_t size, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::vector<int> keys(size);
+    for (int& key : keys) {
+        key = static_cast<int>(gen());
+    }
+    return keys;
+}
+
+TEST(AsyncSorterTest, SortsLikeStdSort) {
+    AsyncSorter sorter;
+    for (std::size_t size : {0u, 1u, 100u, 1u << 16, (1u << 16) + 1, 300000u, 1u << 20}) {
+        for (SortOrder order : {SortOrder::Ascending, SortOrder::Descending}) {
+            std::vector<int> keys = randomKeys(size, static_cast<unsigned>(size));
+            std::vector<int> expected = keys;
+            if (order == SortOrder::Ascending) {
+                std::sort(expected.begin(), expected.end());
+            } else {
+                std::sort(expected.begin(), expected.end(), std::greater<int>());
+            }
+            AsyncSortJob job = sorter.sortAsync(keys, order);
+            job.get();
+            EXPECT_TRUE(job.ready());
+            EXPECT_EQ(job.progress(), 1.0) << "size " << size;
+            ASSERT_EQ(keys, expected) << sorter.getName() << " size " << size;
+        }
+    }
+}
+
+TEST(AsyncSorterTest, SmallStagesAndNoPool) {
+    // Many stages per level, run on the executor thread alone
+    BasicAsyncSorter<double> sorter(SIMDIsa::Auto, nullptr, 1000);
+    std::mt19937 gen(3);
+    std::vector<double> keys(123457);
+    for (double& key : keys) {
+        key = static_cast<double>(gen() % 10000) / 7;
+    }
+    std::vector<double> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    AsyncSortJob job = sorter.sortAsync(keys, SortOrder::Ascending);
+    job.get();
+    EXPECT_EQ(job.progress(), 1.0);
+    EXPECT_EQ(keys, expected);
+}
+
+TEST(AsyncSorterTest, QueuedJobsAllComplete) {
+    AsyncSorter sorter(SIMDIsa::Auto, WorkStealingThreadPool::shared(), 1 << 12);
+    std::vector<std::vector<int>> arrays;
+    for (unsigned seed = 0; seed < 6; ++seed) {
+        arrays.push_back(randomKeys(50000 + 1000 * seed, seed));
+    }
+    std::vector<AsyncSortJob> jobs;
+    for (std::vector<int>& keys : arrays) {
+        jobs.push_back(sorter.sortAsync(keys, SortOrder::Ascending));
+    }
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        jobs[i].get();
+        EXPECT_TRUE(std::is_sorted(arrays[i].begin(), arrays[i].end())) << "job " << i;
+    }
+}
+
+TEST(AsyncSorterTest, CancelledJobThrowsAndKeepsKeys) {
+    AsyncSorter sorter;
+    // Job 1's callback holds the executor until job 2 has been cancelled
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    AsyncSortOptions hold;
+    hold.on_complete = [released](std::exception_ptr) { released.wait(); };
+    std::vector<int> first = randomKeys(1000, 1);
+    AsyncSortJob job1 = sorter.sortAsync(first, SortOrder::Ascending, hold);
+
+    std::vector<int> keys = randomKeys(300000, 2);
+    const std::vector<int> original = keys;
+    std::exception_ptr reported;
+    std::promise<void> reported_set;
+    AsyncSortOptions report;
+    report.on_complete = [&](std::exception_ptr error) {
+        reported = error;
+        reported_set.set_value();
+    };
+    AsyncSortJob job2 = sorter.sortAsync(keys, SortOrder::Ascending, report);
+    job2.cancel();
+    release.set_value();
+
+    job1.get();
+    EXPECT_TRUE(std::is_sorted(first.begin(), first.end()));
+    EXPECT_THROW(job2.get(), SortCancelled);
+    EXPECT_EQ(job2.progress(), 0.0);
+    reported_set.get_future().wait();
+    EXPECT_THROW(std::rethrow_exception(reported), SortCancelled);
+    EXPECT_TRUE(std::is_permutation(keys.begin(), keys.end(), original.begin()));
+}
+
+TEST(AsyncSorterTest, PassedDeadlineThrows) {
+    AsyncSorter sorter;
+    std::vector<int> keys = randomKeys(100000, 4);
+    const std::vector<int> original = keys;
+    AsyncSortOptions options;
+    options.deadline = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+    AsyncSortJob job = sorter.sortAsync(keys, SortOrder::Ascending, options);
+    EXPECT_THROW(job.get(), SortDeadlineExceeded);
+    EXPECT_TRUE(std::is_permutation(keys.begin(), keys.end(), original.begin()));
+}
+
+TEST(AsyncSorterTest, CompletionCallbackSeesSuccess) {
+    AsyncSorter sorter;
+    std::vector<int> keys = randomKeys(70000, 5);
+    std::promise<std::exception_ptr> reported;
+    AsyncSortOptions options;
+    options.on_complete = [&](std::exception_ptr error) { reported.set_value(error); };
+    AsyncSortJob job = sorter.sortAsync(keys, SortOrder::Descending, options);
+    EXPECT_EQ(reported.get_future().get(), nullptr);
+    EXPECT_TRUE(job.ready()); // The future is ready before the callback runs
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end(), std::greater<int>()));
+}
+
+TEST(AsyncSorterTest, DestructionAnswersEveryJob) {
+    std::vector<std::vector<int>> arrays;
+    for (unsigned seed = 0; seed < 4; ++seed) {
+        arrays.push_back(randomKeys(1 << 18, seed));
+    }
+    std::vector<AsyncSortJob> jobs;
+    {
+        AsyncSorter sorter;
+        for (std::vector<int>& keys : arrays) {
+            jobs.push_back(sorter.sortAsync(keys, SortOrder::Ascending));
+        }
+    }
+    // Every job either finished before the destructor or was stopped by it
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        ASSERT_TRUE(jobs[i].ready());
+        try {
+            jobs[i].get();
+            EXPECT_TRUE(std::is_sorted(arrays[i].begin(), arrays[i].end())) << "job " << i;
+        } catch (const SortCancelled&) {
+        }
+    }
+}
+
+TEST(AsyncSorterTest, RejectsBadStageSize) {
+    EXPECT_THROW(AsyncSorter(SIMDIsa::Auto, nullptr, 0), std::invalid_argument);
+}
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+#include "blocked_bitonic_sorter.h"
+#include "bitonic_sort.h" // For SortOrder
+#include <vector>
+#include <algorithm> // For std::is_sorted, std::sort, std::generate
+#include <functional> // For std::greater
+#include <random>    // For std::mt19937, std::uniform_int_distribution
+
+// Test fixture for the cache-blocked sorter. A 1 KiB tile (256 ints) makes even small
+// inputs go through the tile-sized stages, the streaming strides and the per-tile merges.
+class BlockedBitonicSorterTest : public ::testing::Test {
+protected:
+    BlockedBitonicSorter sorter{1024};
+    std::vector<int> arr;
+    std::vector<int> sorted_arr;
+
+    void checkSort(SortOrder order) {
+        sorted_arr = arr;
+        sorter.sort(arr, order);
+        if (order == SortOrder::Ascending) {
+            std::sort(sorted_arr.begin(), sorted_arr.end());
+            EXPECT_TRUE(std::is_sorted(arr.begin(), arr.end()));
+        } else {
+            std::sort(sorted_arr.begin(), sorted_arr.end(), std::greater<int>());
+            EXPECT_TRUE(std::is_sorted(arr.begin(), arr.end(), std::greater<int>()));
+        }
+        ASSERT_EQ(arr.size(), sorted_arr.size());
+        EXPECT_EQ(arr, sorted_arr) << sorter.getName() << " size " << arr.size();
+    }
+
+    void generateRandomVector(size_t size, int min_val = -1000, int max_val = 1000) {
+        arr.resize(size);
+        std::mt19937 gen(42); // Fixed seed for reproducibility
+        std::uniform_int_distribution<> distrib(min_val, max_val);
+        std::generate(arr.begin(), arr.end(), [&]() { return distrib(gen); });
+    }
+};
+
+TEST_F(BlockedBitonicSorterTest, EmptyAndSingleElement) {
+    arr = {};
+    checkSort(SortOrder::Ascending);
+    arr = {7};
+    checkSort(SortOrder::Descending);
+}
+
+TEST_F(BlockedBitonicSorterTest, SmallerThanOneTile) {
+    for (size_t size : {2u, 3u, 17u, 64u, 100u, 256u}) {
+        generateRandomVector(size);
+        checkSort(SortOrder::Ascending);
+        generateRandomVector(size);
+        checkSort(SortOrder::Descending);
+    }
+}
+
+TEST_F(BlockedBitonicSorterTest, ManyTiles) {
+    for (size_t size : {257u, 1000u, 1024u, 4096u, 65536u, 100003u}) {
+        generateRandomVector(size);
+        checkSort(SortOrder::Ascending);
+        generateRandomVector(size, -5, 5); // Heavy duplicates
+        checkSort(SortOrder::Descending);
+    }
+}
+
+TEST_F(BlockedBitonicSorterTest, AlreadySortedAndReversed) {
+    arr.resize(5000);
+    for (size_t i = 0; i < arr.size(); ++i) arr[i] = static_cast<int>(i);
+    checkSort(SortOrder::Ascending);
+    checkSort(SortOrder::Descending);
+    checkSort(SortOrder::Ascending);
+}
+
+TEST(BlockedBitonicSorterTileTest, TileSizeIsAPowerOfTwoOfAtLeastOneBlock) {
+    BlockedBitonicSorter tiny(1);
+    EXPECT_GE(tiny.getTileSize(), SIMD_SEQUENTIAL_THRESHOLD);
+    BlockedBitonicSorter sorter(3000); // 750 ints, rounded down
+    EXPECT_EQ(sorter.getTileSize() & (sorter.getTileSize() - 1), 0);
+    EXPECT_LE(sorter.getTileSize(), 750);
+    EXPECT_NE(sorter.getName().find("tile=2KiB"), std::string::npos);
+}
+
+TEST(BlockedBitonicSorterTileTest, EveryAvailableIsaAndTileSorts) {
+    std::mt19937 gen(7);
+    std::vector<int> input(20000);
+    for (int& x : input) x = static_cast<int>(gen());
+    std::vector<int> expected = input;
+    std::sort(expected.begin(), expected.end());
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        for (std::size_t tile_bytes : {std::size_t(256), std::size_t(4096), BlockedBitonicSorter::DEFAULT_TILE_BYTES}) {
+            BlockedBitonicSorter sorter(tile_bytes, isa);
+            EXPECT_EQ(sorter.getIsa(), isa);
+            std::vector<int> data = input;
+            sorter.sort(data, SortOrder::Ascending);
+            EXPECT_EQ(data, expected) << sorter.getName();
+        }
+    }
+}
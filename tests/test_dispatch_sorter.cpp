@@ -0,0 +1,153 @@
+#include "gtest/gtest.h"
+#include "dispatch_sorter.h"
+#include "sort_profile.h"
+#include "std_thread_bitonic_sorter.h"
+#include "openmp_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include <vector>
+#include <algorithm> // For std::is_sorted, std::sort
+#include <cstdio>    // For std::remove
+#include <filesystem>
+#include <fstream>
+#include <functional> // For std::greater
+#include <limits>
+#include <memory>    // For std::make_shared
+#include <random>    // For std::mt19937
+#include <stdexcept>
+
+static std::vector<int> randomKeys(std::size_t size, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::vector<int> data(size);
+    for (int& x : data) x = static_cast<int>(gen() % 100000) - 50000;
+    return data;
+}
+
+static std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static SortProfile threeEntryProfile() {
+    SortProfile profile;
+    profile.isa = SIMDIsa::Scalar;
+    profile.threads = 4;
+    SortProfileEntry plain;
+    plain.max_count = 100;
+    plain.backend = SortBackend::Plain;
+    SortProfileEntry std_thread;
+    std_thread.max_count = 5000;
+    std_thread.backend = SortBackend::StdThread;
+    std_thread.thresholds = {64, 128};
+    SortProfileEntry hybrid;
+    hybrid.max_count = std::numeric_limits<std::size_t>::max();
+    hybrid.backend = SortBackend::Hybrid;
+    hybrid.block_bytes = 4096;
+    profile.entries = {plain, std_thread, hybrid};
+    return profile;
+}
+
+TEST(SortProfileTest, SaveAndLoadRoundTrip) {
+    const std::string path = tempPath("bitonic_test_profile.txt");
+    threeEntryProfile().save(path);
+    SortProfile loaded = SortProfile::load(path);
+    std::remove(path.c_str());
+    EXPECT_EQ(loaded.isa, SIMDIsa::Scalar);
+    EXPECT_EQ(loaded.threads, 4u);
+    ASSERT_EQ(loaded.entries.size(), 3u);
+    EXPECT_EQ(loaded.entries[1].backend, SortBackend::StdThread);
+    EXPECT_EQ(loaded.entries[1].max_count, 5000u);
+    EXPECT_EQ(loaded.entries[1].thresholds.sequential, 64);
+    EXPECT_EQ(loaded.entries[1].thresholds.compare_grain, 128);
+    EXPECT_EQ(loaded.entries[2].max_count, std::numeric_limits<std::size_t>::max());
+    EXPECT_EQ(loaded.entries[2].block_bytes, 4096u);
+    EXPECT_EQ(&loaded.find(0), &loaded.entries[0]);
+    EXPECT_EQ(&loaded.find(101), &loaded.entries[1]);
+    EXPECT_EQ(&loaded.find(5001), &loaded.entries[2]);
+}
+
+TEST(SortProfileTest, RejectsMalformedFiles) {
+    const std::string path = tempPath("bitonic_test_bad_profile.txt");
+    for (const char* text : {"", "entry 10 Quick sequential=0 grain=0 block_bytes=0\n",
+                             "entry 10 SIMD sequential=-1 grain=0 block_bytes=0\n",
+                             "entry 10 SIMD sequential=0 grain=0\n", "isa MMX\nentry max SIMD sequential=0 grain=0 block_bytes=0\n",
+                             "entry 10 SIMD sequential=0 grain=0 block_bytes=0\nentry 10 Plain sequential=0 grain=0 block_bytes=0\n"}) {
+        std::ofstream(path) << text;
+        EXPECT_THROW(SortProfile::load(path), std::runtime_error) << text;
+    }
+    std::remove(path.c_str());
+    EXPECT_THROW(SortProfile::load(path), std::runtime_error);
+    EXPECT_THROW(SortProfile().find(1), std::logic_error);
+}
+
+TEST(DispatchSorterTest, RoutesBySize) {
+    DispatchSorter sorter(threeEntryProfile());
+    EXPECT_NE(sorter.sorterFor(100).getName().find("PlainBitonicSorter"), std::string::npos);
+    EXPECT_NE(sorter.sorterFor(101).getName().find("StdThreadBitonicSorter"), std::string::npos);
+    EXPECT_NE(sorter.sorterFor(1 << 20).getName().find("HybridBitonicSorter"), std::string::npos);
+    for (std::size_t size : {0u, 1u, 77u, 100u, 101u, 4999u, 70001u}) {
+        std::vector<int> data = randomKeys(size, static_cast<unsigned>(size));
+        std::vector<int> expected = data;
+        std::sort(expected.begin(), expected.end(), std::greater<int>());
+        sorter.sort(data, SortOrder::Descending);
+        EXPECT_EQ(data, expected) << size;
+    }
+}
+
+TEST(DispatchSorterTest, LoadsTheProfileNamedByTheEnvironment) {
+    const std::string path = tempPath("bitonic_test_env_profile.txt");
+    threeEntryProfile().save(path);
+    setenv("BITONIC_SORT_PROFILE", path.c_str(), 1);
+    BasicDispatchSorter<float> sorter;
+    unsetenv("BITONIC_SORT_PROFILE");
+    std::remove(path.c_str());
+    EXPECT_EQ(sorter.getProfile().entries.size(), 3u);
+
+    std::vector<float> data(3000);
+    std::mt19937 gen(5);
+    for (float& x : data) x = static_cast<float>(gen() % 1000) - 500.0f;
+    sorter.sort(data, SortOrder::Ascending);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end()));
+}
+
+TEST(DispatchSorterTest, DefaultsWithoutAProfile) {
+    setenv("BITONIC_SORT_PROFILE", tempPath("bitonic_test_missing_profile.txt").c_str(), 1);
+    DispatchSorter sorter;
+    unsetenv("BITONIC_SORT_PROFILE");
+    EXPECT_EQ(sorter.getProfile().entries.size(), SortProfile::defaults().entries.size());
+    std::vector<int> data = randomKeys(200000, 3);
+    sorter.sort(data, SortOrder::Ascending);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end()));
+}
+
+// Thresholds far below the defaults make every level fork, which must not change results
+TEST(RuntimeThresholdsTest, SmallThresholdsStillSort) {
+    auto pool = std::make_shared<WorkStealingThreadPool>(3);
+    StdThreadBitonicSorter std_thread(pool);
+    OpenMPBitonicSorter openmp(4);
+    SIMDBitonicSorter simd(SIMDIsa::Auto, pool);
+    std_thread.setThresholds({16, 32});
+    openmp.setThresholds({16, 32});
+    simd.setThresholds({300, 64});
+    EXPECT_EQ(std_thread.getThresholds().sequential, 16);
+    EXPECT_EQ(simd.getThresholds().compare_grain, 64);
+    for (BitonicSort* sorter : std::vector<BitonicSort*>{&std_thread, &openmp, &simd}) {
+        for (std::size_t size : {1000u, 4096u, 50001u}) {
+            std::vector<int> data = randomKeys(size, 7);
+            std::vector<int> expected = data;
+            std::sort(expected.begin(), expected.end());
+            sorter->sort(data, SortOrder::Ascending);
+            EXPECT_EQ(data, expected) << sorter->getName() << " size " << size;
+        }
+    }
+}
+
+TEST(RuntimeThresholdsTest, ZeroRestoresDefaultsAndNegativeThrows) {
+    SIMDBitonicSorter simd;
+    simd.setThresholds({5, 5});
+    simd.setThresholds({});
+    EXPECT_EQ(simd.getThresholds().sequential, int(SIMDBitonicSorter::PARALLEL_THRESHOLD_SIMD) - 1);
+    EXPECT_EQ(simd.getThresholds().compare_grain, int(SIMDBitonicSorter::PARALLEL_COMPARE_GRAIN_SIMD));
+    StdThreadBitonicSorter std_thread(2);
+    EXPECT_EQ(std_thread.getThresholds().sequential, int(StdThreadBitonicSorter::SEQUENTIAL_THRESHOLD));
+    EXPECT_THROW(std_thread.setThresholds({-1, 0}), std::invalid_argument);
+    EXPECT_THROW(OpenMPBitonicSorter().setThresholds({0, -4}), std::invalid_argument);
+}
@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+#include "external_sorter.h"
+#include "plain_bitonic_sorter.h"
+#include <vector>
+#include <algorithm> // For std::sort
+#include <cstdint>
+#include <cstdio>    // For std::FILE, std::fopen
+#include <filesystem>
+#include <functional> // For std::greater
+#include <memory>    // For std::make_shared
+#include <random>    // For std::mt19937_64
+
+// Writes keys to a file in the test's temp directory and removes everything on teardown
+class ExternalSorterTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() /
+              ("bitonic_external_test_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::create_directories(dir);
+    }
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    std::string path(const std::string& name) const { return (dir / name).string(); }
+
+    template <typename T>
+    void writeFile(const std::string& file, const std::vector<T>& keys) {
+        std::FILE* f = std::fopen(file.c_str(), "wb");
+        ASSERT_NE(f, nullptr);
+        std::fwrite(keys.data(), sizeof(T), keys.size(), f);
+        std::fclose(f);
+    }
+
+    template <typename T>
+    std::vector<T> readFile(const std::string& file) {
+        std::vector<T> keys(std::filesystem::file_size(file) / sizeof(T));
+        std::FILE* f = std::fopen(file.c_str(), "rb");
+        EXPECT_NE(f, nullptr);
+        EXPECT_EQ(std::fread(keys.data(), sizeof(T), keys.size(), f), keys.size());
+        std::fclose(f);
+        return keys;
+    }
+
+    template <typename T>
+    std::vector<T> randomKeys(std::size_t count, unsigned seed) {
+        std::mt19937_64 gen(seed);
+        std::vector<T> keys(count);
+        for (T& key : keys) key = static_cast<T>(gen() % 100000);
+        return keys;
+    }
+
+    // Besides input and output, anything left in dir is a temp file sortFile failed to remove
+    std::size_t filesLeft() const {
+        std::size_t files = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            (void)entry;
+            ++files;
+        }
+        return files;
+    }
+};
+
+// 1 MiB budget against 4 MB of keys: 8 runs, merged 4 at a time and then 2
+TEST_F(ExternalSorterTest, FileLargerThanBudgetMultiPass) {
+    std::vector<int> keys = randomKeys<int>(1000003, 1);
+    writeFile(path("in.bin"), keys);
+    ExternalSortOptions options;
+    options.memory_budget_bytes = 1 << 20;
+    options.temp_directory = dir.string();
+    options.max_merge_fan_in = 4;
+    ExternalSorter sorter(options);
+
+    ExternalSortStats stats = sorter.sortFile(path("in.bin"), path("out.bin"), SortOrder::Ascending);
+
+    std::sort(keys.begin(), keys.end());
+    EXPECT_EQ(readFile<int>(path("out.bin")), keys) << sorter.getName();
+    EXPECT_EQ(stats.bytes, keys.size() * sizeof(int));
+    EXPECT_EQ(stats.runs, 8u);
+    EXPECT_EQ(stats.merge_passes, 2);
+    EXPECT_GT(stats.bytesPerSecond(), 0.0);
+    EXPECT_EQ(filesLeft(), 2u);
+}
+
+TEST_F(ExternalSorterTest, Int64DescendingSinglePass) {
+    std::vector<std::int64_t> keys = randomKeys<std::int64_t>(100003, 2);
+    for (std::size_t i = 0; i < keys.size(); i += 7) keys[i] -= (std::int64_t(1) << 40);
+    writeFile(path("in.bin"), keys);
+    ExternalSortOptions options;
+    options.memory_budget_bytes = 1 << 20;
+    options.temp_directory = dir.string();
+    BasicExternalSorter<std::int64_t> sorter(options);
+
+    ExternalSortStats stats = sorter.sortFile(path("in.bin"), path("out.bin"), SortOrder::Descending);
+
+    std::sort(keys.begin(), keys.end(), std::greater<std::int64_t>());
+    EXPECT_EQ(readFile<std::int64_t>(path("out.bin")), keys);
+    EXPECT_EQ(stats.runs, 2u);
+    EXPECT_EQ(stats.merge_passes, 1);
+    EXPECT_EQ(filesLeft(), 2u);
+}
+
+// Runs of different lengths and uneven merges exercise the scalar tail of each 2-way merge
+TEST_F(ExternalSorterTest, EveryIsaAndRunSorterInPlace) {
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        for (std::size_t count : {0u, 1u, 5000u, 5001u, 33333u}) {
+            std::vector<int> keys = randomKeys<int>(count, static_cast<unsigned>(count));
+            writeFile(path("data.bin"), keys);
+            ExternalSortOptions options;
+            options.memory_budget_bytes = 16 * 1024;
+            options.temp_directory = dir.string();
+            options.isa = isa;
+            ExternalSorter sorter(options, std::make_shared<PlainBitonicSorter>());
+
+            sorter.sortFile(path("data.bin"), path("data.bin"), SortOrder::Ascending);
+
+            std::sort(keys.begin(), keys.end());
+            EXPECT_EQ(readFile<int>(path("data.bin")), keys) << simdIsaName(isa) << " count " << count;
+        }
+    }
+}
+
+TEST_F(ExternalSorterTest, RejectsPartialKeys) {
+    writeFile(path("in.bin"), std::vector<std::int16_t>{1, 2, 3});
+    BasicExternalSorter<int> sorter;
+    EXPECT_THROW(sorter.sortFile(path("in.bin"), path("out.bin"), SortOrder::Ascending), std::invalid_argument);
+    EXPECT_THROW(sorter.sortFile(path("missing.bin"), path("out.bin"), SortOrder::Ascending), std::exception);
+}
@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "hybrid_bitonic_sorter.h"
+#include "merge_path.h"
+#include <vector>
+#include <algorithm> // For std::sort, std::merge
+#include <cstdint>
+#include <functional> // For std::greater
+#include <memory>    // For std::make_shared
+#include <random>    // For std::mt19937
+
+// Test fixture for the hybrid sorter. 1 KiB blocks (256 ints) make even small inputs go
+// through several merge passes, and pieces that straddle two merges.
+class HybridBitonicSorterTest : public ::testing::Test {
+protected:
+    std::vector<int> arr;
+
+    void checkSort(BitonicSort& sorter, SortOrder order) {
+        std::vector<int> expected = arr;
+        if (order == SortOrder::Ascending) {
+            std::sort(expected.begin(), expected.end());
+        } else {
+            std::sort(expected.begin(), expected.end(), std::greater<int>());
+        }
+        sorter.sort(arr, order);
+        EXPECT_EQ(arr, expected) << sorter.getName() << " size " << arr.size();
+    }
+
+    void generateRandomVector(size_t size, int min_val = -1000, int max_val = 1000) {
+        arr.resize(size);
+        std::mt19937 gen(42); // Fixed seed for reproducibility
+        std::uniform_int_distribution<> distrib(min_val, max_val);
+        std::generate(arr.begin(), arr.end(), [&]() { return distrib(gen); });
+    }
+};
+
+TEST_F(HybridBitonicSorterTest, ManyBlocksSingleThreaded) {
+    HybridBitonicSorter sorter(SIMDIsa::Auto, 1024);
+    for (size_t size : {0u, 1u, 255u, 256u, 257u, 1000u, 4096u, 100003u}) {
+        generateRandomVector(size);
+        checkSort(sorter, SortOrder::Ascending);
+        generateRandomVector(size, -5, 5); // Heavy duplicates
+        checkSort(sorter, SortOrder::Descending);
+    }
+}
+
+// More keys than MERGE_PIECE_KEYS per merge, so merges are split across tasks
+TEST_F(HybridBitonicSorterTest, MergePiecesOnPool) {
+    HybridBitonicSorter sorter(SIMDIsa::Auto, std::make_shared<WorkStealingThreadPool>(3), 4096);
+    for (size_t size : {70000u, 1u << 18, 300007u}) {
+        generateRandomVector(size, -1000000, 1000000);
+        checkSort(sorter, SortOrder::Ascending);
+        checkSort(sorter, SortOrder::Descending); // Reversed input
+    }
+}
+
+TEST(HybridMergeKernelTest, EveryAvailableIsaMergesUnequalLengths) {
+    std::mt19937 gen(5);
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        const SIMDKernels<std::int16_t>& kernels = selectSIMDKernels<std::int16_t>(isa);
+        for (int na : {0, 1, 15, 32, 33, 500}) {
+            for (int nb : {0, 7, 64, 1000}) {
+                std::vector<std::int16_t> a(na), b(nb);
+                for (auto& x : a) x = static_cast<std::int16_t>(gen() % 200);
+                for (auto& x : b) x = static_cast<std::int16_t>(gen() % 200);
+                std::sort(a.begin(), a.end());
+                std::sort(b.begin(), b.end());
+                std::vector<std::int16_t> expected(na + nb), out(na + nb);
+                std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin());
+                kernels.mergeSorted(a.data(), na, b.data(), nb, out.data(), SortOrder::Ascending);
+                EXPECT_EQ(out, expected) << simdIsaName(isa) << " " << na << "+" << nb;
+            }
+        }
+    }
+}
+
+TEST(HybridMergeKernelTest, MergePathSplitsEvenly) {
+    std::vector<int> a = {1, 3, 5, 7, 9};
+    std::vector<int> b = {2, 2, 4, 10};
+    for (std::size_t d = 0; d <= a.size() + b.size(); ++d) {
+        std::size_t i = mergePathSplit(a.data(), a.size(), b.data(), b.size(), d, SortOrder::Ascending);
+        std::vector<int> head(a.begin(), a.begin() + i);
+        head.insert(head.end(), b.begin(), b.begin() + (d - i));
+        std::sort(head.begin(), head.end());
+        std::vector<int> all = {1, 2, 2, 3, 4, 5, 7, 9, 10};
+        EXPECT_EQ(head, std::vector<int>(all.begin(), all.begin() + d)) << "diagonal " << d;
+    }
+}
@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+#include "plain_bitonic_sorter.h"
+#include "std_thread_bitonic_sorter.h"
+#include "openmp_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include "blocked_bitonic_sorter.h"
+#include "hybrid_bitonic_sorter.h"
+#include <vector>
+#include <algorithm> // For std::sort, std::generate
+#include <cstring>   // For std::memcmp
+#include <limits>    // For std::numeric_limits
+#include <random>    // For std::mt19937
+#include <cmath>     // For std::isnan, std::signbit
+
+// Every sorter must be an exact permutation ordered by SortKeyTraits<T>::less, so the
+// results are compared bit for bit (this distinguishes -0.0/+0.0 and NaN payloads).
+template <typename T>
+static std::vector<T> generateKeys(size_t size, unsigned seed) {
+    std::mt19937_64 gen(seed);
+    std::vector<T> keys(size);
+    if constexpr (std::is_floating_point<T>::value) {
+        std::uniform_real_distribution<T> distrib(-1000, 1000);
+        const T specials[] = {std::numeric_limits<T>::quiet_NaN(), -std::numeric_limits<T>::quiet_NaN(),
+                              std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(),
+                              T(0.0), T(-0.0), std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest(),
+                              std::numeric_limits<T>::denorm_min()};
+        for (size_t i = 0; i < size; ++i) {
+            keys[i] = (gen() % 8 == 0) ? specials[gen() % (sizeof(specials) / sizeof(T))] : distrib(gen);
+        }
+    } else {
+        const T specials[] = {std::numeric_limits<T>::max(), std::numeric_limits<T>::min(), T(0)};
+        for (size_t i = 0; i < size; ++i) {
+            keys[i] = (gen() % 8 == 0) ? specials[gen() % 3] : static_cast<T>(gen());
+        }
+    }
+    return keys;
+}
+
+template <typename T>
+static void expectSortedLike(BasicBitonicSort<T>& sorter, std::vector<T> keys, SortOrder order) {
+    std::vector<T> expected = keys;
+    if (order == SortOrder::Ascending) {
+        std::sort(expected.begin(), expected.end(), [](T a, T b) { return SortKeyTraits<T>::less(a, b); });
+    } else {
+        std::sort(expected.begin(), expected.end(), [](T a, T b) { return SortKeyTraits<T>::less(b, a); });
+    }
+    sorter.sort(keys, order);
+    ASSERT_EQ(keys.size(), expected.size()) << sorter.getName();
+    EXPECT_EQ(0, std::memcmp(keys.data(), expected.data(), keys.size() * sizeof(T)))
+        << sorter.getName() << " size " << keys.size();
+}
+
+template <typename T>
+class KeyTypeSorterTest : public ::testing::Test {
+protected:
+    void runAllSizes(BasicBitonicSort<T>& sorter) {
+        unsigned seed = 1;
+        for (size_t size : {0u, 1u, 2u, 7u, 64u, 100u, 256u, 1031u, 4096u}) {
+            expectSortedLike(sorter, generateKeys<T>(size, seed++), SortOrder::Ascending);
+            expectSortedLike(sorter, generateKeys<T>(size, seed++), SortOrder::Descending);
+        }
+    }
+};
+
+using KeyTypes = ::testing::Types<std::int16_t, std::uint16_t, std::int32_t, std::uint32_t, std::int64_t, float, double>;
+TYPED_TEST_SUITE(KeyTypeSorterTest, KeyTypes);
+
+TYPED_TEST(KeyTypeSorterTest, Plain) {
+    BasicPlainBitonicSorter<TypeParam> sorter;
+    this->runAllSizes(sorter);
+}
+
+TYPED_TEST(KeyTypeSorterTest, StdThread) {
+    BasicStdThreadBitonicSorter<TypeParam> sorter(4);
+    this->runAllSizes(sorter);
+}
+
+TYPED_TEST(KeyTypeSorterTest, OpenMP) {
+    BasicOpenMPBitonicSorter<TypeParam> sorter;
+    this->runAllSizes(sorter);
+}
+
+TYPED_TEST(KeyTypeSorterTest, OpenMPSIMD) {
+    BasicOpenMPSIMDBitonicSorter<TypeParam> small_tasks(SIMDIsa::Auto, 4);
+    small_tasks.setThresholds({512, 128});
+    this->runAllSizes(small_tasks);
+    BasicOpenMPSIMDBitonicSorter<TypeParam> sorter;
+    this->runAllSizes(sorter);
+}
+
+TYPED_TEST(KeyTypeSorterTest, Blocked) {
+    BasicBlockedBitonicSorter<TypeParam> small_tiles(512);
+    this->runAllSizes(small_tiles);
+    BasicBlockedBitonicSorter<TypeParam> sorter;
+    this->runAllSizes(sorter);
+}
+
+TYPED_TEST(KeyTypeSorterTest, Hybrid) {
+    BasicHybridBitonicSorter<TypeParam> small_blocks(SIMDIsa::Auto, std::make_shared<WorkStealingThreadPool>(3), 512);
+    this->runAllSizes(small_blocks);
+    BasicHybridBitonicSorter<TypeParam> sorter;
+    this->runAllSizes(sorter);
+}
+
+TYPED_TEST(KeyTypeSorterTest, SIMDEveryAvailableIsa) {
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        BasicSIMDBitonicSorter<TypeParam> sorter(isa);
+        EXPECT_EQ(sorter.getIsa(), isa);
+        this->runAllSizes(sorter);
+    }
+}
+
+TEST(KeyTypeSorterNaNTest, NaNsFollowTotalOrder) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+    std::vector<float> keys = {nan, 1.0f, -nan, -inf, 0.0f, inf, -0.0f, -1.0f};
+    BasicSIMDBitonicSorter<float> sorter;
+    sorter.sort(keys, SortOrder::Ascending);
+    EXPECT_TRUE(std::isnan(keys[0]) && std::signbit(keys[0])); // -NaN first
+    EXPECT_EQ(keys[1], -inf);
+    EXPECT_EQ(keys[2], -1.0f);
+    EXPECT_TRUE(keys[3] == 0.0f && std::signbit(keys[3])); // -0.0 before +0.0
+    EXPECT_TRUE(keys[4] == 0.0f && !std::signbit(keys[4]));
+    EXPECT_EQ(keys[5], 1.0f);
+    EXPECT_EQ(keys[6], inf);
+    EXPECT_TRUE(std::isnan(keys[7]) && !std::signbit(keys[7])); // +NaN last
+}
+
+TEST(KeyTypeSorterNameTest, NonIntSortersNameTheirKeyType) {
+    EXPECT_EQ(PlainBitonicSorter().getName(), "PlainBitonicSorter");
+    EXPECT_EQ(BasicPlainBitonicSorter<double>().getName(), "PlainBitonicSorter<double>");
+    EXPECT_NE(BasicSIMDBitonicSorter<std::int64_t>().getName().find("<int64>"), std::string::npos);
+}
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include "plain_bitonic_sorter.h"
+#include "std_thread_bitonic_sorter.h"
+#include "openmp_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include "blocked_bitonic_sorter.h"
+#include "hybrid_bitonic_sorter.h"
+#include <vector>
+#include <algorithm> // For std::sort, std::merge
+#include <cstdint>
+#include <cstring>   // For std::memcmp
+#include <limits>
+#include <memory>    // For std::unique_ptr, std::make_shared
+#include <random>    // For std::mt19937
+
+template <typename T>
+static std::vector<std::unique_ptr<BasicBitonicSort<T>>> allSorters() {
+    std::vector<std::unique_ptr<BasicBitonicSort<T>>> sorters;
+    sorters.emplace_back(new BasicPlainBitonicSorter<T>());
+    sorters.emplace_back(new BasicStdThreadBitonicSorter<T>(4));
+    sorters.emplace_back(new BasicOpenMPBitonicSorter<T>());
+    sorters.emplace_back(new BasicOpenMPSIMDBitonicSorter<T>());
+    sorters.emplace_back(new BasicSIMDBitonicSorter<T>());
+    sorters.emplace_back(new BasicSIMDBitonicSorter<T>(SIMDIsa::Auto, std::make_shared<WorkStealingThreadPool>(3)));
+    sorters.emplace_back(new BasicBlockedBitonicSorter<T>(1024));
+    sorters.emplace_back(new BasicHybridBitonicSorter<T>(SIMDIsa::Auto, std::make_shared<WorkStealingThreadPool>(2)));
+    return sorters;
+}
+
+template <typename T>
+static std::vector<T> sortedRun(std::mt19937& gen, std::size_t size, int range, SortOrder order) {
+    std::vector<T> run(size);
+    for (T& x : run) x = static_cast<T>(gen() % range);
+    auto before = [order](T a, T b) {
+        return order == SortOrder::Ascending ? SortKeyTraits<T>::less(a, b) : SortKeyTraits<T>::less(b, a);
+    };
+    std::sort(run.begin(), run.end(), before);
+    return run;
+}
+
+template <typename T>
+static void expectMerged(BasicBitonicSort<T>& sorter, const std::vector<T>& a, const std::vector<T>& b,
+                         SortOrder order) {
+    std::vector<T> expected(a.size() + b.size());
+    std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin(), [order](T x, T y) {
+        return order == SortOrder::Ascending ? SortKeyTraits<T>::less(x, y) : SortKeyTraits<T>::less(y, x);
+    });
+    std::vector<T> out;
+    sorter.merge(a, b, out, order);
+    ASSERT_EQ(out.size(), expected.size());
+    EXPECT_EQ(0, std::memcmp(out.data(), expected.data(), out.size() * sizeof(T)))
+        << sorter.getName() << " sizes " << a.size() << " + " << b.size();
+}
+
+TEST(MergeTest, UnequalLengthsBothOrders) {
+    std::mt19937 gen(5);
+    const std::size_t sizes[][2] = {{0, 0}, {0, 9}, {1, 0}, {1, 1}, {3, 100}, {100, 3}, {1000, 1000},
+                                    {4096, 1}, {70001, 33333}, {5, 200003}};
+    for (auto& sorter : allSorters<int>()) {
+        for (auto& size : sizes) {
+            for (SortOrder order : {SortOrder::Ascending, SortOrder::Descending}) {
+                std::vector<int> a = sortedRun<int>(gen, size[0], 1000, order);
+                std::vector<int> b = sortedRun<int>(gen, size[1], 1000, order);
+                expectMerged<int>(*sorter, a, b, order);
+            }
+        }
+    }
+}
+
+// Every key of a before every key of b, and the other way round
+TEST(MergeTest, DisjointRanges) {
+    std::vector<int> low(50000);
+    std::vector<int> high(70000);
+    for (std::size_t i = 0; i < low.size(); ++i) low[i] = static_cast<int>(i);
+    for (std::size_t i = 0; i < high.size(); ++i) high[i] = static_cast<int>(low.size() + i);
+    for (auto& sorter : allSorters<int>()) {
+        expectMerged<int>(*sorter, low, high, SortOrder::Ascending);
+        expectMerged<int>(*sorter, high, low, SortOrder::Ascending);
+    }
+}
+
+template <typename T>
+class MergeKeyTypeTest : public ::testing::Test {};
+
+using MergeKeyTypes = ::testing::Types<std::int16_t, std::uint32_t, std::int64_t, float, double>;
+TYPED_TEST_SUITE(MergeKeyTypeTest, MergeKeyTypes);
+
+TYPED_TEST(MergeKeyTypeTest, MatchesStdMerge) {
+    std::mt19937 gen(11);
+    for (auto& sorter : allSorters<TypeParam>()) {
+        for (SortOrder order : {SortOrder::Ascending, SortOrder::Descending}) {
+            std::vector<TypeParam> a = sortedRun<TypeParam>(gen, 40000, 30000, order);
+            std::vector<TypeParam> b = sortedRun<TypeParam>(gen, 12345, 30000, order);
+            expectMerged<TypeParam>(*sorter, a, b, order);
+        }
+    }
+}
+
+TEST(MergeTest, FloatKeysFollowTotalOrder) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+    std::vector<float> a = {-inf, -1.0f, -0.0f, 2.0f, nan};
+    std::vector<float> b = {-3.0f, 0.0f, 0.0f, inf};
+    for (auto& sorter : allSorters<float>()) {
+        expectMerged<float>(*sorter, a, b, SortOrder::Ascending);
+    }
+}
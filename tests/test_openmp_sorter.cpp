@@ -113,3 +113,75 @@ TEST_F(OpenMPBitonicSorterTest, StressTestLargeSize) {
     std::generate(vec.begin(), vec.end(), std::rand);
     run_sort_test(vec, SortOrder::Ascending);
 }
+
+TEST_F(OpenMPBitonicSorterTest, ParallelCompareLoopsLargeSize) {
+    // Large enough that the top merge levels split their compare-exchange loops into tasks
+    int previous_threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+    std::vector<int> vec((1 << 16) + 5);
+    std::generate(vec.begin(), vec.end(), std::rand);
+    run_sort_test(vec, SortOrder::Ascending);
+    std::generate(vec.begin(), vec.end(), std::rand);
+    run_sort_test(vec, SortOrder::Descending);
+    omp_set_num_threads(previous_threads);
+}
+
+TEST(OpenMPBitonicSorterConfigTest, ExplicitThreadsBindingAndCutoff) {
+    OpenMPBitonicSorter sorter(3, OpenMPProcBind::Spread, 2);
+    EXPECT_EQ(sorter.getNumThreads(), 3);
+    EXPECT_EQ(sorter.getProcBind(), OpenMPProcBind::Spread);
+    EXPECT_EQ(sorter.getTaskCutoffDepth(), 2);
+    EXPECT_EQ(sorter.getName(), "OpenMPBitonicSorter(num_threads=3, proc_bind=spread, cutoff_depth=2)");
+
+    // The sorter's clauses must not leak into the process-wide OpenMP settings
+    int max_threads = omp_get_max_threads();
+    for (OpenMPProcBind bind : {OpenMPProcBind::Default, OpenMPProcBind::Close, OpenMPProcBind::Spread}) {
+        for (int depth : {0, 1, OpenMPBitonicSorter::AUTO_TASK_CUTOFF_DEPTH}) {
+            OpenMPBitonicSorter configured(4, bind, depth);
+            std::vector<int> vec((1 << 15) + 7);
+            std::generate(vec.begin(), vec.end(), std::rand);
+            std::vector<int> expected = vec;
+            std::sort(expected.begin(), expected.end());
+            configured.sort(vec, SortOrder::Ascending);
+            EXPECT_EQ(vec, expected) << configured.getName();
+        }
+    }
+    EXPECT_EQ(omp_get_max_threads(), max_threads);
+}
+
+TEST(OpenMPBitonicSorterConfigTest, AutomaticDefaultsAndValidation) {
+    OpenMPBitonicSorter sorter;
+    EXPECT_EQ(sorter.getNumThreads(), omp_get_max_threads());
+    EXPECT_EQ(sorter.getProcBind(), OpenMPProcBind::Default);
+    EXPECT_GE(sorter.getTaskCutoffDepth(), 3);
+    EXPECT_EQ(OpenMPBitonicSorter(8).getTaskCutoffDepth(), 6); // log2(8) + 3
+
+    EXPECT_THROW(OpenMPBitonicSorter(-1), std::invalid_argument);
+    EXPECT_THROW(OpenMPBitonicSorter(2, OpenMPProcBind::Close, -2), std::invalid_argument);
+}
+
+TEST(OpenMPSIMDBitonicSorterTest, SIMDLeavesUnderTasks) {
+    OpenMPSIMDBitonicSorter sorter(SIMDIsa::Scalar, 3, OpenMPProcBind::Close, 2);
+    EXPECT_EQ(sorter.getIsa(), SIMDIsa::Scalar);
+    EXPECT_EQ(sorter.getName(), "OpenMPSIMDBitonicSorter(Scalar, num_threads=3, proc_bind=close, cutoff_depth=2)");
+    EXPECT_EQ(sorter.getThresholds().sequential, int(OpenMPSIMDBitonicSorter::SEQUENTIAL_THRESHOLD_OMP_SIMD));
+    sorter.setThresholds({0, 0});
+    EXPECT_EQ(sorter.getThresholds().compare_grain, int(OpenMPSIMDBitonicSorter::PARALLEL_COMPARE_GRAIN_OMP_SIMD));
+
+    // Small thresholds put task levels, taskloop chunks and kernel leaves all in one sort
+    OpenMPSIMDBitonicSorter simd(SIMDIsa::Auto, 4);
+    simd.setThresholds({4096, 1024});
+    for (std::size_t size : {std::size_t(1) << 16, (std::size_t(1) << 17) + 333}) {
+        for (SortOrder order : {SortOrder::Ascending, SortOrder::Descending}) {
+            std::vector<int> vec(size);
+            std::generate(vec.begin(), vec.end(), std::rand);
+            std::vector<int> expected = vec;
+            std::sort(expected.begin(), expected.end());
+            if (order == SortOrder::Descending) {
+                std::reverse(expected.begin(), expected.end());
+            }
+            simd.sort(vec, order);
+            ASSERT_EQ(vec, expected) << simd.getName() << " size " << size;
+        }
+    }
+}
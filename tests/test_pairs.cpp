@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+#include "plain_bitonic_sorter.h"
+#include "std_thread_bitonic_sorter.h"
+#include "openmp_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include "blocked_bitonic_sorter.h"
+#include "hybrid_bitonic_sorter.h"
+#include <vector>
+#include <algorithm> // For std::sort
+#include <cstring>   // For std::memcmp
+#include <limits>    // For std::numeric_limits
+#include <numeric>   // For std::iota
+#include <random>    // For std::mt19937_64
+
+// Keys drawn from a small pool so that ties are common, including ties with the padding
+// sentinels (max/min and the +/-NaN patterns) that a pair sort must not lose payloads to.
+template <typename T>
+static std::vector<T> generateTiedKeys(size_t size, unsigned seed) {
+    std::mt19937_64 gen(seed);
+    std::vector<T> pool = {T(0), T(1), T(2), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max(),
+                           SortKeyTraits<T>::highest(), SortKeyTraits<T>::lowest()};
+    for (int i = 0; i < 9; ++i) {
+        pool.push_back(static_cast<T>(gen() % 1000));
+    }
+    std::vector<T> keys(size);
+    for (size_t i = 0; i < size; ++i) {
+        keys[i] = pool[gen() % pool.size()];
+    }
+    return keys;
+}
+
+// With payload = original index, a correct pair sort leaves sorted keys and a permutation
+// of the indices in which every index still points at a bitwise identical key.
+template <typename T>
+static void expectPairsSorted(BasicBitonicSort<T>& sorter, const std::vector<T>& original, SortOrder order) {
+    using Payload = typename BasicBitonicSort<T>::payload_type;
+    std::vector<T> keys = original;
+    std::vector<Payload> values(original.size());
+    std::iota(values.begin(), values.end(), Payload(0));
+    sorter.sortPairs(keys, values, order);
+
+    std::vector<T> expected = original;
+    if (order == SortOrder::Ascending) {
+        std::sort(expected.begin(), expected.end(), [](T a, T b) { return SortKeyTraits<T>::less(a, b); });
+    } else {
+        std::sort(expected.begin(), expected.end(), [](T a, T b) { return SortKeyTraits<T>::less(b, a); });
+    }
+    ASSERT_EQ(keys.size(), original.size()) << sorter.getName();
+    ASSERT_EQ(values.size(), original.size()) << sorter.getName();
+    EXPECT_EQ(0, std::memcmp(keys.data(), expected.data(), keys.size() * sizeof(T)))
+        << sorter.getName() << " size " << keys.size();
+
+    std::vector<bool> seen(original.size(), false);
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_LT(values[i], original.size()) << sorter.getName();
+        ASSERT_FALSE(seen[values[i]]) << sorter.getName() << " duplicated payload " << values[i];
+        seen[values[i]] = true;
+        ASSERT_EQ(0, std::memcmp(&keys[i], &original[values[i]], sizeof(T)))
+            << sorter.getName() << " payload detached from its key at " << i;
+    }
+}
+
+template <typename T>
+class KeyValueSorterTest : public ::testing::Test {
+protected:
+    void runAllSizes(BasicBitonicSort<T>& sorter) {
+        unsigned seed = 1;
+        for (size_t size : {0u, 1u, 2u, 5u, 16u, 33u, 100u, 256u, 1031u, 4096u}) {
+            expectPairsSorted(sorter, generateTiedKeys<T>(size, seed++), SortOrder::Ascending);
+            expectPairsSorted(sorter, generateTiedKeys<T>(size, seed++), SortOrder::Descending);
+        }
+        // Every key equal to a padding sentinel
+        expectPairsSorted(sorter, std::vector<T>(77, SortKeyTraits<T>::highest()), SortOrder::Ascending);
+        expectPairsSorted(sorter, std::vector<T>(77, SortKeyTraits<T>::lowest()), SortOrder::Descending);
+    }
+};
+
+using KeyTypes = ::testing::Types<std::int16_t, std::uint16_t, std::int32_t, std::uint32_t, std::int64_t, float, double>;
+TYPED_TEST_SUITE(KeyValueSorterTest, KeyTypes);
+
+TYPED_TEST(KeyValueSorterTest, Plain) {
+    BasicPlainBitonicSorter<TypeParam> sorter;
+    this->runAllSizes(sorter);
+}
+
+TYPED_TEST(KeyValueSorterTest, StdThread) {
+    BasicStdThreadBitonicSorter<TypeParam> sorter(4);
+    this->runAllSizes(sorter);
+}
+
+TYPED_TEST(KeyValueSorterTest, OpenMP) {
+    BasicOpenMPBitonicSorter<TypeParam> sorter;
+    this->runAllSizes(sorter);
+}
+
+TYPED_TEST(KeyValueSorterTest, OpenMPSIMD) {
+    BasicOpenMPSIMDBitonicSorter<TypeParam> small_tasks(SIMDIsa::Auto, 4);
+    small_tasks.setThresholds({512, 128});
+    this->runAllSizes(small_tasks);
+    BasicOpenMPSIMDBitonicSorter<TypeParam> sorter;
+    this->runAllSizes(sorter);
+}
+
+TYPED_TEST(KeyValueSorterTest, Blocked) {
+    BasicBlockedBitonicSorter<TypeParam> small_tiles(512);
+    this->runAllSizes(small_tiles);
+    BasicBlockedBitonicSorter<TypeParam> sorter;
+    this->runAllSizes(sorter);
+}
+
+TYPED_TEST(KeyValueSorterTest, Hybrid) {
+    BasicHybridBitonicSorter<TypeParam> small_blocks(SIMDIsa::Auto, std::make_shared<WorkStealingThreadPool>(3), 512);
+    this->runAllSizes(small_blocks);
+    BasicHybridBitonicSorter<TypeParam> sorter;
+    this->runAllSizes(sorter);
+}
+
+TYPED_TEST(KeyValueSorterTest, SIMDEveryAvailableIsa) {
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        BasicSIMDBitonicSorter<TypeParam> sorter(isa);
+        this->runAllSizes(sorter);
+    }
+}
+
+TEST(ArgsortTest, ReturnsSortingPermutationAndKeepsKeys) {
+    const std::vector<float> keys = {3.5f, -1.0f, 2.0f, -1.0f, 10.0f, 0.0f};
+    SIMDBitonicSorter int_sorter;
+    BasicSIMDBitonicSorter<float> sorter;
+    std::vector<std::size_t> perm = sorter.argsort(keys, SortOrder::Ascending);
+    ASSERT_EQ(perm.size(), keys.size());
+    for (size_t i = 1; i < perm.size(); ++i) {
+        EXPECT_LE(keys[perm[i - 1]], keys[perm[i]]);
+    }
+    EXPECT_EQ(perm.back(), 4u);
+    EXPECT_EQ(keys[0], 3.5f); // Input untouched
+
+    perm = sorter.argsort(keys, SortOrder::Descending);
+    EXPECT_EQ(perm.front(), 4u);
+    EXPECT_TRUE(perm.back() == 1u || perm.back() == 3u);
+
+    std::vector<int> ints = {5, 4, 3, 2, 1};
+    EXPECT_EQ(int_sorter.argsort(ints, SortOrder::Ascending), (std::vector<std::size_t>{4, 3, 2, 1, 0}));
+    EXPECT_EQ(PlainBitonicSorter().argsort(ints, SortOrder::Ascending), (std::vector<std::size_t>{4, 3, 2, 1, 0}));
+}
+
+TEST(SortPairsTest, MismatchedSizesThrow) {
+    std::vector<int> keys = {3, 1, 2};
+    std::vector<std::uint32_t> values = {0, 1};
+    EXPECT_THROW(PlainBitonicSorter().sortPairs(keys, values, SortOrder::Ascending), std::invalid_argument);
+    EXPECT_THROW(SIMDBitonicSorter().sortPairs(keys, values, SortOrder::Ascending), std::invalid_argument);
+    EXPECT_EQ(keys, (std::vector<int>{3, 1, 2}));
+}
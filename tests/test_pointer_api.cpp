@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+#include "plain_bitonic_sorter.h"
+#include "std_thread_bitonic_sorter.h"
+#include "openmp_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include "blocked_bitonic_sorter.h"
+#include <vector>
+#include <algorithm> // For std::sort, std::equal
+#include <cstdint>
+#include <functional> // For std::greater
+#include <limits>    // For std::numeric_limits
+#include <memory>    // For std::unique_ptr
+#include <random>    // For std::mt19937
+
+static std::vector<std::unique_ptr<BitonicSort>> allSorters() {
+    std::vector<std::unique_ptr<BitonicSort>> sorters;
+    sorters.emplace_back(new PlainBitonicSorter());
+    sorters.emplace_back(new StdThreadBitonicSorter(4));
+    sorters.emplace_back(new OpenMPBitonicSorter());
+    sorters.emplace_back(new SIMDBitonicSorter());
+    sorters.emplace_back(new BlockedBitonicSorter(1024));
+    return sorters;
+}
+
+// A slice in the middle of a larger buffer is sorted where it lies; the rest is untouched
+TEST(PointerApiTest, SortsSliceOfLargerBuffer) {
+    std::mt19937 gen(11);
+    for (auto& sorter : allSorters()) {
+        for (int slice : {0, 1, 17, 1000, 5003}) {
+            std::vector<int> buffer(slice + 300);
+            for (int& x : buffer) x = static_cast<int>(gen());
+            const std::vector<int> original = buffer;
+            const int offset = 123;
+
+            sorter->sort(buffer.data() + offset, slice, SortOrder::Descending);
+
+            std::vector<int> expected(original.begin() + offset, original.begin() + offset + slice);
+            std::sort(expected.begin(), expected.end(), std::greater<int>());
+            EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin() + offset))
+                << sorter->getName() << " slice " << slice;
+            EXPECT_TRUE(std::equal(original.begin(), original.begin() + offset, buffer.begin()))
+                << sorter->getName() << " wrote before the slice";
+            EXPECT_TRUE(std::equal(original.begin() + offset + slice, original.end(), buffer.begin() + offset + slice))
+                << sorter->getName() << " wrote past the slice";
+        }
+    }
+}
+
+TEST(PointerApiTest, SortPairsOnRawArrays) {
+    for (auto& sorter : allSorters()) {
+        int keys[] = {5, 3, 9, 1, 7, 3, 8};
+        std::uint32_t values[] = {50, 30, 90, 10, 70, 31, 80};
+        sorter->sortPairs(keys, values, 7, SortOrder::Ascending);
+        EXPECT_TRUE(std::is_sorted(keys, keys + 7)) << sorter->getName();
+        for (int i = 0; i < 7; ++i) {
+            EXPECT_EQ(values[i] / 10, static_cast<std::uint32_t>(keys[i])) << sorter->getName();
+        }
+    }
+}
+
+TEST(PointerApiTest, RejectsCountsBeyondIntRange) {
+    int dummy = 0;
+    const std::size_t too_many = static_cast<std::size_t>(std::numeric_limits<int>::max()) + 1;
+    for (auto& sorter : allSorters()) {
+        EXPECT_THROW(sorter->sort(&dummy, too_many, SortOrder::Ascending), std::length_error) << sorter->getName();
+    }
+}
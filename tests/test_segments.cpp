@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include "plain_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include <vector>
+#include <algorithm> // For std::sort
+#include <cstdint>
+#include <cstring>   // For std::memcmp
+#include <memory>    // For std::make_shared
+#include <random>    // For std::mt19937
+
+// Mixed lengths: empty and single-element segments, runs of equal lengths that fill the
+// lanes, odd lengths with too few segments to batch, and long segments
+template <typename T>
+static void expectSegmentsSorted(BasicBitonicSort<T>& sorter, SortOrder order, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::vector<std::size_t> lengths;
+    for (int i = 0; i < 300; ++i) lengths.push_back(2 + gen() % 40);
+    for (int i = 0; i < 3; ++i) lengths.push_back(0);
+    for (int i = 0; i < 5; ++i) lengths.push_back(1);
+    for (int i = 0; i < 200; ++i) lengths.push_back(16 + gen() % 497);
+    for (int i = 0; i < 70; ++i) lengths.push_back(512);
+    lengths.push_back(333);
+    lengths.push_back(1101);
+    lengths.push_back(BasicSIMDBitonicSorter<T>::PARALLEL_THRESHOLD_SIMD + 77);
+    lengths.push_back(5000);
+    std::shuffle(lengths.begin(), lengths.end(), gen);
+    std::vector<std::size_t> offsets = {0};
+    for (std::size_t length : lengths) offsets.push_back(offsets.back() + length);
+
+    std::vector<T> data(offsets.back());
+    for (T& x : data) x = static_cast<T>(gen() % 20000) - static_cast<T>(10000 * std::is_signed<T>::value);
+    std::vector<T> expected = data;
+    for (std::size_t s = 0; s + 1 < offsets.size(); ++s) {
+        auto first = expected.begin() + offsets[s];
+        auto last = expected.begin() + offsets[s + 1];
+        if (order == SortOrder::Ascending) std::sort(first, last);
+        else std::sort(first, last, [](T a, T b) { return b < a; });
+    }
+    sorter.sortSegments(data, offsets, order);
+    for (std::size_t s = 0; s + 1 < offsets.size(); ++s) {
+        ASSERT_EQ(0, std::memcmp(data.data() + offsets[s], expected.data() + offsets[s],
+                                 (offsets[s + 1] - offsets[s]) * sizeof(T)))
+            << sorter.getName() << " segment " << s << " of length " << offsets[s + 1] - offsets[s];
+    }
+}
+
+template <typename T>
+static void runBothOrders(BasicBitonicSort<T>& sorter) {
+    expectSegmentsSorted(sorter, SortOrder::Ascending, 1);
+    expectSegmentsSorted(sorter, SortOrder::Descending, 2);
+}
+
+TEST(SortSegmentsTest, SIMDEveryAvailableIsa) {
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        BasicSIMDBitonicSorter<int> ints(isa);
+        runBothOrders(ints);
+        BasicSIMDBitonicSorter<float> floats(isa);
+        runBothOrders(floats);
+        BasicSIMDBitonicSorter<std::int16_t> shorts(isa);
+        runBothOrders(shorts);
+        BasicSIMDBitonicSorter<std::int64_t> longs(isa);
+        runBothOrders(longs);
+    }
+}
+
+TEST(SortSegmentsTest, SIMDOnPool) {
+    BasicSIMDBitonicSorter<int> sorter(SIMDIsa::Auto, std::make_shared<WorkStealingThreadPool>(3));
+    runBothOrders(sorter);
+}
+
+TEST(SortSegmentsTest, DefaultSortsSegmentsOneByOne) {
+    PlainBitonicSorter sorter;
+    runBothOrders(sorter);
+}
+
+TEST(SortSegmentsTest, RejectsBadOffsets) {
+    std::vector<int> data = {3, 2, 1, 0};
+    SIMDBitonicSorter sorter;
+    EXPECT_THROW(sorter.sortSegments(data, {0, 3, 2}, SortOrder::Ascending), std::invalid_argument);
+    EXPECT_THROW(sorter.sortSegments(data, {0, 5}, SortOrder::Ascending), std::invalid_argument);
+    EXPECT_THROW(PlainBitonicSorter().sortSegments(data, {0, 3, 2}, SortOrder::Ascending), std::invalid_argument);
+    EXPECT_EQ(data, (std::vector<int>{3, 2, 1, 0}));
+    sorter.sortSegments(data, {}, SortOrder::Ascending); // No segments
+    sorter.sortSegments(data, {0, 2, 4}, SortOrder::Ascending);
+    EXPECT_EQ(data, (std::vector<int>{2, 3, 0, 1}));
+}
@@ -1,6 +1,8 @@
 #include "gtest/gtest.h"
 #include "simd_bitonic_sorter.h"
+#include "simd_kernels.h"
 #include "bitonic_sort.h" // For SortOrder
+#include <cstdint>   // For std::int16_t
 #include <vector>
 #include <algorithm> // For std::is_sorted, std::sort, std::generate, std::reverse
 #include <random>    // For std::mt19937, std::uniform_int_distribution
@@ -206,3 +208,141 @@ TEST_F(SIMDBitonicSorterTest, MinMaxValues) {
     SetUp({std::numeric_limits<int>::max(), 0, std::numeric_limits<int>::min(), 42, -100});
     checkSort(SortOrder::Descending);
 }
+
+TEST(SIMDBitonicSorterIsaTest, NameReportsSelectedIsa) {
+    SIMDBitonicSorter sorter;
+    EXPECT_NE(sorter.getIsa(), SIMDIsa::Auto);
+    EXPECT_EQ(sorter.getIsa(), detectBestSIMDIsa());
+    EXPECT_NE(sorter.getName().find(simdIsaName(sorter.getIsa())), std::string::npos);
+}
+
+TEST(SIMDBitonicSorterIsaTest, UnsupportedIsaFallsBackToSupported) {
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        SIMDBitonicSorter sorter(isa);
+        EXPECT_TRUE(cpuSupports(sorter.getIsa()));
+        if (cpuSupports(isa)) {
+            EXPECT_EQ(sorter.getIsa(), isa);
+        }
+    }
+}
+
+TEST(SIMDBitonicSorterIsaTest, EveryAvailableIsaSorts) {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<> distrib(-100000, 100000);
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        SIMDBitonicSorter sorter(isa);
+        for (size_t size : {1u, 2u, 3u, 15u, 64u, 100u, 128u, 129u, 1024u, 4099u}) {
+            std::vector<int> arr(size);
+            std::generate(arr.begin(), arr.end(), [&]() { return distrib(gen); });
+            std::vector<int> expected = arr;
+
+            std::sort(expected.begin(), expected.end());
+            sorter.sort(arr, SortOrder::Ascending);
+            EXPECT_EQ(arr, expected) << sorter.getName() << " size " << size;
+
+            std::sort(expected.begin(), expected.end(), std::greater<int>());
+            sorter.sort(arr, SortOrder::Descending);
+            EXPECT_EQ(arr, expected) << sorter.getName() << " size " << size;
+        }
+    }
+}
+
+TEST_F(SIMDBitonicSorterTest, EverySizeUpToSeveralBlocks) {
+    // Covers partial register blocks, exact blocks and the block/merge boundary for every ISA width
+    for (size_t size = 1; size <= 4 * 128 + 1; ++size) {
+        generateRandomVector(size);
+        checkSort(size % 2 ? SortOrder::Ascending : SortOrder::Descending);
+    }
+}
+
+TEST(SIMDBitonicSorterPoolTest, LargeLevelsRunOnThePool) {
+    BasicSIMDBitonicSorter<int> sorter(SIMDIsa::Auto, std::make_shared<WorkStealingThreadPool>(3));
+    EXPECT_NE(sorter.getName().find("4 threads"), std::string::npos) << sorter.getName();
+    std::mt19937 gen(3);
+    for (int size : {1 << 16, (1 << 17) + 3}) {
+        for (SortOrder order : {SortOrder::Ascending, SortOrder::Descending}) {
+            std::vector<int> data(size);
+            for (int& x : data) x = static_cast<int>(gen());
+            std::vector<int> expected = data;
+            if (order == SortOrder::Ascending) {
+                std::sort(expected.begin(), expected.end());
+            } else {
+                std::sort(expected.begin(), expected.end(), std::greater<int>());
+            }
+            std::vector<std::size_t> perm = sorter.argsort(data, order); // Key/value path
+            ASSERT_EQ(perm.size(), data.size());
+            for (size_t i = 0; i < perm.size(); ++i) {
+                ASSERT_EQ(data[perm[i]], expected[i]) << "size " << size << " at " << i;
+            }
+            sorter.sort(data, order);
+            EXPECT_EQ(data, expected) << "size " << size;
+        }
+    }
+}
+
+template <typename T>
+static void checkMisalignedSorts(SIMDIsa isa) {
+    BasicSIMDBitonicSorter<T> sorter(isa);
+    std::mt19937 gen(11);
+    for (std::size_t size : {100u, 1000u, 4099u}) {
+        // Every element offset within a 64-byte line, so each ISA sees every head length
+        for (std::size_t offset = 0; offset < 64 / sizeof(T); ++offset) {
+            std::vector<T> backing(size + 64 / sizeof(T));
+            for (T& x : backing) x = static_cast<T>(static_cast<std::int16_t>(gen()));
+            std::vector<T> expected(backing.begin() + offset, backing.begin() + offset + size);
+            std::sort(expected.begin(), expected.end());
+            sorter.sort(backing.data() + offset, size, SortOrder::Ascending);
+            ASSERT_TRUE(std::equal(expected.begin(), expected.end(), backing.begin() + offset))
+                << sorter.getName() << " size " << size << " offset " << offset;
+        }
+    }
+}
+
+TEST(SIMDBitonicSorterIsaTest, MisalignedBuffersSort) {
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        checkMisalignedSorts<int>(isa);
+        checkMisalignedSorts<std::int16_t>(isa);
+        checkMisalignedSorts<double>(isa);
+    }
+}
+
+TEST(SIMDBitonicSorterIsaTest, StreamingCompareAndSwapMatchesCached) {
+    std::mt19937 gen(12);
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        const SIMDKernels<int>& kernels = selectSIMDKernels<int>(isa);
+        // Equally misaligned halves (power-of-two distance) get the aligned main loop, the
+        // odd distance keeps the unaligned one
+        for (int distance : {1024, 1027}) {
+            for (int offset : {0, 1, 5, 15}) {
+                for (int count : {0, 3, 17, 100, 1000}) {
+                    for (SortOrder order : {SortOrder::Ascending, SortOrder::Descending}) {
+                        std::vector<int> data(offset + distance + count);
+                        for (int& x : data) x = static_cast<int>(gen() % 1000);
+                        std::vector<int> cached = data;
+                        std::vector<int> expected = data;
+                        for (int i = offset; i < offset + count; ++i) {
+                            int& a = expected[i];
+                            int& b = expected[i + distance];
+                            if ((order == SortOrder::Ascending) == (b < a)) std::swap(a, b);
+                        }
+                        kernels.compareAndSwapBlocks(cached.data() + offset, cached.data() + offset + distance,
+                                                     count, order);
+                        kernels.compareAndSwapBlocksStreaming(data.data() + offset, data.data() + offset + distance,
+                                                              count, order);
+                        EXPECT_EQ(cached, expected) << simdIsaName(isa) << " " << distance << "/" << offset << "/" << count;
+                        EXPECT_EQ(data, expected) << simdIsaName(isa) << " " << distance << "/" << offset << "/" << count;
+                    }
+                }
+            }
+        }
+    }
+}
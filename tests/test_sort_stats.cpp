@@ -0,0 +1,174 @@
+#include "gtest/gtest.h"
+#include "plain_bitonic_sorter.h"
+#include "std_thread_bitonic_sorter.h"
+#include "openmp_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include "hybrid_bitonic_sorter.h"
+#include "adaptive_sorter.h"
+#include "sort_stats.h"
+#include <vector>
+#include <algorithm> // For std::is_sorted
+#include <memory>    // For std::make_shared
+#include <random>    // For std::mt19937
+
+static std::vector<int> randomKeys(std::size_t size) {
+    std::mt19937 gen(11);
+    std::vector<int> data(size);
+    for (int& x : data) x = static_cast<int>(gen() % 1000000);
+    return data;
+}
+
+// Comparators of BasicBitonicSort's recursion, counted the slow way
+static std::uint64_t mergeComparators(std::uint64_t count) {
+    if (count <= 1) return 0;
+    std::uint64_t k = 1;
+    while (k < count - k) k *= 2;
+    return (count - k) + mergeComparators(k) + mergeComparators(count - k);
+}
+
+static std::uint64_t sortComparators(std::uint64_t count) {
+    if (count <= 1) return 0;
+    std::uint64_t k = 1;
+    while (k < count - k) k *= 2;
+    return sortComparators(k) + sortComparators(count - k) + mergeComparators(count);
+}
+
+TEST(SortStatsTest, NetworkComparatorCounts) {
+    for (std::uint64_t count : {0u, 1u, 2u, 3u, 7u, 8u, 100u, 1024u, 1025u, 5000u, 65536u, 100003u}) {
+        EXPECT_EQ(bitonicMergeComparators(count), mergeComparators(count)) << count;
+        EXPECT_EQ(bitonicSortComparators(count), sortComparators(count)) << count;
+    }
+    EXPECT_EQ(bitonicSortComparators(1 << 10), (1u << 9) * 10 * 11 / 2);
+}
+
+TEST(SortStatsTest, EmptyWithoutTheBuildOption) {
+    if (SORT_STATS_ENABLED) {
+        GTEST_SKIP() << "built with BITONIC_SORT_STATS";
+    }
+    PlainBitonicSorter sorter;
+    std::vector<int> data = randomKeys(5000);
+    sorter.sort(data, SortOrder::Ascending);
+    const SortStats stats = sorter.getStats();
+    EXPECT_EQ(stats.calls, 0u);
+    EXPECT_EQ(stats.compareExchanges(), 0u);
+    EXPECT_TRUE(stats.threads.empty());
+}
+
+class SortStatsEnabledTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!SORT_STATS_ENABLED) {
+            GTEST_SKIP() << "needs BITONIC_SORT_STATS";
+        }
+    }
+
+    // Sorts size random keys with sorter and checks what every sorter has to report
+    static SortStats sortAndCheck(BitonicSort& sorter, std::size_t size) {
+        std::vector<int> data = randomKeys(size);
+        sorter.resetStats();
+        sorter.sort(data, SortOrder::Ascending);
+        EXPECT_TRUE(std::is_sorted(data.begin(), data.end()));
+        const SortStats stats = sorter.getStats();
+        EXPECT_EQ(stats.calls, 1u);
+        EXPECT_EQ(stats.keys, size);
+        EXPECT_GT(stats.wall_seconds, 0.0);
+        EXPECT_FALSE(stats.threads.empty());
+        double busy = 0.0;
+        for (const SortThreadStats& thread : stats.threads) {
+            busy += thread.busy_seconds;
+        }
+        EXPECT_GT(busy, 0.0);
+        EXPECT_GE(stats.utilization(), 0.0);
+        EXPECT_LE(stats.utilization(), 1.0);
+        return stats;
+    }
+};
+
+TEST_F(SortStatsEnabledTest, PlainSorterCountsEveryCompareExchange) {
+    PlainBitonicSorter sorter;
+    const SortStats stats = sortAndCheck(sorter, 5000);
+    EXPECT_EQ(stats.scalar_compare_exchanges, bitonicSortComparators(5000));
+    EXPECT_EQ(stats.simd_compare_exchanges, 0u);
+    EXPECT_GT(stats.swaps, 0u);
+    EXPECT_LT(stats.swaps, stats.scalar_compare_exchanges);
+    EXPECT_GT(stats.phaseSeconds(SortPhase::Sort), 0.0);
+    EXPECT_GT(stats.phaseSeconds(SortPhase::Merge), 0.0);
+    EXPECT_EQ(stats.threads.size(), 1u);
+    // The first level of the top merge pairs 5000 - 4096 keys 4096 apart
+    ASSERT_GT(stats.merge_strides.size(), 12u);
+    EXPECT_EQ(stats.merge_strides[12].passes, 1u);
+    EXPECT_EQ(stats.merge_strides[12].compare_exchanges, 5000u - 4096u);
+    EXPECT_EQ(stats.merge_strides[9].passes, 0u); // Below MIN_TIMED_STRIDE
+
+    sorter.resetStats();
+    EXPECT_EQ(sorter.getStats().calls, 0u);
+    EXPECT_EQ(sorter.getStats().compareExchanges(), 0u);
+}
+
+TEST_F(SortStatsEnabledTest, ThreadedSortersCountTheSameNetwork) {
+    auto pool = std::make_shared<WorkStealingThreadPool>(3);
+    StdThreadBitonicSorter std_thread(pool);
+    const SortStats std_stats = sortAndCheck(std_thread, 100000);
+    EXPECT_EQ(std_stats.compareExchanges(), bitonicSortComparators(100000));
+    EXPECT_EQ(std_stats.thread_count, 4u);
+    EXPECT_FALSE(std_stats.merge_strides.empty());
+
+    OpenMPBitonicSorter openmp(4);
+    const SortStats omp_stats = sortAndCheck(openmp, 100000);
+    EXPECT_EQ(omp_stats.compareExchanges(), bitonicSortComparators(100000));
+    EXPECT_EQ(omp_stats.thread_count, 4u);
+
+    OpenMPSIMDBitonicSorter openmp_simd(SIMDIsa::Auto, 4);
+    openmp_simd.setThresholds({1 << 12, 1 << 10});
+    const SortStats omp_simd_stats = sortAndCheck(openmp_simd, 100000);
+    EXPECT_EQ(omp_simd_stats.compareExchanges(), bitonicSortComparators(100000));
+    EXPECT_EQ(omp_simd_stats.swaps, 0u);
+}
+
+TEST_F(SortStatsEnabledTest, SIMDSorterCountsKernelWork) {
+    auto pool = std::make_shared<WorkStealingThreadPool>(3);
+    SIMDBitonicSorter single;
+    SIMDBitonicSorter threaded(SIMDIsa::Auto, pool);
+    threaded.setThresholds({1 << 12, 1 << 10});
+    for (SIMDBitonicSorter* sorter : {&single, &threaded}) {
+        const SortStats stats = sortAndCheck(*sorter, 100003);
+        EXPECT_EQ(stats.compareExchanges(), bitonicSortComparators(100003)) << sorter->getName();
+        EXPECT_EQ(stats.swaps, 0u);
+        if (sorter->getIsa() != SIMDIsa::Scalar) {
+            EXPECT_DOUBLE_EQ(stats.simdFraction(), 1.0);
+        }
+    }
+    EXPECT_FALSE(threaded.getStats().merge_strides.empty());
+}
+
+TEST_F(SortStatsEnabledTest, WrappingSortersIncludeTheirInnerSorter) {
+    HybridBitonicSorter hybrid(SIMDIsa::Auto, 64 * 1024);
+    const SortStats hybrid_stats = sortAndCheck(hybrid, 200000);
+    EXPECT_GT(hybrid_stats.compareExchanges(), 0u);
+    EXPECT_GT(hybrid_stats.phaseSeconds(SortPhase::Merge), 0.0);
+
+    AdaptiveSorter adaptive(std::make_shared<PlainBitonicSorter>());
+    const SortStats adaptive_stats = sortAndCheck(adaptive, 20000);
+    // The scan itself runs no network
+    EXPECT_GT(adaptive_stats.scalar_compare_exchanges, 0u);
+    EXPECT_EQ(adaptive_stats.scalar_compare_exchanges,
+              adaptive.getInnerSorter()->getStats().scalar_compare_exchanges);
+    adaptive.resetStats();
+    EXPECT_EQ(adaptive.getInnerSorter()->getStats().calls, 0u);
+}
+
+TEST_F(SortStatsEnabledTest, MergeChargesTheCopy) {
+    StdThreadBitonicSorter sorter(2);
+    std::vector<int> a = randomKeys(3000);
+    std::vector<int> b = randomKeys(5000);
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    std::vector<int> out;
+    sorter.merge(a, b, out, SortOrder::Ascending);
+    EXPECT_TRUE(std::is_sorted(out.begin(), out.end()));
+    const SortStats stats = sorter.getStats();
+    EXPECT_EQ(stats.calls, 1u);
+    EXPECT_EQ(stats.keys, 8000u);
+    EXPECT_EQ(stats.compareExchanges(), bitonicMergeComparators(8000));
+    EXPECT_GT(stats.phaseSeconds(SortPhase::Copy), 0.0);
+}
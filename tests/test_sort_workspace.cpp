@@ -0,0 +1,172 @@
+#include "gtest/gtest.h"
+#include "sort_workspace.h"
+#include "simd_bitonic_sorter.h"
+#include "hybrid_bitonic_sorter.h"
+#include "adaptive_sorter.h"
+#include "plain_bitonic_sorter.h"
+#include <vector>
+#include <algorithm> // For std::is_sorted, std::sort
+#include <cstdint>   // For std::uintptr_t
+#include <random>    // For std::mt19937
+
+static std::vector<int> randomKeys(std::size_t size) {
+    std::mt19937 gen(5);
+    std::vector<int> data(size);
+    for (int& x : data) x = static_cast<int>(gen() % 1000000);
+    return data;
+}
+
+TEST(SortWorkspaceTest, SlotsAreAlignedAndReused) {
+    SortWorkspace workspace;
+    int* first = nullptr;
+    {
+        SortWorkspace::Lease lease(workspace);
+        first = lease.get<int>(0, 1000);
+        double* other = lease.get<double>(1, 10);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) % SortWorkspace::ALIGNMENT, 0u);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(other) % SortWorkspace::ALIGNMENT, 0u);
+        EXPECT_NE(static_cast<void*>(first), static_cast<void*>(other));
+    }
+    const std::size_t capacity = workspace.capacity();
+    EXPECT_GE(capacity, 1000 * sizeof(int) + 10 * sizeof(double));
+    {
+        SortWorkspace::Lease lease(workspace);
+        EXPECT_EQ(lease.get<int>(0, 500), first); // Smaller requests keep the block
+    }
+    EXPECT_EQ(workspace.capacity(), capacity);
+    {
+        SortWorkspace::Lease lease(workspace);
+        lease.get<int>(0, 100000);
+    }
+    EXPECT_GE(workspace.capacity(), 100000 * sizeof(int));
+    workspace.release();
+    EXPECT_EQ(workspace.capacity(), 0u);
+}
+
+TEST(SortWorkspaceTest, BusyWorkspaceLendsAPrivateOne) {
+    SortWorkspace workspace;
+    SortWorkspace::Lease outer(workspace);
+    int* shared = outer.get<int>(0, 64);
+    {
+        SortWorkspace::Lease inner(workspace); // Same thread, but the workspace is taken
+        int* own = inner.get<int>(0, 64);
+        EXPECT_NE(own, shared);
+    }
+}
+
+TEST(SortWorkspaceTest, CopiesStartEmpty) {
+    SortWorkspace workspace;
+    {
+        SortWorkspace::Lease lease(workspace);
+        lease.get<int>(0, 1000);
+    }
+    SortWorkspace copy(workspace);
+    EXPECT_EQ(copy.capacity(), 0u);
+    EXPECT_GT(workspace.capacity(), 0u);
+}
+
+TEST(SortWorkspaceTest, HybridSorterKeepsItsMergeBuffer) {
+    // Blocks of 1024 keys, so the merge passes need a buffer
+    HybridBitonicSorter sorter(SIMDIsa::Auto, 1024 * sizeof(int));
+    EXPECT_EQ(sorter.getWorkspaceBytes(), 0u);
+    std::vector<int> data = randomKeys(100000);
+    const std::size_t capacity = data.capacity();
+    sorter.sort(data, SortOrder::Ascending);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end()));
+    EXPECT_EQ(data.capacity(), capacity);
+    const std::size_t bytes = sorter.getWorkspaceBytes();
+    EXPECT_GE(bytes, data.size() * sizeof(int));
+
+    // Same size again and smaller inputs reuse it
+    data = randomKeys(100000);
+    sorter.sort(data, SortOrder::Descending);
+    EXPECT_TRUE(std::is_sorted(data.rbegin(), data.rend()));
+    std::vector<int> smaller = randomKeys(5000);
+    sorter.sort(smaller, SortOrder::Ascending);
+    EXPECT_TRUE(std::is_sorted(smaller.begin(), smaller.end()));
+    EXPECT_EQ(sorter.getWorkspaceBytes(), bytes);
+
+    sorter.releaseWorkspace();
+    EXPECT_EQ(sorter.getWorkspaceBytes(), 0u);
+    data = randomKeys(100000);
+    sorter.sort(data, SortOrder::Ascending);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end()));
+}
+
+TEST(SortWorkspaceTest, HybridPairsUseTwoSlots) {
+    HybridBitonicSorter sorter(SIMDIsa::Auto, 1024 * (sizeof(int) + sizeof(std::uint32_t)));
+    std::vector<int> keys = randomKeys(50000);
+    std::vector<std::uint32_t> values(keys.size());
+    for (std::size_t i = 0; i < values.size(); ++i) values[i] = static_cast<std::uint32_t>(keys[i]) ^ 0x5a5a5a5au;
+    sorter.sortPairs(keys, values, SortOrder::Ascending);
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_EQ(values[i], static_cast<std::uint32_t>(keys[i]) ^ 0x5a5a5a5au) << i;
+    }
+    EXPECT_GE(sorter.getWorkspaceBytes(), keys.size() * (sizeof(int) + sizeof(std::uint32_t)));
+}
+
+TEST(SortWorkspaceTest, AdaptiveSorterReportsItsAndTheInnerWorkspace) {
+    AdaptiveSorter sorter;
+    // Sorted with a few keys out of place, so keys are set aside and merged back
+    std::vector<int> data(200000);
+    for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<int>(i);
+    std::mt19937 gen(3);
+    for (int s = 0; s < 50; ++s) std::swap(data[gen() % data.size()], data[gen() % data.size()]);
+    sorter.sort(data, SortOrder::Ascending);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end()));
+    const std::size_t bytes = sorter.getWorkspaceBytes();
+    EXPECT_GT(bytes, 0u);
+    sorter.sort(data, SortOrder::Ascending);
+    EXPECT_EQ(sorter.getWorkspaceBytes(), bytes);
+    sorter.releaseWorkspace();
+    EXPECT_EQ(sorter.getWorkspaceBytes(), 0u);
+}
+
+TEST(SortWorkspaceTest, PackedPairsOf16BitKeys) {
+    BasicSIMDBitonicSorter<std::int16_t> sorter;
+    std::vector<std::int16_t> keys(3000);
+    std::vector<std::uint32_t> values(keys.size());
+    std::mt19937 gen(8);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = static_cast<std::int16_t>(gen());
+        values[i] = static_cast<std::uint32_t>(static_cast<std::uint16_t>(keys[i])) * 3u;
+    }
+    sorter.sortPairs(keys, values, SortOrder::Ascending);
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_EQ(values[i], static_cast<std::uint32_t>(static_cast<std::uint16_t>(keys[i])) * 3u) << i;
+    }
+    EXPECT_GE(sorter.getWorkspaceBytes(), keys.size() * sizeof(std::int64_t));
+}
+
+TEST(SortWorkspaceTest, SegmentsAndTopKKeepTheirScratch) {
+    SIMDBitonicSorter sorter(SIMDIsa::Auto, WorkStealingThreadPool::shared());
+    std::vector<int> data = randomKeys(100000);
+    std::vector<std::size_t> offsets = {0};
+    std::mt19937 gen(4);
+    while (offsets.back() < data.size()) {
+        offsets.push_back(std::min(data.size(), offsets.back() + 1 + gen() % 40));
+    }
+    sorter.sortSegments(data, offsets, SortOrder::Ascending);
+    for (std::size_t s = 0; s + 1 < offsets.size(); ++s) {
+        ASSERT_TRUE(std::is_sorted(data.begin() + offsets[s], data.begin() + offsets[s + 1])) << s;
+    }
+    const std::size_t bytes = sorter.getWorkspaceBytes();
+    EXPECT_GE(bytes, offsets.size() * sizeof(std::size_t));
+    data = randomKeys(100000);
+    sorter.sortSegments(data, offsets, SortOrder::Descending);
+    EXPECT_EQ(sorter.getWorkspaceBytes(), bytes);
+
+    // Every slice streams through its own chunk of k keys
+    std::vector<int> best = sorter.topK(data, 500, SortOrder::Ascending);
+    std::vector<int> expected = data;
+    std::sort(expected.begin(), expected.end());
+    expected.resize(500);
+    EXPECT_EQ(best, expected);
+    EXPECT_GE(sorter.getWorkspaceBytes(), 500 * sizeof(int));
+
+    PlainBitonicSorter plain;
+    EXPECT_EQ(plain.topK(data, 500, SortOrder::Ascending), expected);
+    EXPECT_GE(plain.getWorkspaceBytes(), 500 * sizeof(int));
+}
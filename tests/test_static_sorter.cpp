@@ -0,0 +1,112 @@
+#include "gtest/gtest.h"
+#include "static_bitonic_sorter.h"
+#include "plain_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include <array>
+#include <vector>
+#include <algorithm> // For std::sort, std::is_sorted
+#include <cmath>     // For std::signbit
+#include <cstdint>
+#include <functional> // For std::greater
+#include <limits>    // For std::numeric_limits
+#include <random>    // For std::mt19937
+
+static_assert(StaticBitonicSorter<8>::COMPARATORS == 24, "8 keys: 4 comparators per level, 6 levels");
+static_assert(StaticBitonicSorter<256>::COMPARATORS == 128 * 36, "256 keys: 128 comparators per level, 36 levels");
+
+template <typename T>
+static std::vector<T> randomKeys(std::size_t size, unsigned seed) {
+    std::mt19937_64 gen(seed);
+    std::vector<T> keys(size);
+    for (T& key : keys) {
+        if constexpr (std::is_floating_point<T>::value) {
+            key = static_cast<T>(static_cast<std::int64_t>(gen() % 2001) - 1000) / 8;
+        } else {
+            key = static_cast<T>(gen());
+        }
+    }
+    return keys;
+}
+
+template <typename T, std::size_t N>
+static void checkStaticNetwork() {
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        std::vector<T> keys = randomKeys<T>(N, seed);
+        std::vector<T> expected = keys;
+        std::sort(expected.begin(), expected.end(), SortKeyTraits<T>::less);
+        BasicStaticBitonicSorter<T, N, SortOrder::Ascending>::sort(keys.data());
+        ASSERT_EQ(keys, expected) << "N " << N << " seed " << seed;
+
+        std::reverse(expected.begin(), expected.end());
+        BasicStaticBitonicSorter<T, N, SortOrder::Descending>::sort(keys.data());
+        ASSERT_EQ(keys, expected) << "N " << N << " seed " << seed;
+    }
+}
+
+TEST(StaticBitonicSorterTest, SortsEveryNetworkSize) {
+    checkStaticNetwork<int, 2>();
+    checkStaticNetwork<int, 4>();
+    checkStaticNetwork<int, 8>();
+    checkStaticNetwork<int, 16>();
+    checkStaticNetwork<int, 32>();
+    checkStaticNetwork<int, 64>();
+    checkStaticNetwork<int, 128>();
+    checkStaticNetwork<int, 256>();
+}
+
+TEST(StaticBitonicSorterTest, SortsEveryKeyType) {
+    checkStaticNetwork<std::int16_t, 64>();
+    checkStaticNetwork<std::uint16_t, 64>();
+    checkStaticNetwork<std::uint32_t, 64>();
+    checkStaticNetwork<std::int64_t, 64>();
+    checkStaticNetwork<float, 64>();
+    checkStaticNetwork<double, 64>();
+}
+
+TEST(StaticBitonicSorterTest, FloatKeysFollowTotalOrder) {
+    std::array<double, 8> keys = {1.0, -0.0, std::numeric_limits<double>::quiet_NaN(), 0.0,
+                                  -std::numeric_limits<double>::infinity(), -1.0,
+                                  -std::numeric_limits<double>::quiet_NaN(), 2.0};
+    BasicStaticBitonicSorter<double, 8>::sort(keys);
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end(), SortKeyTraits<double>::less));
+    EXPECT_TRUE(std::signbit(keys[3])); // -0.0 before +0.0
+    EXPECT_FALSE(std::signbit(keys[4]));
+}
+
+TEST(StaticBitonicSorterTest, DispatchOnlyTakesNetworkSizes) {
+    std::vector<int> keys = randomKeys<int>(300, 1);
+    const std::vector<int> original = keys;
+    for (std::size_t count : {0u, 1u, 2u, 7u, 9u, 100u, 255u, 257u, 300u}) {
+        EXPECT_FALSE(sortWithStaticNetwork(keys.data(), count, SortOrder::Ascending)) << count;
+    }
+    EXPECT_EQ(keys, original);
+    for (std::size_t count : {8u, 16u, 32u, 64u, 128u, 256u}) {
+        keys = original;
+        EXPECT_TRUE(sortWithStaticNetwork(keys.data(), count, SortOrder::Descending)) << count;
+        EXPECT_TRUE(std::is_sorted(keys.begin(), keys.begin() + count, std::greater<int>())) << count;
+        EXPECT_TRUE(std::equal(keys.begin() + count, keys.end(), original.begin() + count)) << count;
+    }
+}
+
+TEST(StaticBitonicSorterTest, SortersMatchAroundNetworkSizes) {
+    // Plain takes the static network at the listed sizes, SIMD a register network sized to
+    // the input; the sizes either side take the general paths
+    PlainBitonicSorter plain;
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        SIMDBitonicSorter simd(isa);
+        for (std::size_t size = 2; size <= 260; ++size) {
+            const std::vector<int> keys = randomKeys<int>(size, static_cast<unsigned>(size));
+            std::vector<int> expected = keys;
+            std::sort(expected.begin(), expected.end());
+            std::vector<int> by_plain = keys;
+            std::vector<int> by_simd = keys;
+            plain.sort(by_plain, SortOrder::Ascending);
+            simd.sort(by_simd, SortOrder::Ascending);
+            ASSERT_EQ(by_plain, expected) << "size " << size;
+            ASSERT_EQ(by_simd, expected) << simd.getName() << " size " << size;
+        }
+    }
+}
@@ -145,3 +145,12 @@ TEST_F(StdThreadBitonicSorterTest, MaxRecursionDepthTest) {
     std::generate(vec.begin(), vec.end(), std::rand);
     run_sort_test(sorter_1_thread_, vec, SortOrder::Ascending);
 }
+
+TEST_F(StdThreadBitonicSorterTest, ParallelCompareLoopsLargeSize) {
+    // Large enough that the top merge levels split their compare-exchange loops across the pool
+    std::vector<int> vec((1 << 16) + 5);
+    std::generate(vec.begin(), vec.end(), std::rand);
+    run_sort_test(sorter_4_threads_, vec, SortOrder::Ascending);
+    std::generate(vec.begin(), vec.end(), std::rand);
+    run_sort_test(sorter_4_threads_, vec, SortOrder::Descending);
+}
@@ -0,0 +1,140 @@
+#include "gtest/gtest.h"
+#include "work_stealing_thread_pool.h"
+#include "std_thread_bitonic_sorter.h"
+#include <algorithm> // For std::sort
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>    // For std::mt19937
+#include <set>
+#include <stdexcept> // For std::runtime_error, std::invalid_argument
+#include <thread>
+#include <vector>
+
+// Recursive fork-join sum; each level forks its left half into the pool
+static long forkJoinSum(WorkStealingThreadPool& pool, const std::vector<int>& data, size_t lo, size_t hi) {
+    if (hi - lo <= 64) {
+        long sum = 0;
+        for (size_t i = lo; i < hi; ++i) sum += data[i];
+        return sum;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    long left = 0;
+    WorkStealingThreadPool::TaskGroup group;
+    pool.submit(group, [&] { left = forkJoinSum(pool, data, lo, mid); });
+    long right = forkJoinSum(pool, data, mid, hi);
+    pool.wait(group);
+    return left + right;
+}
+
+TEST(WorkStealingThreadPoolTest, RunsEverySubmittedTask) {
+    WorkStealingThreadPool pool(3);
+    std::atomic<int> counter{0};
+    WorkStealingThreadPool::TaskGroup group;
+    for (int i = 0; i < 1000; ++i) {
+        pool.submit(group, [&] { counter.fetch_add(1); });
+    }
+    pool.wait(group);
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+TEST(WorkStealingThreadPoolTest, NestedForkJoinDoesNotDeadlock) {
+    std::vector<int> data(100000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<int>(i % 1000);
+    const long expected = forkJoinSum(*std::make_unique<WorkStealingThreadPool>(0), data, 0, data.size());
+    for (unsigned int workers : {0u, 1u, 3u, 8u}) {
+        WorkStealingThreadPool pool(workers);
+        EXPECT_EQ(forkJoinSum(pool, data, 0, data.size()), expected) << workers << " workers";
+    }
+}
+
+TEST(WorkStealingThreadPoolTest, TasksRunOnAtMostWorkersPlusCaller) {
+    WorkStealingThreadPool pool(2);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    WorkStealingThreadPool::TaskGroup group;
+    for (int i = 0; i < 200; ++i) {
+        pool.submit(group, [&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        });
+    }
+    pool.wait(group);
+    EXPECT_LE(threads.size(), 3u);
+}
+
+TEST(WorkStealingThreadPoolTest, WaitRethrowsTaskException) {
+    WorkStealingThreadPool pool(2);
+    WorkStealingThreadPool::TaskGroup group;
+    std::atomic<int> finished{0};
+    pool.submit(group, [] { throw std::runtime_error("task failed"); });
+    for (int i = 0; i < 10; ++i) {
+        pool.submit(group, [&] { finished.fetch_add(1); });
+    }
+    EXPECT_THROW(pool.wait(group), std::runtime_error);
+    EXPECT_EQ(finished.load(), 10); // The other tasks still ran to completion
+}
+
+TEST(WorkStealingThreadPoolTest, ParallelForWaitsWhenCallersChunkThrows) {
+    WorkStealingThreadPool pool(2);
+    std::atomic<int> finished{0};
+    // The caller runs the first chunk; the others are queued before it and must not outlive
+    // the call, since they refer to its fn
+    EXPECT_THROW(pool.parallelFor(0, 120, 1,
+                                  [&](int begin, int end) {
+                                      if (begin == 0) {
+                                          throw std::runtime_error("caller's chunk failed");
+                                      }
+                                      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                                      finished.fetch_add(end - begin);
+                                  }),
+                 std::runtime_error);
+    EXPECT_EQ(finished.load(), 120 - 10); // Every chunk but the caller's 10 elements
+    EXPECT_THROW(pool.parallelFor(0, 10, 0, [](int, int) {}), std::invalid_argument);
+}
+
+TEST(WorkStealingThreadPoolTest, SortersShareOnePoolConcurrently) {
+    auto pool = std::make_shared<WorkStealingThreadPool>(3);
+    StdThreadBitonicSorter first(pool);
+    StdThreadBitonicSorter second(pool);
+    EXPECT_NE(first.getName().find("max_threads=4"), std::string::npos);
+
+    std::mt19937 gen(11);
+    std::vector<std::vector<int>> inputs(4, std::vector<int>(50000));
+    for (auto& input : inputs) {
+        for (int& x : input) x = static_cast<int>(gen());
+    }
+    std::vector<std::vector<int>> outputs = inputs;
+    std::vector<std::thread> callers;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        StdThreadBitonicSorter& sorter = (i % 2 == 0) ? first : second;
+        callers.emplace_back([&sorter, &outputs, i] { sorter.sort(outputs[i], SortOrder::Ascending); });
+    }
+    for (std::thread& caller : callers) caller.join();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        std::sort(inputs[i].begin(), inputs[i].end());
+        EXPECT_EQ(outputs[i], inputs[i]) << "input " << i;
+    }
+}
+
+TEST(WorkStealingThreadPoolTest, SorterRejectsNullPool) {
+    EXPECT_THROW(StdThreadBitonicSorter(std::shared_ptr<WorkStealingThreadPool>()), std::invalid_argument);
+    // A pool of no workers is how to run on the caller alone
+    StdThreadBitonicSorter sorter(std::make_shared<WorkStealingThreadPool>(0));
+    std::vector<int> data = {5, 3, 9, 1, 7};
+    sorter.sort(data, SortOrder::Ascending);
+    EXPECT_EQ(data, std::vector<int>({1, 3, 5, 7, 9}));
+}
+
+TEST(WorkStealingThreadPoolTest, SorterReusesItsPoolAcrossCalls) {
+    StdThreadBitonicSorter sorter(4);
+    std::mt19937 gen(5);
+    for (int round = 0; round < 50; ++round) {
+        std::vector<int> data(4096 + round);
+        for (int& x : data) x = static_cast<int>(gen() % 100);
+        std::vector<int> expected = data;
+        std::sort(expected.begin(), expected.end());
+        sorter.sort(data, SortOrder::Ascending);
+        ASSERT_EQ(data, expected) << "round " << round;
+    }
+}
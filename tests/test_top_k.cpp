@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include "plain_bitonic_sorter.h"
+#include "std_thread_bitonic_sorter.h"
+#include "openmp_bitonic_sorter.h"
+#include "simd_bitonic_sorter.h"
+#include "blocked_bitonic_sorter.h"
+#include "hybrid_bitonic_sorter.h"
+#include <vector>
+#include <algorithm> // For std::sort
+#include <cstdint>
+#include <cstring>   // For std::memcmp
+#include <functional> // For std::greater
+#include <memory>    // For std::unique_ptr, std::make_shared
+#include <random>    // For std::mt19937
+
+static std::vector<std::unique_ptr<BitonicSort>> allSorters() {
+    std::vector<std::unique_ptr<BitonicSort>> sorters;
+    sorters.emplace_back(new PlainBitonicSorter());
+    sorters.emplace_back(new StdThreadBitonicSorter(4));
+    sorters.emplace_back(new OpenMPBitonicSorter());
+    sorters.emplace_back(new SIMDBitonicSorter());
+    sorters.emplace_back(new SIMDBitonicSorter(SIMDIsa::Auto, std::make_shared<WorkStealingThreadPool>(3)));
+    sorters.emplace_back(new BlockedBitonicSorter(1024));
+    sorters.emplace_back(new HybridBitonicSorter(SIMDIsa::Auto, 1024));
+    return sorters;
+}
+
+template <typename T>
+static void expectTopK(BasicBitonicSort<T>& sorter, const std::vector<T>& data, std::size_t k, SortOrder order) {
+    std::vector<T> expected = data;
+    if (order == SortOrder::Ascending) {
+        std::sort(expected.begin(), expected.end(), [](T a, T b) { return SortKeyTraits<T>::less(a, b); });
+    } else {
+        std::sort(expected.begin(), expected.end(), [](T a, T b) { return SortKeyTraits<T>::less(b, a); });
+    }
+    expected.resize(std::min(k, data.size()));
+    std::vector<T> top = sorter.topK(data, k, order);
+    ASSERT_EQ(top.size(), expected.size()) << sorter.getName() << " k " << k;
+    EXPECT_EQ(0, std::memcmp(top.data(), expected.data(), top.size() * sizeof(T)))
+        << sorter.getName() << " size " << data.size() << " k " << k;
+}
+
+TEST(TopKTest, EverySorterAndK) {
+    std::mt19937 gen(3);
+    for (auto& sorter : allSorters()) {
+        for (std::size_t size : {0u, 1u, 100u, 5000u, 200003u}) {
+            std::vector<int> data(size);
+            for (int& x : data) x = static_cast<int>(gen() % 100000) - 50000;
+            for (std::size_t k : {0u, 1u, 7u, 64u, 100u, 1000u, 5000u, 300000u}) {
+                expectTopK<int>(*sorter, data, k, SortOrder::Ascending);
+                expectTopK<int>(*sorter, data, k, SortOrder::Descending);
+            }
+        }
+    }
+}
+
+// Sorted input makes every key a candidate; reversed input none after the first chunk
+TEST(TopKTest, SortedAndReversedInput) {
+    SIMDBitonicSorter sorter(SIMDIsa::Auto, std::make_shared<WorkStealingThreadPool>(3));
+    std::vector<int> data(300000);
+    for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<int>(i);
+    expectTopK<int>(sorter, data, 100, SortOrder::Descending);
+    expectTopK<int>(sorter, data, 100, SortOrder::Ascending);
+    std::reverse(data.begin(), data.end());
+    expectTopK<int>(sorter, data, 100, SortOrder::Descending);
+    expectTopK<int>(sorter, data, 1000, SortOrder::Ascending);
+}
+
+TEST(TopKTest, FloatKeysFollowTotalOrder) {
+    std::mt19937 gen(9);
+    std::vector<float> data(70000);
+    for (float& x : data) x = static_cast<float>(gen() % 2000) - 1000.0f;
+    data[5] = std::numeric_limits<float>::quiet_NaN();
+    data[9] = -0.0f;
+    data[11] = -std::numeric_limits<float>::infinity();
+    for (SIMDIsa isa : {SIMDIsa::Scalar, SIMDIsa::SSE41, SIMDIsa::AVX2, SIMDIsa::AVX512}) {
+        if (!cpuSupports(isa)) {
+            continue;
+        }
+        BasicSIMDBitonicSorter<float> sorter(isa);
+        expectTopK<float>(sorter, data, 33, SortOrder::Ascending);
+        expectTopK<float>(sorter, data, 33, SortOrder::Descending);
+    }
+    BasicPlainBitonicSorter<float> plain;
+    expectTopK<float>(plain, data, 33, SortOrder::Descending);
+}
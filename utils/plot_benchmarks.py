@@ -10,22 +10,86 @@ import re
 
 # Define the input CSV file and output directory
 CSV_FILE_PATH = 'doc/data/performance_results.csv'
+# Written by memory_benchmarks --benchmark_format=csv; plotted only if present
+MEMORY_CSV_FILE_PATH = 'doc/data/memory_results.csv'
 FIGURES_DIR = 'doc/figures'
+# Benchmarks registered as BM_<Sorter>BitonicSort/<size>/<threads>; 0 threads means the
+# sorter's default (hardware concurrency)
+THREADED_SORTERS = ('StdThread', 'OpenMP')
+
+# What the arguments after the size mean, per benchmark (sorter_type below), so that each
+# combination is its own series: (name, names of values) per argument. A None name shows
+# just the value's name; values without a name show as the number.
+BENCHMARK_ARGS = {
+    'OpenMPProcBind': [('threads', {0: 'default'}), ('bind', {0: 'default', 1: 'close', 2: 'spread'}),
+                       ('cutoff', {-1: 'auto'})],
+    'ThreadScaling': [(None, {0: 'StdThread', 1: 'OpenMP', 2: 'SIMD', 3: 'SIMD + pool', 4: 'OpenMP + SIMD'}),
+                      ('threads', {})],
+    'SIMDIsa': [(None, {2: 'SSE4.1', 3: 'AVX2', 4: 'AVX-512'})],
+    'SmallFixedSort': [(None, {0: 'std::sort', 1: 'static network', 2: 'Plain', 3: 'SIMD'})],
+    'AsyncSort': [(None, {0: 'SIMD, synchronous', 1: 'async', 2: 'async, pipelined'})],
+    'SIMDAlignment': [('offset', {})],
+    'CompareAndSwapPass': [('offset', {}), (None, {0: 'stores', 1: 'streaming stores'})],
+    'SortSegments': [(None, {0: 'sort() per segment', 1: 'sortSegments', 2: 'sortSegments + pool'})],
+    'BlockedLarge': [('tile KiB', {})],
+    'HybridLarge': [(None, {0: 'one thread', 1: 'shared pool'})],
+    'SortDistribution': [(None, dict(enumerate(['random', 'few_unique', 'all_equal', 'zipf', 'sawtooth',
+                                                'organ_pipe', 'nearly_sorted', 'sorted', 'reversed']))),
+                         (None, {0: 'std::sort', 1: 'std::stable_sort', 2: 'std::sort(par)', 3: 'Plain',
+                                 4: 'SIMD', 5: 'SIMD + pool', 6: 'Hybrid + pool', 7: 'Adaptive + pool'})],
+    'SIMDTopK': [('k', {}), (None, {0: 'one thread', 1: 'shared pool'})],
+    'NearlySortedSort': [(None, {0: 'sorted', 1: '0.1% out of place', 10: '1% out of place', 100: '10% out of place',
+                                 1000: 'all out of place', -1: 'reversed'}),
+                         (None, {0: 'SIMD', 1: 'Adaptive'})],
+    'MergeSorted': [(None, {0: 'std::merge', 1: 'SIMD merge path', 2: 'SIMD merge path + pool',
+                            3: 'StdThread bitonic merge'})],
+    'InstrumentedSort': [(None, {0: 'Plain', 1: 'StdThread', 2: 'OpenMP', 3: 'SIMD + pool', 4: 'Hybrid + pool'})],
+}
+# Too many series for one figure: one figure per value of the first argument instead
+SPLIT_BY_FIRST_ARG = ('SortDistribution',)
+# range(0) is not an input size (BM_ExternalSort's is the file size in MiB)
+NOT_SIZED = ('ExternalSort',)
+# Google Benchmark's run options, appended to the name after the arguments
+RUN_OPTION = re.compile(r'^(real_time|process_time|manual_time|(min_time|iterations|repeats):.*)$')
+TIME_UNIT_NS = {'ns': 1, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+def describe_args(sorter_type, args):
+    """One label per argument after the size"""
+    descriptions = BENCHMARK_ARGS.get(sorter_type)
+    if descriptions is None or len(descriptions) != len(args):
+        return list(args)
+    labels = []
+    for (name, values), arg in zip(descriptions, args):
+        try:
+            text = str(values.get(int(arg), arg))
+        except ValueError:
+            text = arg
+        labels.append(f'{name}={text}' if name else text)
+    return labels
+
+def threads_label(sorter, thread_count):
+    return f'{sorter} ({int(thread_count)} thr)' if thread_count > 0 else f'{sorter} (default thr)'
 
 def parse_benchmark_name(name):
-    parts = name.split('/')
+    """Returns (sorter_type, data_size, threads, variant). variant describes the arguments after
+    the size, e.g. 'AVX2' for BM_SIMDBitonicSortIsa/<n>/3, and is None when there are none."""
+    parts = [part for part in name.split('/') if not RUN_OPTION.match(part)]
+    # Arguments registered with ArgNames show as name:value
+    parts = parts[:1] + [part.split(':', 1)[1] if ':' in part and not part.startswith('threads:') else part
+                         for part in parts[1:]]
     sorter_type = parts[0].replace('BM_', '').replace('BitonicSort', '')
 
     data_size = None
     threads = None
+    variant = None
 
     # Attempt to find data size (always present as range(0))
     # It's the first numeric part after BM_SorterName
     if len(parts) > 1 and parts[1].isdigit():
         data_size = int(parts[1])
 
-    # Attempt to find thread count for StdThread
-    if 'StdThread' in sorter_type and len(parts) > 2:
+    # Thread count of the threaded sorters
+    if sorter_type in THREADED_SORTERS and len(parts) > 2:
         if parts[2].isdigit(): # Handles cases like BM_StdThreadBitonicSort/size/threads
              threads = int(parts[2])
         elif "threads:" in parts[2] : # Handles cases like BM_StdThreadBitonicSort/size/threads:N (older benchmark format)
@@ -33,16 +97,16 @@ def parse_benchmark_name(name):
                 threads = int(parts[2].split(':')[1])
             except (IndexError, ValueError):
                 threads = None # Could not parse
+    elif len(parts) > 2:
+        labels = describe_args(sorter_type, parts[2:])
+        if sorter_type in SPLIT_BY_FIRST_ARG and len(labels) > 1:
+            sorter_type = f'{sorter_type} ({labels[0]})'
+            labels = labels[1:]
+        variant = ', '.join(labels)
 
-    # For OpenMP, threads are not explicitly in the name from the C++ benchmark setup
-    # We can assume it uses max threads or a default. Label it for clarity.
-    if 'OpenMP' in sorter_type:
-        # If a specific thread count was passed and encoded, parse it.
-        # Otherwise, use a label like 'Max' or 'Default'.
-        # For now, we don't have this in the name, so it will be None.
-        pass # threads remains None
-
-    return sorter_type, data_size, threads
+    if sorter_type in NOT_SIZED:
+        data_size = None
+    return sorter_type, data_size, threads, variant
 
 def plot_performance(df):
     # Set a nice style
@@ -54,8 +118,7 @@ def plot_performance(df):
         os.makedirs(FIGURES_DIR)
 
     # --- Plot 1: Performance vs. Input Size for all sorters ---
-    # For StdThread, we need to select its best performing thread count or a representative one.
-    # Or, plot all its thread variations. For simplicity, let's find best or use hardware_concurrency if available.
+    # The threaded sorters get one line per thread count
 
     plt.figure(figsize=(14, 8))
 
@@ -65,16 +128,13 @@ def plot_performance(df):
         subset = df[df['sorter_type'] == sorter]
         label = sorter
 
-        if sorter == 'StdThread':
-            # Find the thread count that gives min time for each size, or plot a few specific ones.
-            # For simplicity, let's pick the one with most threads if 'threads' column is good
-            # Or let's plot each thread configuration for StdThread separately
+        if sorter in THREADED_SORTERS:
             if 'threads' in subset.columns and subset['threads'].notna().any():
                 for thread_count in sorted(subset['threads'].dropna().unique()):
                     thread_subset = subset[subset['threads'] == thread_count]
                     if not thread_subset.empty:
-                        plt.plot(thread_subset['data_size'], thread_subset['cpu_time'], marker='o', linestyle='-', label=f'StdThread ({int(thread_count)} thr)')
-                continue # Skip generic 'StdThread' label if we plotted per-thread lines
+                        plt.plot(thread_subset['data_size'], thread_subset['cpu_time'], marker='o', linestyle='-', label=threads_label(sorter, thread_count))
+                continue # Skip the generic label if we plotted per-thread lines
 
         if not subset.empty:
              plt.plot(subset['data_size'], subset['cpu_time'], marker='o', linestyle='-', label=label)
@@ -96,42 +156,49 @@ def plot_performance(df):
     plt.close()
     print(f"Saved performance comparison plot to {plot_path}")
 
-    # --- Plot 2: StdThread Scalability (Time vs Threads for a large N) ---
-    if 'StdThread' in sorter_names:
-        std_thread_df = df[df['sorter_type'] == 'StdThread'].copy()
-        if not std_thread_df.empty and 'threads' in std_thread_df.columns and std_thread_df['threads'].notna().any():
-            # Select a large data size, e.g., the largest one available
-            largest_n = std_thread_df['data_size'].max()
-            scalability_data = std_thread_df[std_thread_df['data_size'] == largest_n].copy()
-            scalability_data.dropna(subset=['threads'], inplace=True) # Ensure threads data is not NaN
-            scalability_data['threads'] = scalability_data['threads'].astype(int)
-            scalability_data.sort_values('threads', inplace=True)
-
-            if not scalability_data.empty: # Changed .empty() to .empty
-                plt.figure(figsize=(10, 6))
-                plt.plot(scalability_data['threads'], scalability_data['cpu_time'], marker='o', linestyle='-')
-                plt.title(f'StdThread Scalability (N={largest_n})', fontsize=16)
-                plt.xlabel('Number of Threads', fontsize=14)
-                plt.ylabel('CPU Time (nanoseconds)', fontsize=14)
-                # Ensure x-axis shows integer thread counts
-                plt.gca().xaxis.set_major_locator(ticker.MaxNLocator(integer=True))
-                plt.grid(True, which="both", ls="-", alpha=0.7)
-                plt.tight_layout()
-                scalability_plot_path = os.path.join(FIGURES_DIR, 'std_thread_scalability.png')
-                plt.savefig(scalability_plot_path)
-                plt.close()
-                print(f"Saved StdThread scalability plot to {scalability_plot_path}")
-            else:
-                print("Not enough data for StdThread scalability plot (largest N or threads missing).")
-        else:
-            print("StdThread data or 'threads' column not suitable for scalability plot.")
-    else:
-        print("StdThread sorter not found in data, skipping scalability plot.")
+    # --- Plot 2: Scalability of the threaded sorters (Time vs Threads for a large N) ---
+    for sorter in THREADED_SORTERS:
+        plot_scalability(df, sorter)
+
+def plot_scalability(df, sorter):
+    if sorter not in df['sorter_type'].unique():
+        print(f"{sorter} sorter not found in data, skipping scalability plot.")
+        return
+    sorter_df = df[df['sorter_type'] == sorter].copy()
+    if sorter_df.empty or 'threads' not in sorter_df.columns or not sorter_df['threads'].notna().any():
+        print(f"{sorter} data or 'threads' column not suitable for scalability plot.")
+        return
+    # Select a large data size, e.g., the largest one available
+    largest_n = sorter_df['data_size'].max()
+    scalability_data = sorter_df[sorter_df['data_size'] == largest_n].copy()
+    scalability_data.dropna(subset=['threads'], inplace=True) # Ensure threads data is not NaN
+    scalability_data['threads'] = scalability_data['threads'].astype(int)
+    # 0 is the sorter's default thread count, not a point on the axis
+    scalability_data = scalability_data[scalability_data['threads'] > 0]
+    scalability_data.sort_values('threads', inplace=True)
+    if scalability_data.empty:
+        print(f"Not enough data for {sorter} scalability plot (largest N or threads missing).")
+        return
+
+    plt.figure(figsize=(10, 6))
+    plt.plot(scalability_data['threads'], scalability_data['cpu_time'], marker='o', linestyle='-')
+    plt.title(f'{sorter} Scalability (N={largest_n})', fontsize=16)
+    plt.xlabel('Number of Threads', fontsize=14)
+    plt.ylabel('CPU Time (nanoseconds)', fontsize=14)
+    # Ensure x-axis shows integer thread counts
+    plt.gca().xaxis.set_major_locator(ticker.MaxNLocator(integer=True))
+    plt.grid(True, which="both", ls="-", alpha=0.7)
+    plt.tight_layout()
+    file_prefix = {'StdThread': 'std_thread', 'OpenMP': 'openmp'}[sorter]
+    scalability_plot_path = os.path.join(FIGURES_DIR, f'{file_prefix}_scalability.png')
+    plt.savefig(scalability_plot_path)
+    plt.close()
+    print(f"Saved {sorter} scalability plot to {scalability_plot_path}")
 
 def plot_fixed_size_comparison(df, target_size):
     """
     Plots a bar chart comparing CPU times of different sorting algorithms for a fixed input size.
-    For StdThread, it finds the best performing thread count.
+    For the threaded sorters, it finds the best performing thread count.
     """
     sns.set_style("whitegrid") # Ensure style is set
     plt.rcParams['figure.dpi'] = 300
@@ -156,17 +223,16 @@ def plot_fixed_size_comparison(df, target_size):
         if subset.empty:
             continue
 
-        if sorter == 'StdThread':
+        if sorter in THREADED_SORTERS:
             if 'threads' in subset.columns and subset['threads'].notna().any():
                 # Find the row with the minimum cpu_time for this sorter and target_size
                 best_run = subset.loc[subset['cpu_time'].idxmin()]
                 # Use a descriptive name including the best thread count
-                # Ensure thread_count is an int for formatting if not NaN
                 thread_count = best_run['threads']
-                label = f"StdThread ({int(thread_count)} thr)" if pd.notna(thread_count) else "StdThread (best)"
+                label = threads_label(sorter, thread_count) if pd.notna(thread_count) else f"{sorter} (best)"
                 plot_data.append({'sorter_type': label, 'cpu_time': best_run['cpu_time']})
             else: # Fallback if threads column is not informative
-                plot_data.append({'sorter_type': 'StdThread (best)', 'cpu_time': subset['cpu_time'].min()})
+                plot_data.append({'sorter_type': f'{sorter} (best)', 'cpu_time': subset['cpu_time'].min()})
         else:
             # For other sorters, there's usually one entry per size (or they don't vary by threads in the same way)
             # If multiple entries, take the first one or average/min if appropriate. Assuming one for now.
@@ -206,32 +272,71 @@ def plot_fixed_size_comparison(df, target_size):
     print(f"Saved fixed size comparison plot to {plot_path}")
 
 
-def main():
+def plot_benchmark_variants(df):
+    """
+    One figure per benchmark with arguments besides the size, one series per combination of
+    them: time against input size, or a bar per series if the benchmark runs one size.
+    """
+    sns.set_style("whitegrid")
+    plt.rcParams['figure.dpi'] = 300
+
+    if not os.path.exists(FIGURES_DIR):
+        os.makedirs(FIGURES_DIR)
+
+    for benchmark in df['sorter_type'].unique():
+        subset = df[df['sorter_type'] == benchmark]
+        plt.figure(figsize=(14, 8))
+        if subset['data_size'].nunique() > 1:
+            for variant in subset['variant'].unique():
+                series = subset[subset['variant'] == variant].sort_values('data_size')
+                plt.plot(series['data_size'], series['time'], marker='o', linestyle='-', label=variant)
+            plt.xlabel('Input Size (N)', fontsize=14)
+            plt.xscale('log', base=2)
+            plt.yscale('log')
+            plt.gca().xaxis.set_major_formatter(ticker.FuncFormatter(lambda x, _: f'{int(x)}'))
+            plt.legend(fontsize=8, ncol=2)
+            plt.title(f'{benchmark}', fontsize=16)
+        else:
+            bars = subset.sort_values('time')
+            plt.bar(bars['variant'], bars['time'])
+            plt.xticks(rotation=45, ha="right")
+            plt.title(f'{benchmark} (N={subset["data_size"].iloc[0]})', fontsize=16)
+        plt.ylabel('Time (nanoseconds)', fontsize=14)
+        plt.grid(True, which="both", ls="-", alpha=0.7)
+        plt.tight_layout()
+        plot_path = os.path.join(FIGURES_DIR, f"benchmark_{re.sub(r'[^A-Za-z0-9]+', '_', benchmark).strip('_')}.png")
+        plt.savefig(plot_path)
+        plt.close()
+        print(f"Saved {benchmark} plot to {plot_path}")
+
+def load_benchmark_csv(path):
+    """Reads Google Benchmark CSV output, skipping the context lines before the header.
+    Returns None if the file is missing or unreadable."""
     # Find the actual header row
     header_row_index = 0
     try:
-        with open(CSV_FILE_PATH, 'r') as f:
+        with open(path, 'r') as f:
             for i, line in enumerate(f):
                 # Google Benchmark CSV header starts with 'name' or sometimes '\"name\"' if quoted
                 if line.strip().startswith('"name",') or line.strip().startswith('name,'):
                     header_row_index = i
                     break
             else: # no break
-                print(f"Error: Could not find the CSV header row starting with 'name,' in {CSV_FILE_PATH}")
-                return
+                print(f"Error: Could not find the CSV header row starting with 'name,' in {path}")
+                return None
     except FileNotFoundError:
-        print(f"Error: CSV file not found at {CSV_FILE_PATH}")
-        return
+        print(f"Error: CSV file not found at {path}")
+        return None
 
     # Try to read the CSV, starting from the identified header row
     try:
-        df = pd.read_csv(CSV_FILE_PATH, skiprows=header_row_index)
+        df = pd.read_csv(path, skiprows=header_row_index)
     except pd.errors.EmptyDataError:
-        print(f"Error: CSV file is empty or header not found correctly at {CSV_FILE_PATH}")
-        return
+        print(f"Error: CSV file is empty or header not found correctly at {path}")
+        return None
     except Exception as e:
         print(f"Error reading CSV file: {e}")
-        return
+        return None
 
     # Filter out benchmark aggregate rows if any (e.g., those with 'median', 'mean' if not desired)
     # Google benchmark CSV output for version specified usually has 'name', 'iterations', 'real_time', 'cpu_time', 'time_unit', etc.
@@ -243,21 +348,15 @@ def main():
     df['sorter_type'] = [item[0] for item in parsed_names]
     df['data_size'] = [item[1] for item in parsed_names]
     df['threads'] = [item[2] for item in parsed_names]
+    df['variant'] = [item[3] for item in parsed_names]
 
-    # Convert time to a common unit, e.g., nanoseconds, if not already
-    # Google benchmark CSV output has 'real_time' and 'cpu_time' columns, and 'time_unit' (e.g., 'ns', 'us', 'ms')
-    # For simplicity, assuming times are already in nanoseconds or a consistent unit that can be plotted directly.
-    # If conversion is needed:
-    # def convert_to_ns(row):
-    #     time = row['cpu_time'] # or 'real_time'
-    #     unit = row['time_unit']
-    #     if unit == 'ms':
-    #         return time * 1e6
-    #     elif unit == 'us':
-    #         return time * 1e3
-    #     return time # assume ns
-    # df['cpu_time_ns'] = df.apply(convert_to_ns, axis=1)
-    # Then use 'cpu_time_ns' for plotting. For now, direct 'cpu_time' is used.
+    # The large sizes are registered in milliseconds; plot everything in nanoseconds
+    scale = df['time_unit'].map(TIME_UNIT_NS).fillna(1)
+    df['real_time'] = df['real_time'] * scale
+    df['cpu_time'] = df['cpu_time'] * scale
+    # Benchmarks registered with UseRealTime() are timed by wall clock: their worker
+    # threads do not show up in the calling thread's CPU time
+    df['time'] = df['cpu_time'].where(~df['name'].str.contains('/real_time'), df['real_time'])
 
     # Drop rows where data_size might be None (e.g. from parsing issues or header)
     df.dropna(subset=['data_size'], inplace=True)
@@ -266,16 +365,66 @@ def main():
     # Filter out any non-successful runs if error_occurred column exists and is true
     if 'error_occurred' in df.columns:
         df = df[df['error_occurred'].fillna(False) == False] # Keep rows where error_occurred is false or NaN
+    return df
+
+def plot_memory(df):
+    """
+    Plots peak extra heap bytes and allocations per sort() against input size, one line per
+    sorter, from the memory_benchmarks counters.
+    """
+    sns.set_style("whitegrid")
+    plt.rcParams['figure.dpi'] = 300
+
+    if not os.path.exists(FIGURES_DIR):
+        os.makedirs(FIGURES_DIR)
+
+    for column, ylabel, filename in [('peak_extra_bytes', 'Peak Extra Heap (bytes)', 'memory_peak_extra_bytes.png'),
+                                     ('allocs_per_sort', 'Allocations per sort()', 'memory_allocs_per_sort.png')]:
+        if column not in df.columns:
+            print(f"Column '{column}' not in memory results, skipping its plot.")
+            continue
+        plt.figure(figsize=(14, 8))
+        for sorter in df['sorter_type'].unique():
+            subset = df[df['sorter_type'] == sorter].sort_values('data_size')
+            plt.plot(subset['data_size'], subset[column], marker='o', linestyle='-', label=sorter.replace('Memory', ''))
+        plt.title(f'{ylabel} by Input Size', fontsize=16)
+        plt.xlabel('Input Size (N)', fontsize=14)
+        plt.ylabel(ylabel, fontsize=14)
+        plt.xscale('log', base=2)
+        plt.yscale('symlog') # Most sorters allocate nothing
+        plt.gca().xaxis.set_major_formatter(ticker.FuncFormatter(lambda x, _: f'{int(x)}'))
+        plt.legend(fontsize=10)
+        plt.grid(True, which="both", ls="-", alpha=0.7)
+        plt.tight_layout()
+        plot_path = os.path.join(FIGURES_DIR, filename)
+        plt.savefig(plot_path)
+        plt.close()
+        print(f"Saved memory plot to {plot_path}")
+
+def main():
+    df = load_benchmark_csv(CSV_FILE_PATH)
+    if df is None:
+        return
 
     if df.empty:
         print("No valid benchmark data found after parsing and filtering. Cannot generate plots.")
         return
 
-    plot_performance(df)
+    # The sorter comparisons take one series per benchmark (per thread count for the
+    # threaded sorters); benchmarks with more arguments get a figure each
+    sorters_df = df[df['variant'].isna()]
+    plot_performance(sorters_df)
 
     # Add calls to the new plotting function for specific sizes
-    plot_fixed_size_comparison(df, 64)
-    plot_fixed_size_comparison(df, 65536)
+    plot_fixed_size_comparison(sorters_df, 64)
+    plot_fixed_size_comparison(sorters_df, 65536)
+
+    plot_benchmark_variants(df[df['variant'].notna()])
+
+    if os.path.exists(MEMORY_CSV_FILE_PATH):
+        memory_df = load_benchmark_csv(MEMORY_CSV_FILE_PATH)
+        if memory_df is not None and not memory_df.empty:
+            plot_memory(memory_df)
 
 if __name__ == '__main__':
     main()